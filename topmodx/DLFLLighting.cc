@@ -90,6 +90,18 @@ void computeLighting( DLFLFacePtr fp, LightPtr lightptr, bool usegpu ) {
   }
 }
 
+static void computePatchLighting(TMPatchObjectPtr po, LightPtr lightptr) {
+  if( po ) {
+    TMPatchFacePtrList patch_list = po->list( );
+    TMPatchFacePtrList::iterator pfirst = patch_list.begin(), plast = patch_list.end();
+    TMPatchFacePtr pfp = NULL;
+    while ( pfirst != plast ) {
+      pfp = (*pfirst); ++pfirst;
+      pfp->computeLighting(lightptr);
+    }
+  }
+}
+
 void computeLighting(DLFLObjectPtr obj, TMPatchObjectPtr po, LightPtr lightptr, bool usegpu) {
 		// std::cout<< "usegpu = " << usegpu << "\n";
 	// int patchsize = (po)?po->list().size():0;
@@ -110,19 +122,18 @@ void computeLighting(DLFLObjectPtr obj, TMPatchObjectPtr po, LightPtr lightptr,
     computeLighting(faceptr,lightptr, usegpu);
     ++first;
   }
-  if( po ) {
-    TMPatchFacePtrList patch_list = po->list( );
-    TMPatchFacePtrList::iterator pfirst = patch_list.begin(), plast = patch_list.end();
-    TMPatchFacePtr pfp = NULL;
-    while ( pfirst != plast ) {
-			// progress->setValue(progressvalue++);
-			// QApplication::processEvents();
-	
-      pfp = (*pfirst); ++pfirst;
-      pfp->computeLighting(lightptr);
-    }
-  }
+  computePatchLighting(po,lightptr);
 	// progress->setValue(obj->num_faces() + patchsize);
 }
 
-
+void computeLighting(const DLFLFacePtrArray& faces, TMPatchObjectPtr po, LightPtr lightptr, bool usegpu) {
+  DLFLFacePtrArray::const_iterator first, last = faces.end();
+  for ( first = faces.begin(); first != last; ++first )
+    computeLighting(*first,lightptr,usegpu);
+  // Only the patches changed by the last patch update are lit again
+  if ( po ) {
+    const TMPatchFacePtrArray& patches = po->updatedList();
+    for (uint i=0; i < patches.size(); ++i)
+      patches[i]->computeLighting(lightptr);
+  }
+}
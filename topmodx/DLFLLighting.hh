@@ -45,6 +45,8 @@ using namespace Cg;
 
 void computeLighting( DLFLFacePtr fp, LightPtr lightptr, bool usegpu = false);
 void computeLighting( DLFLObjectPtr obj, TMPatchObjectPtr po, LightPtr lightptr, bool usegpu = false );
+// Lighting of only the given faces, e.g. the region changed by an operation
+void computeLighting( const DLFLFacePtrArray& faces, TMPatchObjectPtr po, LightPtr lightptr, bool usegpu = false );
 
 #endif /* #ifndef _DLFL_LIGHTING_HH_ */
 
@@ -0,0 +1,526 @@
+/*
+*
+* ***** BEGIN GPL LICENSE BLOCK *****
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software  Foundation,
+* Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*
+* The Original Code is Copyright (C) 2005 by xxxxxxxxxxxxxx
+* All rights reserved.
+*
+* The Original Code is: all of this file.
+*
+* Contributor(s): none yet.
+*
+* ***** END GPL LICENSE BLOCK *****
+*
+* Short description of this file
+*
+* name of .hh file containing function prototypes
+*
+*/
+
+#include <algorithm>
+#include <float.h>
+
+#include "DLFLPicker.hh"
+
+/*!
+\ingroup gui
+@{
+
+	\class DLFLPicker
+		\brief selection of vertices, edges and faces without OpenGL
+
+		\note The pick region is the part of the view volume which gluPickMatrix
+		would keep. Elements are clipped against it the way GL_SELECT clips them,
+		so hits and depths match the old selection code. Bounding volume
+		hierarchies over the elements keep the cost of a pick low.
+
+		\see GLWidget
+*/
+
+// Most elements in a leaf of the hierarchy
+static const uint LeafSize = 4;
+
+// Compare the centers of two elements along one axis, for splitting the leaves
+struct CenterLess {
+	const double *centers;
+	int axis;
+	CenterLess( const double *c, int a ) : centers(c), axis(a) { }
+	bool operator ()( uint a, uint b ) const {
+		return centers[3*a+axis] < centers[3*b+axis];
+	}
+};
+
+static inline double dot4( const double *a, const double *b ) {
+	return a[0]*b[0] + a[1]*b[1] + a[2]*b[2] + a[3]*b[3];
+}
+
+static inline double windowDepth( const double *clip ) {
+	return 0.5*(clip[2]/clip[3] + 1.0);
+}
+
+// Copy the element pointers of a list. Returns true if they were already there
+template <class T>
+static bool sync( const list<T>& elements, vector<T>& array ) {
+	bool same = ( elements.size() == array.size() );
+	typename list<T>::const_iterator it = elements.begin();
+	for( size_t i = 0; same && it != elements.end(); ++it, ++i )
+		same = ( array[i] == *it );
+	if( !same ) array.assign( elements.begin(), elements.end() );
+	return same;
+}
+
+static void growBox( double *box, const Vector3d& p ) {
+	for( int i = 0; i < 3; i++ ) {
+		if( p[i] < box[i] ) box[i] = p[i];
+		if( p[i] > box[i+3] ) box[i+3] = p[i];
+	}
+}
+
+static void emptyBox( double *box ) {
+	box[0] = box[1] = box[2] = DBL_MAX;
+	box[3] = box[4] = box[5] = -DBL_MAX;
+}
+
+void DLFLPicker::Tree::build( ) {
+	uint n = boxes.size() / 6;
+	order.resize( n );
+	for( uint i = 0; i < n; i++ ) order[i] = i;
+	nodes.clear( );
+	if( n == 0 ) return;
+
+	vector<double> centers( 3*n );
+	for( uint i = 0; i < n; i++ ) {
+		const double *box = &boxes[6*i];
+		for( int j = 0; j < 3; j++ )
+			centers[3*i+j] = ( box[j] <= box[j+3] ) ? 0.5*(box[j] + box[j+3]) : 0.0;
+	}
+	nodes.reserve( 2*(n/LeafSize + 1) );
+	split( 0, n, centers );
+	refit( );
+}
+
+// Make a node for the elements order[start..start+count), split at the median
+// center along the longest axis. Returns the index of the node
+uint DLFLPicker::Tree::split( uint start, uint count, vector<double>& centers ) {
+	uint index = nodes.size();
+	nodes.push_back( Node() );
+	nodes[index].start = start; nodes[index].count = count; nodes[index].right = 0;
+	if( count <= LeafSize ) return index;
+
+	double lo[3] = { DBL_MAX, DBL_MAX, DBL_MAX }, hi[3] = { -DBL_MAX, -DBL_MAX, -DBL_MAX };
+	for( uint i = start; i < start + count; i++ ) {
+		const double *c = &centers[3*order[i]];
+		for( int j = 0; j < 3; j++ ) {
+			if( c[j] < lo[j] ) lo[j] = c[j];
+			if( c[j] > hi[j] ) hi[j] = c[j];
+		}
+	}
+	int axis = 0;
+	for( int j = 1; j < 3; j++ )
+		if( hi[j] - lo[j] > hi[axis] - lo[axis] ) axis = j;
+	if( hi[axis] <= lo[axis] ) return index; // All in the same place
+
+	uint half = count / 2;
+	std::nth_element( order.begin() + start, order.begin() + start + half, order.begin() + start + count,
+										CenterLess( &centers[0], axis ) );
+	nodes[index].count = 0;
+	split( start, half, centers );
+	uint right = split( start + half, count - half, centers );
+	nodes[index].right = right;
+	return index;
+}
+
+void DLFLPicker::Tree::refit( ) {
+	for( uint i = nodes.size(); i-- > 0; ) {
+		Node& node = nodes[i];
+		for( int j = 0; j < 3; j++ ) { node.lo[j] = DBL_MAX; node.hi[j] = -DBL_MAX; }
+		if( node.count ) {
+			for( uint k = node.start; k < node.start + node.count; k++ ) {
+				const double *box = &boxes[6*order[k]];
+				for( int j = 0; j < 3; j++ ) {
+					if( box[j] < node.lo[j] ) node.lo[j] = box[j];
+					if( box[j+3] > node.hi[j] ) node.hi[j] = box[j+3];
+				}
+			}
+		} else {
+			const Node& left = nodes[i+1];
+			const Node& right = nodes[node.right];
+			for( int j = 0; j < 3; j++ ) {
+				node.lo[j] = std::min( left.lo[j], right.lo[j] );
+				node.hi[j] = std::max( left.hi[j], right.hi[j] );
+			}
+		}
+	}
+}
+
+// Elements whose boxes are not completely outside one of the planes
+void DLFLPicker::Tree::query( const double *planes, vector<uint>& hits ) const {
+	hits.clear( );
+	if( nodes.empty() ) return;
+	vector<uint> stack;
+	stack.push_back( 0 );
+	while( !stack.empty() ) {
+		uint i = stack.back( ); stack.pop_back( );
+		const Node& node = nodes[i];
+		bool outside = false;
+		for( int k = 0; k < 6 && !outside; k++ ) {
+			const double *p = planes + 4*k;
+			// Corner of the box furthest along the plane normal
+			double d = p[3];
+			for( int j = 0; j < 3; j++ )
+				d += p[j] * ( p[j] >= 0.0 ? node.hi[j] : node.lo[j] );
+			outside = ( d < 0.0 );
+		}
+		if( outside ) continue;
+		if( node.count ) {
+			for( uint k = node.start; k < node.start + node.count; k++ )
+				hits.push_back( order[k] );
+		} else {
+			stack.push_back( node.right );
+			stack.push_back( i+1 );
+		}
+	}
+}
+
+DLFLPicker::DLFLPicker( ) {
+	invalidate( );
+	for( int i = 0; i < 16; i++ ) mMatrix[i] = ( i % 5 == 0 ) ? 1.0 : 0.0;
+	for( int k = 0; k < 6; k++ )
+		for( int j = 0; j < 4; j++ ) mClip[k][j] = mPlanes[k][j] = 0.0;
+}
+
+void DLFLPicker::setRegion( const double *mvp, const int *vp, double x, double y, double w, double h ) {
+	for( int i = 0; i < 16; i++ ) mMatrix[i] = mvp[i];
+
+	// Normalized device coordinates of the region
+	double x0 = 2.0*(x - 0.5*w - vp[0])/vp[2] - 1.0, x1 = 2.0*(x + 0.5*w - vp[0])/vp[2] - 1.0;
+	double y0 = 2.0*(y - 0.5*h - vp[1])/vp[3] - 1.0, y1 = 2.0*(y + 0.5*h - vp[1])/vp[3] - 1.0;
+	double clip[6][4] = { {  1.0,  0.0,  0.0, -x0 }, { -1.0,  0.0,  0.0, x1 },
+												{  0.0,  1.0,  0.0, -y0 }, {  0.0, -1.0,  0.0, y1 },
+												{  0.0,  0.0,  1.0, 1.0 }, {  0.0,  0.0, -1.0, 1.0 } };
+	for( int k = 0; k < 6; k++ ) {
+		for( int j = 0; j < 4; j++ ) {
+			mClip[k][j] = clip[k][j];
+			// The clip plane taken back through the matrix
+			mPlanes[k][j] = 0.0;
+			for( int r = 0; r < 4; r++ )
+				mPlanes[k][j] += clip[k][r] * mvp[4*j+r];
+		}
+	}
+}
+
+void DLFLPicker::update( DLFLObjectPtr obj, int tree ) {
+	bool same = true;
+	switch( tree ) {
+	case Vertices : same = sync( obj->getVertexList(), mVertices ); break;
+	case Edges : same = sync( obj->getEdgeList(), mEdges ); break;
+	case Faces : same = sync( obj->getFaceList(), mFaces ); break;
+	}
+	if( !same ) {
+		updateBoxes( tree );
+		mTrees[tree].build( );
+	} else if( mDirty[tree] ) {
+		updateBoxes( tree );
+		mTrees[tree].refit( );
+	}
+	mDirty[tree] = false;
+}
+
+void DLFLPicker::updateBoxes( int tree ) {
+	vector<double>& boxes = mTrees[tree].boxes;
+	switch( tree ) {
+	case Vertices :
+		boxes.resize( 6*mVertices.size() );
+		for( uint i = 0; i < mVertices.size(); i++ ) {
+			emptyBox( &boxes[6*i] );
+			growBox( &boxes[6*i], mVertices[i]->coords );
+		}
+		break;
+	case Edges :
+		boxes.resize( 6*mEdges.size() );
+		for( uint i = 0; i < mEdges.size(); i++ ) {
+			DLFLFaceVertexPtr fvp1, fvp2;
+			mEdges[i]->getFaceVertexPointers( fvp1, fvp2 );
+			emptyBox( &boxes[6*i] );
+			growBox( &boxes[6*i], fvp1->vertex->coords );
+			growBox( &boxes[6*i], fvp2->vertex->coords );
+		}
+		break;
+	case Faces :
+		boxes.resize( 6*mFaces.size() );
+		for( uint i = 0; i < mFaces.size(); i++ ) {
+			emptyBox( &boxes[6*i] );
+			DLFLFaceVertexPtr head = mFaces[i]->front(), curr = head;
+			if( !head ) continue;
+			do {
+				if( curr->vertex ) growBox( &boxes[6*i], curr->vertex->coords );
+				curr = curr->next();
+			} while( curr != head );
+		}
+		break;
+	}
+}
+
+void DLFLPicker::transform( const Vector3d& p, double *clip ) const {
+	for( int r = 0; r < 4; r++ )
+		clip[r] = mMatrix[r]*p[0] + mMatrix[4+r]*p[1] + mMatrix[8+r]*p[2] + mMatrix[12+r];
+}
+
+bool DLFLPicker::insidePoint( const double *clip, double *depth ) const {
+	for( int k = 0; k < 6; k++ )
+		if( dot4( mClip[k], clip ) < 0.0 ) return false;
+	*depth = windowDepth( clip );
+	return true;
+}
+
+bool DLFLPicker::insideSegment( const double *a, const double *b, double *depth ) const {
+	double t0 = 0.0, t1 = 1.0;
+	for( int k = 0; k < 6; k++ ) {
+		double da = dot4( mClip[k], a ), db = dot4( mClip[k], b );
+		if( da < 0.0 && db < 0.0 ) return false;
+		if( da < 0.0 ) t0 = std::max( t0, da/(da-db) );
+		else if( db < 0.0 ) t1 = std::min( t1, da/(da-db) );
+	}
+	if( t0 > t1 ) return false;
+	double p0[4], p1[4];
+	for( int j = 0; j < 4; j++ ) {
+		p0[j] = a[j] + t0*(b[j] - a[j]);
+		p1[j] = a[j] + t1*(b[j] - a[j]);
+	}
+	*depth = std::min( windowDepth( p0 ), windowDepth( p1 ) );
+	return true;
+}
+
+// Test the polygon in mPolygon, which is changed. Open polygons are only
+// their boundary, closed ones with 3 or more corners are filled
+bool DLFLPicker::insidePolygon( int n, bool closed, int cull, double *depth ) {
+	if( n == 1 ) return insidePoint( &mPolygon[0], depth );
+	if( n == 2 || !closed ) {
+		bool hit = false;
+		double d;
+		int segments = ( n == 2 ) ? 1 : n;
+		for( int i = 0; i < segments; i++ ) {
+			if( insideSegment( &mPolygon[4*i], &mPolygon[4*((i+1)%n)], &d ) ) {
+				if( !hit || d < *depth ) *depth = d;
+				hit = true;
+			}
+		}
+		return hit;
+	}
+
+	// Sutherland-Hodgman clipping against each plane of the region
+	for( int k = 0; k < 6; k++ ) {
+		uint m = mPolygon.size() / 4;
+		if( m == 0 ) return false;
+		mClipped.clear( );
+		for( uint i = 0; i < m; i++ ) {
+			const double *a = &mPolygon[4*i], *b = &mPolygon[4*((i+1)%m)];
+			double da = dot4( mClip[k], a ), db = dot4( mClip[k], b );
+			if( da >= 0.0 ) mClipped.insert( mClipped.end(), a, a+4 );
+			if( (da >= 0.0) != (db >= 0.0) ) {
+				double t = da/(da-db);
+				for( int j = 0; j < 4; j++ ) mClipped.push_back( a[j] + t*(b[j] - a[j]) );
+			}
+		}
+		mPolygon.swap( mClipped );
+	}
+	uint m = mPolygon.size() / 4;
+	if( m == 0 ) return false;
+
+	if( cull ) {
+		// Counter clockwise in the window is front facing
+		double area = 0.0;
+		for( uint i = 0; i < m; i++ ) {
+			const double *a = &mPolygon[4*i], *b = &mPolygon[4*((i+1)%m)];
+			area += (a[0]/a[3])*(b[1]/b[3]) - (b[0]/b[3])*(a[1]/a[3]);
+		}
+		if( area*cull < 0.0 ) return false;
+	}
+
+	*depth = windowDepth( &mPolygon[0] );
+	for( uint i = 1; i < m; i++ )
+		*depth = std::min( *depth, windowDepth( &mPolygon[4*i] ) );
+	return true;
+}
+
+void DLFLPicker::pick( int tree, bool outline, int cull, vector<Hit>& hits ) {
+	vector<uint> candidates;
+	mTrees[tree].query( &mPlanes[0][0], candidates );
+	hits.clear( );
+	for( uint c = 0; c < candidates.size(); c++ ) {
+		Hit hit;
+		hit.index = candidates[c];
+		bool inside = false;
+		switch( tree ) {
+		case Vertices : {
+			double clip[4];
+			transform( mVertices[hit.index]->coords, clip );
+			inside = insidePoint( clip, &hit.depth );
+			break;
+		}
+		case Edges : {
+			DLFLFaceVertexPtr fvp1, fvp2;
+			double a[4], b[4];
+			mEdges[hit.index]->getFaceVertexPointers( fvp1, fvp2 );
+			transform( fvp1->vertex->coords, a );
+			transform( fvp2->vertex->coords, b );
+			inside = insideSegment( a, b, &hit.depth );
+			break;
+		}
+		case Faces : {
+			DLFLFaceVertexPtr head = mFaces[hit.index]->front(), curr = head;
+			mPolygon.clear( );
+			if( head ) {
+				do {
+					if( curr->vertex ) {
+						double clip[4];
+						transform( curr->vertex->coords, clip );
+						mPolygon.insert( mPolygon.end(), clip, clip+4 );
+					}
+					curr = curr->next();
+				} while( curr != head );
+			}
+			int n = mPolygon.size() / 4;
+			if( n == 0 ) break;
+			inside = insidePolygon( n, !outline, cull, &hit.depth );
+			// Point faces are drawn slightly in front for selection
+			if( n == 1 ) hit.depth *= 1.0 - 0.005;
+			break;
+		}
+		}
+		if( inside ) hits.push_back( hit );
+	}
+}
+
+// Position of the hit with the least depth, -1 if there are none. Ties go to the
+// element found last in the object's list, as with the GL_SELECT hit records
+int DLFLPicker::closest( const vector<Hit>& hits ) {
+	int best = -1;
+	for( uint i = 0; i < hits.size(); i++ ) {
+		if( best < 0 || hits[i].depth < hits[best].depth ||
+				( hits[i].depth == hits[best].depth && hits[i].index > hits[best].index ) )
+			best = i;
+	}
+	return best;
+}
+
+struct LaterHit {
+	template <class Hit>
+	bool operator ()( const Hit& a, const Hit& b ) const { return a.index > b.index; }
+};
+
+// Order of the GL_SELECT hit records as they were read back, last element first
+void DLFLPicker::sortHits( vector<Hit>& hits ) {
+	std::sort( hits.begin(), hits.end(), LaterHit() );
+}
+
+DLFLVertexPtr DLFLPicker::pickVertex( DLFLObjectPtr obj ) {
+	if( !obj ) return NULL;
+	update( obj, Vertices );
+	vector<Hit> hits;
+	pick( Vertices, false, 0, hits );
+	int i = closest( hits );
+	return ( i < 0 ) ? NULL : mVertices[hits[i].index];
+}
+
+DLFLEdgePtr DLFLPicker::pickEdge( DLFLObjectPtr obj ) {
+	if( !obj ) return NULL;
+	update( obj, Edges );
+	vector<Hit> hits;
+	pick( Edges, false, 0, hits );
+	int i = closest( hits );
+	return ( i < 0 ) ? NULL : mEdges[hits[i].index];
+}
+
+DLFLFacePtr DLFLPicker::pickFace( DLFLObjectPtr obj, bool outline, int cull ) {
+	if( !obj ) return NULL;
+	update( obj, Faces );
+	vector<Hit> hits;
+	pick( Faces, outline, cull, hits );
+	int i = closest( hits );
+	return ( i < 0 ) ? NULL : mFaces[hits[i].index];
+}
+
+DLFLFaceVertexPtr DLFLPicker::pickFaceVertex( DLFLFacePtr fp ) {
+	DLFLFaceVertexPtrArray corners;
+	vector<Hit> hits;
+	DLFLFaceVertexPtr head = fp ? fp->front() : NULL, curr = head;
+	if( !head ) return NULL;
+	do {
+		Hit hit;
+		double clip[4];
+		hit.index = corners.size();
+		corners.push_back( curr );
+		if( curr->vertex ) {
+			transform( curr->vertex->coords, clip );
+			if( insidePoint( clip, &hit.depth ) ) hits.push_back( hit );
+		}
+		curr = curr->next();
+	} while( curr != head );
+	int i = closest( hits );
+	return ( i < 0 ) ? NULL : corners[hits[i].index];
+}
+
+DLFLVertexPtrArray DLFLPicker::pickVertices( DLFLObjectPtr obj ) {
+	DLFLVertexPtrArray vparray;
+	if( !obj ) return vparray;
+	update( obj, Vertices );
+	vector<Hit> hits;
+	pick( Vertices, false, 0, hits );
+	sortHits( hits );
+	vparray.reserve( hits.size() );
+	for( uint i = 0; i < hits.size(); i++ ) vparray.push_back( mVertices[hits[i].index] );
+	return vparray;
+}
+
+DLFLEdgePtrArray DLFLPicker::pickEdges( DLFLObjectPtr obj ) {
+	DLFLEdgePtrArray eparray;
+	if( !obj ) return eparray;
+	update( obj, Edges );
+	vector<Hit> hits;
+	pick( Edges, false, 0, hits );
+	sortHits( hits );
+	eparray.reserve( hits.size() );
+	for( uint i = 0; i < hits.size(); i++ ) eparray.push_back( mEdges[hits[i].index] );
+	return eparray;
+}
+
+DLFLFacePtrArray DLFLPicker::pickFaces( DLFLObjectPtr obj, bool outline ) {
+	DLFLFacePtrArray fparray;
+	if( !obj ) return fparray;
+	update( obj, Faces );
+	vector<Hit> hits;
+	pick( Faces, outline, 0, hits );
+	sortHits( hits );
+	fparray.reserve( hits.size() );
+	for( uint i = 0; i < hits.size(); i++ ) fparray.push_back( mFaces[hits[i].index] );
+	return fparray;
+}
+
+// Singleton Stuff
+DLFLPicker* DLFLPicker::mInstance = 0;
+
+DLFLPicker* DLFLPicker::instance( ) {
+	// ensures only 1 instance (singleton)
+	if ( !mInstance )
+		mInstance = new DLFLPicker;
+	return mInstance;
+}
+
+/*!
+@}
+*/
@@ -0,0 +1,127 @@
+/*
+*
+* ***** BEGIN GPL LICENSE BLOCK *****
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software  Foundation,
+* Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*
+* The Original Code is Copyright (C) 2005 by xxxxxxxxxxxxxx
+* All rights reserved.
+*
+* The Original Code is: all of this file.
+*
+* Contributor(s): none yet.
+*
+* ***** END GPL LICENSE BLOCK *****
+*/
+
+#ifndef _DLFL_PICKER_H_
+#define _DLFL_PICKER_H_
+
+#include <DLFLObject.hh>
+
+using namespace DLFL;
+
+/*!
+	\file DLFLPicker.hh
+	\brief Definition of the DLFLPicker class
+
+	\see DLFLPicker
+*/
+
+class DLFLPicker {
+public :
+  /** Singleton Methods **/
+  static DLFLPicker* instance( );
+  ~DLFLPicker( ) { };
+
+  // Mark the coordinates as changed. Before the next pick the bounding volumes are
+  // refitted to them. Added or removed elements are found without this and cause
+  // a rebuild of the hierarchy
+  void invalidate( ) { mDirty[Vertices] = mDirty[Edges] = mDirty[Faces] = true; };
+
+  // Set the pick region. mvp is the column major projection * modelview matrix,
+  // vp the viewport and (x,y,w,h) the region in window coordinates, centered
+  // at (x,y) as for gluPickMatrix
+  void setRegion( const double *mvp, const int *vp, double x, double y, double w, double h );
+
+  // Closest element in the region, NULL if there is none. Depth is compared the
+  // same way as the hit records of GL_SELECT
+  DLFLVertexPtr pickVertex( DLFLObjectPtr obj );
+  DLFLEdgePtr pickEdge( DLFLObjectPtr obj );
+  // outline : faces are only their boundary, as drawn by the patch renderer
+  // cull : 1 drops back faces, -1 drops front faces
+  DLFLFacePtr pickFace( DLFLObjectPtr obj, bool outline = false, int cull = 0 );
+  DLFLFaceVertexPtr pickFaceVertex( DLFLFacePtr fp );
+
+  // All elements in the region, whether visible or not
+  DLFLVertexPtrArray pickVertices( DLFLObjectPtr obj );
+  DLFLEdgePtrArray pickEdges( DLFLObjectPtr obj );
+  DLFLFacePtrArray pickFaces( DLFLObjectPtr obj, bool outline = false );
+
+private :
+  DLFLPicker( );
+
+  // Bounding volume hierarchy over one kind of element. Nodes are stored with
+  // children after their parent, so a reverse sweep refits the whole tree
+  struct Node {
+    double lo[3], hi[3];
+    uint start, count;                 // Range in the order array for leaves
+    uint right;                        // Second child for inner nodes (count == 0)
+  };
+
+  struct Tree {
+    vector<Node> nodes;
+    vector<uint> order;                // Element indices sorted into the leaves
+    vector<double> boxes;              // 6 doubles per element : lo, hi
+    void build( );
+    void refit( );
+    void query( const double *planes, vector<uint>& hits ) const;
+  private :
+    uint split( uint start, uint count, vector<double>& centers );
+  };
+
+  // Hit of the region with an element, depth as window z in [0,1]
+  struct Hit {
+    uint index;
+    double depth;
+  };
+
+  enum { Vertices=0, Edges, Faces, NumTrees };
+
+  void update( DLFLObjectPtr obj, int tree );
+  void updateBoxes( int tree );
+  void transform( const Vector3d& p, double *clip ) const;
+  bool insidePoint( const double *clip, double *depth ) const;
+  bool insideSegment( const double *a, const double *b, double *depth ) const;
+  bool insidePolygon( int n, bool closed, int cull, double *depth );
+  void pick( int tree, bool outline, int cull, vector<Hit>& hits );
+  static int closest( const vector<Hit>& hits );
+  static void sortHits( vector<Hit>& hits );
+
+  static DLFLPicker* mInstance;
+
+  bool mDirty[NumTrees];               // Coordinates may have changed
+  Tree mTrees[NumTrees];
+  DLFLVertexPtrArray mVertices;        // Elements in list order
+  DLFLEdgePtrArray mEdges;
+  DLFLFacePtrArray mFaces;
+
+  double mMatrix[16];                  // Projection * modelview of the region
+  double mClip[6][4];                  // Region planes in clip coordinates
+  double mPlanes[6][4];                // Region planes in object coordinates
+  vector<double> mPolygon, mClipped;   // Clip coordinates of the face being tested
+};
+
+#endif // _DLFL_PICKER_H_
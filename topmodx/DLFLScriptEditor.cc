@@ -3,13 +3,14 @@
 #include "DLFLScriptEditor.hh"
 
 #include <QtGui>
+#include <frameobject.h>
 
 #ifdef Q_WS_MAC
 #include <CoreFoundation/CFBundle.h>
 #endif // Q_WS_MAC
 
 DLFLScriptEditor::DLFLScriptEditor( DLFLObjectPtr obj, QWidget *parent, Qt::WindowFlags f ) 
-	: QWidget(parent), dlfl_module(NULL),dlfl_dict(NULL),mEchoing(true),pathPython(""),mTabWidth(3),addToPath(".") {
+	: QWidget(parent), dlfl_module(NULL),dlfl_dict(NULL),mMainThreadState(NULL),mRefreshRate(10),mEchoing(true),pathPython(""),mTabWidth(3),addToPath(".") {
 
 	setMinimumSize( 350, 200 );
 
@@ -90,6 +91,13 @@ DLFLScriptEditor::DLFLScriptEditor( DLFLObjectPtr obj, QWidget *parent, Qt::Wind
 	connect(mToggleEchoing, SIGNAL(triggered()), this, SLOT(toggleEchoing()));
 	mScriptMenu->addAction(mToggleEchoing);
 
+	mSetRefreshRate = new QAction(QIcon(":images/applications-system.png"),tr("Set &Refresh Rate"), this);
+	mSetRefreshRate->setStatusTip(tr("How often the viewport is redrawn while a script runs"));
+	connect(mSetRefreshRate, SIGNAL(triggered()), this, SLOT(toggleRefreshRateWidget()));
+	mSetRefreshRate->setCheckable(true);
+	mSetRefreshRate->setChecked(false);
+	mScriptMenu->addAction(mSetRefreshRate);
+
 	mFormatMenu = mMenuBar->addMenu(tr("&Format"));
 
 	mConvertSpaces = new QAction(QIcon(":images/applications-system.png"),tr("&Convert Spaces To Tabs"), this);
@@ -113,12 +121,41 @@ DLFLScriptEditor::DLFLScriptEditor( DLFLObjectPtr obj, QWidget *parent, Qt::Wind
 	mSetTabWidthWidget->hide();
 	connect( mSetTabWidthWidget, SIGNAL(valueChanged(int)), this, SLOT(setTabWidth(int)) );
 
+	mSetRefreshRateWidget = new QSpinBox( this );
+	mSetRefreshRateWidget->setRange(0, 60);
+	mSetRefreshRateWidget->setValue( mRefreshRate );
+	mSetRefreshRateWidget->setPrefix( "Refresh Viewport: ");
+	mSetRefreshRateWidget->setSuffix( " time(s) per second");
+	mSetRefreshRateWidget->setSpecialValueText( "Refresh Viewport: when the script is done");
+	mSetRefreshRateWidget->hide();
+	connect( mSetRefreshRateWidget, SIGNAL(valueChanged(int)), this, SLOT(setRefreshRate(int)) );
+
+	mStopButton = new QPushButton(tr("Stop Script"), this);
+	mStopButton->setStatusTip(tr("Interrupt the running script"));
+	mStopButton->setEnabled(false);
+	connect( mStopButton, SIGNAL(clicked()), this, SLOT(stopScript()) );
+
+	// Scripts run on their own thread
+	mScriptThread = new DLFLScriptThread( this );
+	connect( mScriptThread, SIGNAL(commandStarted(QString)), this, SLOT(printCommand(QString)) );
+	connect( mScriptThread, SIGNAL(output(QString)), this, SLOT(printOutput(QString)) );
+	connect( mScriptThread, SIGNAL(error(QString)), this, SLOT(printError(QString)) );
+	connect( mScriptThread, SIGNAL(finished()), this, SLOT(threadFinished()) );
+	// The script waits for these to be done before it goes on
+	connect( mScriptThread, SIGNAL(safePoint()), this, SLOT(refreshView()), Qt::BlockingQueuedConnection );
+	connect( mScriptThread, SIGNAL(requestObject(QString)), this, SIGNAL(requestObject(QString)), Qt::BlockingQueuedConnection );
+
+	mRefreshTimer = new QTimer( this );
+	connect( mRefreshTimer, SIGNAL(timeout()), mScriptThread, SLOT(requestRefresh()) );
+
 	// Layout
   QVBoxLayout *mainLayout = new QVBoxLayout(this);
 	mainLayout->setMenuBar(mMenuBar);
   mainLayout->addWidget(mHistoryBox);
   mainLayout->addWidget(mCommandEdit);
 	mainLayout->addWidget(mSetTabWidthWidget);
+	mainLayout->addWidget(mSetRefreshRateWidget);
+	mainLayout->addWidget(mStopButton);
   setLayout(mainLayout);
 
 #ifdef Q_WS_MAC
@@ -139,11 +176,26 @@ DLFLScriptEditor::DLFLScriptEditor( DLFLObjectPtr obj, QWidget *parent, Qt::Wind
 }
 
 DLFLScriptEditor::~DLFLScriptEditor( ) {
+	if( mScriptThread->isRunning() ) {
+		// The window is going away, don't let the script use it
+		disconnect( this, SIGNAL(viewChanged()), 0, 0 );
+		disconnect( this, SIGNAL(requestObject(QString)), 0, 0 );
+		mScriptThread->interrupt();
+		// The script may be waiting for a refresh or load to be handled here
+		while( !mScriptThread->wait(50) )
+			QCoreApplication::processEvents(QEventLoop::ExcludeUserInputEvents);
+	}
+	if( mMainThreadState )
+		PyEval_RestoreThread( mMainThreadState );
   if( Py_IsInitialized() )
     Py_Finalize( );
 }
 
 void DLFLScriptEditor::executeCommand( ) {
+	// one script at a time
+	if( isRunning() )
+		return;
+
 	// grab the command typed
   QString command = mCommandEdit->toPlainText();
 
@@ -154,136 +206,149 @@ void DLFLScriptEditor::executeCommand( ) {
   
 	// split up entered code by line
   QStringList cmdList = command.split('\n',QString::SkipEmptyParts);
-  QStringList resultList;
-
-  QString result;
 
-  mHistoryBox->moveCursor( QTextCursor::End );
+  if( command.isEmpty() || !Py_IsInitialized() )
+		return;
 
-  if( !command.isEmpty() ) {
-    emit makingChange(); // for undo push
-
-    if( Py_IsInitialized() ) {
-			// Have to regrab these things every time
-			// to get updated dictionary from last exec
-
-			// Grab dlfl dictionary
-			dlfl_module = PyImport_AddModule("dlfl");
-			dlfl_dict = PyModule_GetDict( dlfl_module );
-			// Grab __main__ dictionary
-			main_module = PyImport_AddModule("__main__");
-			main_dict = PyModule_GetDict( main_module );
-
-			// Into main_dict: from dlfl import *
-			PyDict_Update(main_dict, dlfl_dict);
-
-			// Run this to redirect python stdout
-      PyRun_SimpleString( "import sys, __main__" );
-      PyRun_SimpleString( "__main__.mio = MyIO()" );
-      PyRun_SimpleString( "sys.stdout = __main__.mio" );
-			// Loop through each line of code looking for block statements
-      for(int i = 0; i < cmdList.size(); i++ ) {
-				QString si = cmdList.at(i);
-				if( si.endsWith(":") ) { 
-					// then it is a block statement
-					int j = i+1;
-					while( j < cmdList.size() && (cmdList.at(j).startsWith("\t") || cmdList.at(j).startsWith(" ")) ) {
-						/*// If it begins with a space figure out if we're in the same indentation level
-						if( cmdList.at(j).startsWith(" ") ) {
-							QRegExp rx = QRegExp("(^[ ])([ ])*");
-							int pos = rx.indexIn( cmdList.at(j) );
-							QStringList list = rx.capturedTexts();
-							
-							}*/
-
-						// keep going until the tab indent level goes back out
-						QString sj = cmdList.at(j);
-						si += QString("\n")+sj;
-						cmdList.removeAt(j);
-					}
-					// update with new multiline command
-					cmdList.replace(i,si);
-				}
-				// Check if it is a load command (let TopMod handle this instead of Python)
-				if( cmdList.at(i).contains(QRegExp("\\bload\\("))) {
-					QStringList list = cmdList.at(i).split("\"", QString::SkipEmptyParts);
-					cmdList.removeAt(i);
-					emit requestObject(list.at(1)); // 3 parts: load(, filename.obj, and )
-					emit cmdExecuted(); // print out in history window
-					continue;
-				}
-
-				// Clear out stdout
-				PyRun_SimpleString( "__main__.mio.clear()" );
-
-				// ** Run The Command
-				const char *cmd = cmdList.at(i).toLocal8Bit().constData();
-				PyObject *rstring = PyRun_String( cmd, Py_file_input, main_dict, main_dict );
-				// Grab the result from redirected stdout class into a global variable
-				PyRun_SimpleString( "__main__.__result = __main__.mio.s" );
-
-				if( rstring != NULL ) {
-					// resultObject1 has any possible result from running the command
-					PyObject *resultObject1 = PyObject_Str( rstring );
-					// resultObject2 has any possible thing printed to stdout from running the command
-					PyObject *resultObject2 = PyDict_GetItemString( main_dict, "__result" );
-					if( resultObject1 != NULL && resultObject2 != NULL ) {
-						char *string1 = PyString_AsString( resultObject1 );
-						char *string2 = PyString_AsString( PyObject_Str(resultObject2) );
-						result = QString( string1 );
-						// Go for string1 first, if nothing then try string2
-						if( result.isEmpty() || result == "" || result == "None" )
-							result = QString( string2 );
-						Py_DECREF( resultObject1 );
-						Py_DECREF( resultObject2 );
-					}
-					Py_DECREF( rstring );
-					emit cmdExecuted();
-				} else {
-					// There was an error with the command
-					// Print the error message
-					PyObject *object, *data, *traceback;
-					PyErr_Fetch( &object, &data, &traceback );
-					PyObject * traceStr = PyObject_Str( data );
-					char *string = PyString_AsString( traceStr );
-					result = QString( string ) + QString("  "); // the spaces b/c I chop(2) later
-				}
-				resultList << result; // append result to resultList
-      } // for loop
-    } // end Py_IsInitialized
-    emit addToHistory(command);
-  } else { // enter when command.isEmpty() == true
-    command = QString("");
-    result = QString("");
-  }
+	// Loop through each line of code looking for block statements
+	for(int i = 0; i < cmdList.size(); i++ ) {
+		QString si = cmdList.at(i);
+		if( si.endsWith(":") ) { 
+			// then it is a block statement
+			int j = i+1;
+			while( j < cmdList.size() && (cmdList.at(j).startsWith("\t") || cmdList.at(j).startsWith(" ")) ) {
+				// keep going until the tab indent level goes back out
+				QString sj = cmdList.at(j);
+				si += QString("\n")+sj;
+				cmdList.removeAt(j);
+			}
+			// update with new multiline command
+			cmdList.replace(i,si);
+		}
+	}
+	emit addToHistory(command);
 
-	// Now create the output for the history window
-  for(int i = 0; i < cmdList.size(); i++ ) {
-		// print each command
-    mHistoryBox->insertPlainText( "\n" + cmdList.at(i) );
-    if( i < resultList.size() ) {
-			// followed by all the items in it's result list
-      QString res = resultList.at(i);
-      if( !res.isEmpty() && res != QString("None") ) { // don't print if None
-				res.replace(QRegExp("\\n"), "\n# "); // print as a comment at each line for copy/paste ease
-				res.chop(2);
-				mHistoryBox->insertPlainText( "\n# "+ res ); // # is a comment in python
-      }
-    }
-  }
-	mHistoryBox->insertPlainText("\n");
-	
 	// If the user highlighted to execute only a portion of the command
 	// then don't erase, otherwise do:
   if( !mCommandEdit->textCursor().hasSelection() ) {
 		clearInput( );
   }
 
+	runScript( cmdList );
+}
+
+void DLFLScriptEditor::runScript( const QStringList& commands ) {
+	emit makingChange(); // for undo push
+
+	mOutputLine = QString("");
+	mScriptThread->setCommands( commands );
+
+	// Nothing but the editor may be used until the script is done
+	qApp->installEventFilter( this );
+	mExecFile->setEnabled(false);
+	mStopButton->setEnabled(true);
+	emit scriptStarted();
+
+	if( mRefreshRate > 0 )
+		mRefreshTimer->start( 1000 / mRefreshRate );
+	mScriptThread->start();
+}
+
+void DLFLScriptEditor::stopScript( ) {
+	if( isRunning() )
+		mScriptThread->interrupt();
+}
+
+// Called on this thread while the script waits, so the object can be drawn
+void DLFLScriptEditor::refreshView( ) {
+	emit viewChanged();
+}
+
+void DLFLScriptEditor::threadFinished( ) {
+	mRefreshTimer->stop();
+	qApp->removeEventFilter( this );
+	mExecFile->setEnabled(true);
+	mStopButton->setEnabled(false);
+
+	flushOutput();
+	printHistory("\n");
+
+	emit scriptFinished();
+	emit cmdExecuted();
+}
+
+bool DLFLScriptEditor::isEditorObject( QObject *obj ) const {
+	for( ; obj != NULL; obj = obj->parent() ) {
+		if( obj == this || obj == parent() )
+			return true;
+	}
+	return false;
+}
+
+// Installed on the application while a script runs. Anything the user does
+// outside the editor could change the object under the script, so that input
+// is dropped. Painting, resizing etc. go on as usual
+bool DLFLScriptEditor::eventFilter( QObject *obj, QEvent *event ) {
+	switch( event->type() ) {
+	case QEvent::MouseButtonPress :
+	case QEvent::MouseButtonRelease :
+	case QEvent::MouseButtonDblClick :
+	case QEvent::MouseMove :
+	case QEvent::Wheel :
+	case QEvent::KeyPress :
+	case QEvent::KeyRelease :
+	case QEvent::Shortcut :
+	case QEvent::ShortcutOverride :
+	case QEvent::ContextMenu :
+	case QEvent::Drop :
+	case QEvent::TabletPress :
+	case QEvent::TabletMove :
+	case QEvent::TabletRelease :
+		if( !isEditorObject(obj) )
+			return true;
+		break;
+	default :
+		break;
+	}
+	return QWidget::eventFilter( obj, event );
+}
+
+void DLFLScriptEditor::printHistory( const QString& text ) {
+  mHistoryBox->moveCursor( QTextCursor::End );
+	mHistoryBox->insertPlainText( text );
 	// Make sure history window is scrolled all the way down to latest command
   QScrollBar *vBar = mHistoryBox->verticalScrollBar();
   vBar->triggerAction(QAbstractSlider::SliderToMaximum);
 }
 
+void DLFLScriptEditor::printCommand( QString cmd ) {
+	flushOutput();
+	printHistory( "\n" + cmd );
+}
+
+// What the script prints is shown as a comment after the command, for copy/paste ease
+void DLFLScriptEditor::printOutput( QString text ) {
+	mOutputLine += text;
+	int end;
+	while( (end = mOutputLine.indexOf('\n')) >= 0 ) {
+		printHistory( "\n# " + mOutputLine.left(end) );
+		mOutputLine.remove( 0, end+1 );
+	}
+}
+
+void DLFLScriptEditor::flushOutput( ) {
+	if( !mOutputLine.isEmpty() ) {
+		printHistory( "\n# " + mOutputLine );
+		mOutputLine = QString("");
+	}
+}
+
+void DLFLScriptEditor::printError( QString message ) {
+	flushOutput();
+	message.replace(QRegExp("\\n"), "\n# ");
+	printHistory( "\n# " + message );
+}
+
 void DLFLScriptEditor::echoCommand( QString cmd ) {
 	if( mEchoing ) {
 		mHistoryBox->insertPlainText( "\n" + cmd + "\n" );
@@ -297,11 +362,13 @@ void DLFLScriptEditor::PyInit( ) {
   Py_Initialize( );
 
   if( Py_IsInitialized() ) {
+		// Scripts run on another thread, see DLFLScriptThread
+		PyEval_InitThreads( );
     PyRun_SimpleString( "import sys, __main__" );
 		loadDLFLModule( addToPath );
 
 		// Create a class to redirect sys.stdout to
-    PyRun_SimpleString( "class MyIO:\n\tdef __init__(self): self.s=\"\"\n\tdef write(self,x): self.s+=x\n\tdef clear(self): self.s=\"\"" );
+    PyRun_SimpleString( "class MyIO:\n\tdef __init__(self,write): self.write=write\n\tdef flush(self): pass" );
 
     if( dlfl_module != NULL )
       dlfl_dict = PyModule_GetDict( dlfl_module );
@@ -327,6 +394,9 @@ void DLFLScriptEditor::PyInit( ) {
       mHistoryBox->insertPlainText("\n");
       PyErr_Print();
     }
+
+		// Let go of the interpreter, this thread takes it back when it needs it
+		mMainThreadState = PyEval_SaveThread( );
   }
 }
 
@@ -361,20 +431,18 @@ static bool syspath_append( const char *dirname ) {
 }
 
 void DLFLScriptEditor::loadDLFLModule( QString newPath ) {
-	if( !syspath_append( newPath.toLocal8Bit().constData() ) )
+	if( !Py_IsInitialized() )
 		return;
-	if( dlfl_module == NULL && Py_IsInitialized() ) {
+	PyGILState_STATE gstate = PyGILState_Ensure( );
+	if( syspath_append( newPath.toLocal8Bit().constData() ) && dlfl_module == NULL ) {
 		dlfl_module = PyImport_ImportModule("dlfl");
 	}
+	PyGILState_Release( gstate );
 }
 
 void DLFLScriptEditor::execFile( ) {
-	// Grab dlfl dictionary
-	dlfl_module = PyImport_AddModule("dlfl");
-	dlfl_dict = PyModule_GetDict( dlfl_module );
-	// Grab __main__ dictionary
-	main_module = PyImport_AddModule("__main__");
-	main_dict = PyModule_GetDict( main_module );
+	if( isRunning() || !Py_IsInitialized() )
+		return;
 
 	QString filename = 
 		QFileDialog::getOpenFileName(this,
@@ -382,28 +450,11 @@ void DLFLScriptEditor::execFile( ) {
 																 "$HOME",
 																 tr("Python Files (*.py);;All Files (*)"),
 																0, QFileDialog::DontUseSheet);
-	QString error("");
 
 	if( !filename.isEmpty() ) {
 		QString execfileString = QString("execfile(\"") + filename + QString("\")");
-		if( Py_IsInitialized() && main_dict != NULL ) {
-			const char *cmd = execfileString.toLocal8Bit().constData();
-			PyRun_SimpleString( "import sys" );
-			PyObject *rstring = PyRun_String( cmd, Py_file_input, main_dict, main_dict );
-			if( rstring == NULL ) {
-				// There was an error with the command
-				// Print the error message
-				PyObject *object, *data, *traceback;
-				PyErr_Fetch( &object, &data, &traceback );
-				PyObject * traceStr = PyObject_Str( data );
-				char *string = PyString_AsString( traceStr );
-				error = QString("# ") + QString(string);
-			}
-			Py_DECREF( rstring );
-			emit addToHistory(execfileString);
-			echoCommand( execfileString );
-			if( !error.isEmpty() ) { echoCommand( error ); }
-		}
+		emit addToHistory(execfileString);
+		runScript( QStringList(execfileString) );
 	}
 }
 
@@ -495,6 +546,24 @@ void DLFLScriptEditor::spacesToTABs( ) {
 	mCommandEdit->setPlainText( command );
 }
 
+void DLFLScriptEditor::toggleRefreshRateWidget( ) {
+	if( mSetRefreshRateWidget->isVisible() ) {
+		mSetRefreshRateWidget->hide();
+		mSetRefreshRate->setChecked(false);
+	} else {
+		mSetRefreshRateWidget->show();
+		mSetRefreshRate->setChecked(true);
+	}
+}
+
+void DLFLScriptEditor::setRefreshRate( int rate ) {
+	mRefreshRate = rate; // times per second, 0 for only at the end
+	if( isRunning() ) {
+		if( mRefreshRate > 0 ) mRefreshTimer->start( 1000 / mRefreshRate );
+		else mRefreshTimer->stop();
+	}
+}
+
 void DLFLScriptEditor::toggleTabWidthWidget( ) {
 	if( mSetTabWidthWidget->isVisible() ) {
 		mSetTabWidthWidget->hide();
@@ -515,6 +584,130 @@ void DLFLScriptEditor::setTabWidth( int width ) {
 	mCommandEdit->setPlainText(text);
 }
 
+/**
+ * DLFLScriptThread
+ */
+
+// sys.stdout.write of a running script. self is the thread
+static PyObject *scriptWrite( PyObject *self, PyObject *args ) {
+	const char *text;
+	if( !PyArg_ParseTuple(args, "s", &text) )
+		return NULL;
+	((DLFLScriptThread *)PyCObject_AsVoidPtr(self))->write( QString(text) );
+	Py_INCREF(Py_None);
+	return Py_None;
+}
+
+static PyMethodDef scriptWriteDef = { "write", scriptWrite, METH_VARARGS, NULL };
+
+// Trace function of a running script, called before each line
+static int scriptTrace( PyObject *self, PyFrameObject *frame, int what, PyObject *arg ) {
+	// An exception raised at other events could be dropped by Python
+	if( what != PyTrace_LINE )
+		return 0;
+	return ((DLFLScriptThread *)PyCObject_AsVoidPtr(self))->checkRequests();
+}
+
+DLFLScriptThread::DLFLScriptThread( QObject *parent )
+	: QThread(parent), mStopRequested(false), mInterrupted(false), mRefreshRequested(false) {
+}
+
+void DLFLScriptThread::setCommands( const QStringList& commands ) {
+	mCommands = commands;
+	mStopRequested = mInterrupted = mRefreshRequested = false;
+}
+
+void DLFLScriptThread::interrupt( ) {
+	mInterrupted = true;
+	mStopRequested = true;
+}
+
+int DLFLScriptThread::checkRequests( ) {
+	if( mStopRequested ) {
+		mStopRequested = false;
+		PyErr_SetNone( PyExc_KeyboardInterrupt );
+		return -1;
+	}
+	if( mRefreshRequested ) {
+		mRefreshRequested = false;
+		// The interface may need Python while it handles this
+		Py_BEGIN_ALLOW_THREADS
+		emit safePoint();
+		Py_END_ALLOW_THREADS
+	}
+	return 0;
+}
+
+void DLFLScriptThread::run( ) {
+	PyGILState_STATE gstate = PyGILState_Ensure( );
+
+	// Into main_dict: from dlfl import *
+	PyObject *main_dict = PyModule_GetDict( PyImport_AddModule("__main__") );
+	PyObject *dlfl_module = PyImport_AddModule("dlfl");
+	if( dlfl_module )
+		PyDict_Update( main_dict, PyModule_GetDict(dlfl_module) );
+
+	// Send what the script prints to the editor as it comes
+	PyObject *self = PyCObject_FromVoidPtr( this, NULL );
+	PyObject *write = PyCFunction_New( &scriptWriteDef, self );
+	PyObject *mio = PyObject_CallFunctionObjArgs( PyDict_GetItemString(main_dict, "MyIO"), write, NULL );
+	if( mio )
+		PySys_SetObject( (char *)"stdout", mio );
+	PyErr_Clear( );
+	PyEval_SetTrace( scriptTrace, self );
+
+	for( int i = 0; i < mCommands.size() && !mInterrupted; i++ ) {
+		const QString& command = mCommands.at(i);
+
+		// Check if it is a load command (let TopMod handle this instead of Python)
+		if( command.contains(QRegExp("\\bload\\(")) ) {
+			QStringList list = command.split("\"", QString::SkipEmptyParts);
+			if( list.size() > 1 ) {
+				Py_BEGIN_ALLOW_THREADS
+				emit requestObject(list.at(1)); // 3 parts: load(, filename.obj, and )
+				Py_END_ALLOW_THREADS
+			}
+			continue;
+		}
+
+		emit commandStarted( command );
+
+		// ** Run The Command
+		QByteArray cmd = command.toLocal8Bit();
+		PyObject *rstring = PyRun_String( cmd.constData(), Py_file_input, main_dict, main_dict );
+		if( rstring != NULL ) {
+			Py_DECREF( rstring );
+			continue;
+		}
+
+		// There was an error with the command
+		if( PyErr_ExceptionMatches(PyExc_KeyboardInterrupt) ) {
+			PyErr_Clear( );
+			mInterrupted = true;
+			emit error( "KeyboardInterrupt" );
+			break;
+		}
+		// Print the error message
+		PyObject *object, *data, *traceback;
+		PyErr_Fetch( &object, &data, &traceback );
+		PyObject *traceStr = ( data ) ? PyObject_Str( data ) : NULL;
+		emit error( QString( traceStr ? PyString_AsString( traceStr ) : "" ) );
+		Py_XDECREF( traceStr );
+		Py_XDECREF( object );
+		Py_XDECREF( data );
+		Py_XDECREF( traceback );
+	}
+
+	PyEval_SetTrace( NULL, NULL );
+	PySys_SetObject( (char *)"stdout", PySys_GetObject((char *)"__stdout__") );
+	Py_XDECREF( mio );
+	Py_DECREF( write );
+	Py_DECREF( self );
+	PyErr_Clear( );
+
+	PyGILState_Release( gstate );
+}
+
 #endif // WITH_PYTHON
 /*
 *
@@ -40,6 +40,8 @@
 #include <QToolBar>
 #include <QPushButton>
 #include <QSpinBox>
+#include <QThread>
+#include <QTimer>
 #include <iostream>
 
 //class QLineEdit;
@@ -60,6 +62,47 @@ static void **PyDLFL_API;
 #define PyDLFL_PassObject			\
   (*(void (*)(DLFLObject* obj)) PyDLFL_API[1])
 
+// Runs Python commands on a thread of its own, so a long script doesn't freeze
+// the interface. Requests to stop the script or to let the interface draw the
+// object are handled between two lines of the script, where no dlfl operator
+// is halfway through changing the object. An operator which is running has to
+// finish first.
+class DLFLScriptThread : public QThread {
+Q_OBJECT
+
+public:
+  DLFLScriptThread( QObject *parent = 0 );
+
+  void setCommands( const QStringList& commands );
+
+  // Raise KeyboardInterrupt in the script and skip the remaining commands
+  void interrupt( );
+
+  // Called from the script through sys.stdout and the trace function
+  void write( const QString& text ) { emit output(text); };
+  int checkRequests( );
+
+public slots:
+  // Have the script emit safePoint and wait for it to be handled
+  void requestRefresh( ) { mRefreshRequested = true; };
+
+signals:
+  void commandStarted( QString command );
+  void output( QString text );
+  void error( QString message );
+  void requestObject( QString fileName );
+  void safePoint( );
+
+protected:
+  void run( );
+
+private:
+  QStringList mCommands;
+  volatile bool mStopRequested;
+  volatile bool mInterrupted;
+  volatile bool mRefreshRequested;
+};
+
 class DLFLScriptEditor : public QWidget {
 Q_OBJECT
 
@@ -70,16 +113,27 @@ public:
   QColor& outputBgColor( ) { return mOutputBgColor; };
   QColor& inputBgColor( ) { return mInputBgColor; };
 	void retranslateUi();
+	// A script is running, see DLFLScriptThread
+	bool isRunning( ) const { return mScriptThread->isRunning(); };
 
 signals :
   void makingChange( ); // for undo push
   void cmdExecuted( );
   void addToHistory( const QString& item );
   void requestObject( QString fileName );
+  void scriptStarted( );
+  void viewChanged( ); // the running script is waiting while the object is drawn
+  void scriptFinished( );
 private slots :
   void executeCommand( );
 	void echoCommand( QString cmd );
 	void toggleTabWidthWidget( );
+	void toggleRefreshRateWidget( );
+	void printCommand( QString cmd );
+	void printOutput( QString text );
+	void printError( QString message );
+	void refreshView( );
+	void threadFinished( );
 public slots :
   void loadObject( DLFLObject* obj, QString fileName );
 	void loadDLFLModule( QString newPath );
@@ -93,6 +147,10 @@ public slots :
 	// Run this function to convert spaces to TABs
 	void setTabWidth( int width );
 	void spacesToTABs( );
+	void setRefreshRate( int rate );
+	void stopScript( );
+protected :
+	bool eventFilter( QObject *obj, QEvent *event );
 private :
 	// The place where the user types the commands (multiline)
   Editor *mCommandEdit;
@@ -105,6 +163,8 @@ private :
 	QAction *mClearHistory;
 	QAction *mClearInput;
 	QAction *mToggleEchoing;
+	QAction *mSetRefreshRate;
+	QPushButton *mStopButton;
 
 	// For Spaces to TABs conversion
 	QMenu *mFormatMenu;
@@ -119,6 +179,20 @@ private :
   void PyInit();
   PyObject *dlfl_module, *dlfl_dict;
   PyObject *main_module, *main_dict;
+	PyThreadState *mMainThreadState;
+
+	DLFLScriptThread *mScriptThread;
+	// Asks the running script to let the viewport redraw, mRefreshRate times a second
+	QTimer *mRefreshTimer;
+	int mRefreshRate;
+	QSpinBox *mSetRefreshRateWidget;
+	// Output of the script which doesn't end in a newline yet
+	QString mOutputLine;
+
+	void runScript( const QStringList& commands );
+	void printHistory( const QString& text );
+	void flushOutput( );
+	bool isEditorObject( QObject *obj ) const;
 
 	bool mEchoing;
 
@@ -36,34 +36,94 @@
 #include "MainWindow.hh"
 
 //-- Subroutines dealing with undo and redo for DLFLWindow --//
+// Operations which support it record their changes in a DLFLJournal instead of
+// writing out the whole object, and are undone/redone in place. Restoring a snapshot
+// replaces every element of the object, so journals adjacent to a snapshot on either
+// list are turned into snapshots first.
+
+void MainWindow::writeUndoState(UndoStatePtr state)
+{
+	// Snapshots use the binary format, which is much quicker to write and read back
+	state->obj = new StringStream;
+	object.writeDLFB(*(state->obj));
+}
+
+void MainWindow::readUndoState(UndoStatePtr state)
+{
+	state->obj->seekg(0, ios::beg);
+	string data((istreambuf_iterator<char>(*(state->obj))), istreambuf_iterator<char>());
+	object.readDLFBMemory(data.data(), data.size(), true);
+}
 
 void MainWindow::clearUndoList(void) {
-  StringStreamPtrList::iterator first, firstmtl, last;
-	firstmtl = undoMtlList.begin();
-  first = undoList.begin(); last = undoList.end();
+  UndoStatePtrList::iterator first = undoList.begin(), last = undoList.end();
 	while ( first != last ) {
-		StringStreamPtr temp = (*first); ++first;
-		StringStreamPtr tempmtl = (*firstmtl); ++firstmtl;
-		delete temp;	delete tempmtl;
-		temp = NULL; tempmtl = NULL;
+		delete (*first); ++first;
 	}
   undoList.clear();
-  undoMtlList.clear();
 }
 
 void MainWindow::clearRedoList(void)
 {
-	StringStreamPtrList::iterator first, firstmtl, last;
-	firstmtl = redoMtlList.begin();
-	first = redoList.begin(); last = redoList.end();
+	UndoStatePtrList::iterator first = redoList.begin(), last = redoList.end();
 	while ( first != last ) {
-		StringStreamPtr temp = (*first); ++first;
-		StringStreamPtr tempmtl = (*firstmtl); ++firstmtl;
-		delete temp;	delete tempmtl;
-		temp = NULL; tempmtl = NULL;
+		delete (*first); ++first;
 	}
 	redoList.clear();
-	redoMtlList.clear();
+}
+
+void MainWindow::snapshotUndoJournals(void)
+{
+	// Find the journals on top of the undo list
+	UndoStatePtrList::iterator first = undoList.end(), pos;
+	while ( first != undoList.begin() ) {
+		pos = first; --pos;
+		if ( (*pos)->journal == NULL ) break;
+		first = pos;
+	}
+
+	// Undo them from the top, storing the object before each one
+	pos = undoList.end();
+	while ( pos != first ) {
+		--pos;
+		UndoStatePtr state = (*pos);
+		state->journal->revert();
+		writeUndoState(state);
+	}
+
+	// and redo them to get back to the current object
+	while ( pos != undoList.end() ) {
+		UndoStatePtr state = (*pos); ++pos;
+		state->journal->reapply();
+		delete state->journal; state->journal = NULL;
+	}
+}
+
+void MainWindow::snapshotRedoJournals(void)
+{
+	// Find the journals on top of the redo list
+	UndoStatePtrList::iterator first = redoList.end(), pos;
+	while ( first != redoList.begin() ) {
+		pos = first; --pos;
+		if ( (*pos)->journal == NULL ) break;
+		first = pos;
+	}
+
+	// Redo them from the top, storing the object after each one
+	pos = redoList.end();
+	while ( pos != first ) {
+		--pos;
+		UndoStatePtr state = (*pos);
+		state->journal->reapply();
+		writeUndoState(state);
+	}
+
+	// and undo them to get back to the current object
+	while ( pos != redoList.end() ) {
+		UndoStatePtr state = (*pos); ++pos;
+		state->journal->revert();
+		delete state->journal; state->journal = NULL;
+	}
 }
 
 void MainWindow::undoPush(void)
@@ -71,53 +131,79 @@ void MainWindow::undoPush(void)
      // Don't do anything unless undo is required
   if ( useUndo == false ) return;
 
+	snapshotUndoJournals();
+
      // Put current object on top of undo list
      // Check if we have reached undo limit, in which case remove oldest state
      // and add current state to end of list.
   if ( undoList.size() > undolimit ) {
-		StringStreamPtr temp = undoList.front();
-		StringStreamPtr tempmtl = undoMtlList.front();
-		delete temp; delete tempmtl;
+		delete undoList.front();
 		undoList.pop_front();
   }
 
-	StringStreamPtr curobj = new StringStream;
-	StringStreamPtr curobjmtl = new StringStream;
-	
-	object.writeDLFL(*curobj, *curobjmtl);
-	// object.writeMTL(*curobjmtl);
+	UndoStatePtr curstate = new UndoState;
+	writeUndoState(curstate);
 	
-	undoList.push_back(curobj);
-	undoMtlList.push_back(curobjmtl);
+	undoList.push_back(curstate);
 	// Evertime a new operation is done, previous state is put into UndoList
 	// At the same time the redo list should be cleared, because we have
 	// nothing to redo immediately after an operation.
 	clearRedoList();
 }
 
+void MainWindow::undoPushJournal(void)
+{
+  if ( useUndo == false ) return;
+
+  if ( undoList.size() > undolimit ) {
+		delete undoList.front();
+		undoList.pop_front();
+  }
+	clearRedoList();
+
+	// The journal records changes to the object until the operation calls
+	// object.detachJournal()
+	UndoStatePtr curstate = new UndoState;
+	curstate->journal = new DLFLJournal(&object);
+	undoList.push_back(curstate);
+}
+
+void MainWindow::dropUndoJournals(void)
+{
+	// Journals hold pointers into the current elements, which are about to be freed.
+	// Snapshots further down the lists can still be restored
+	object.detachJournal();
+	while ( !undoList.empty() && undoList.back()->journal ) {
+		delete undoList.back(); undoList.pop_back();
+	}
+	while ( !redoList.empty() && redoList.back()->journal ) {
+		delete redoList.back(); redoList.pop_back();
+	}
+}
+
 void MainWindow::undo(void) {
 	
 	if ( !undoList.empty() ) {		
- 		// Restore previous object
-		// Put current object to end of redo list
-		// Take last element of undo list and re-create current object
-		StringStreamPtr curobj = new StringStream;
-		StringStreamPtr curobjmtl = new StringStream;
+		UndoStatePtr oldstate = undoList.back();
+		undoList.pop_back();
 
-		object.writeDLFL(*curobj, *curobjmtl);
-		// object.writeMTL(*curobjmtl);
+		if ( oldstate->journal ) {
+			// Undo the changes in place, keeping the journal to redo them
+			oldstate->journal->revert();
+			redoList.push_back(oldstate);
+		} else {
+			// Restore previous object
+			// Put current object to end of redo list
+			// Take last element of undo list and re-create current object
+			snapshotRedoJournals();
 
-		redoList.push_back(curobj);
-		redoMtlList.push_back(curobjmtl);
+			UndoStatePtr curstate = new UndoState;
+			writeUndoState(curstate);
+			redoList.push_back(curstate);
 
-		StringStreamPtr oldobj = undoList.back();
-		StringStreamPtr oldobjmtl = undoMtlList.back();
-		
-		object.readDLFL(*oldobj,*oldobjmtl,true);
-		// object.readMTL(*oldobj,true);
-
-		undoList.pop_back(); delete oldobj;
-		undoMtlList.pop_back(); delete oldobjmtl;
+			readUndoState(oldstate);
+			delete oldstate;
+		}
 		
 		active->recomputePatches();
 		active->recomputeNormals();
@@ -138,20 +224,26 @@ void MainWindow::undo(void) {
 void MainWindow::redo(void) {
 	
   if ( !redoList.empty() ) {
-		// Redo previously undone operation
-		// Put current object to end of undo list
-		// Take last element of redo list and re-create current object
-		StringStreamPtr curobj = new StringStream;
-		StringStreamPtr curobjmtl = new StringStream;
-		object.writeDLFL(*curobj, *curobjmtl);
-		undoList.push_back(curobj);
-		undoMtlList.push_back(curobjmtl);
-
-		StringStreamPtr newobj = redoList.back();
-		StringStreamPtr newobjmtl = redoMtlList.back();
-		object.readDLFL(*newobj, *newobjmtl);
-		redoList.pop_back(); delete newobj;
-		redoMtlList.pop_back(); delete newobjmtl;
+		UndoStatePtr newstate = redoList.back();
+		redoList.pop_back();
+
+		if ( newstate->journal ) {
+			// Redo the changes in place
+			newstate->journal->reapply();
+			undoList.push_back(newstate);
+		} else {
+			// Redo previously undone operation
+			// Put current object to end of undo list
+			// Take last element of redo list and re-create current object
+			snapshotUndoJournals();
+
+			UndoStatePtr curstate = new UndoState;
+			writeUndoState(curstate);
+			undoList.push_back(curstate);
+
+			readUndoState(newstate);
+			delete newstate;
+		}
 
 		active->recomputePatches();
 		active->recomputeNormals();
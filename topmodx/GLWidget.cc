@@ -78,7 +78,7 @@ DLFLLocatorPtrArray GLWidget::sel_lptr_array;
 
 GLWidget::GLWidget(int w, int h, DLFLRendererPtr rp, QColor color, QColor vcolor, DLFLObjectPtr op, const QGLFormat & format, QWidget * parent ) 
   : 	QGLWidget(format, parent, NULL), /*viewport(w,h,v),*/ object(op), patchObject(NULL), renderer(rp), renderObject(true),
-	mRenderColor(color), mViewportColor(vcolor),/*grid(ZX,20.0,10),*/ showgrid(false), showaxes(false), mUseGPU(false), mAntialiasing(true) { 
+	mRenderColor(color), mViewportColor(vcolor),/*grid(ZX,20.0,10),*/ showgrid(false), showaxes(false), mUseGPU(false), mAntialiasing(true), mBusy(false) { 
   mParent = parent;
   // Vector3d neweye = eye - center;
   // double eyedist = norm(neweye);
@@ -314,6 +314,13 @@ void GLWidget::initCg( ) {
 #endif // GPU_OK
 
 void GLWidget::paintEvent(QPaintEvent *event){
+
+  if ( mBusy ) {
+    // The object is being changed by an operator in another thread
+    QPainter painter(this);
+    painter.drawImage(rect(),mBusyFrame);
+    return;
+  }
 	
   //clear to a white background
   //   glClearColor( 1.0f, 1.0f, 1.0f, 1.0f );
@@ -809,7 +816,7 @@ void GLWidget::drawSelectedIDs( QPainter *painter, const GLdouble *model, const
 	
     if( !mShowVertexIDs ) {
       if ( !object->sel_vptr_array.empty() ){
-	DLFLVertexPtrArray::iterator first, last;
+	DLFLVertexPtrArray::const_iterator first, last;
 	first = object->sel_vptr_array.begin(); last = object->sel_vptr_array.end();
 	while ( first != last ){
 	  QString id = QString::number( (*first)->getID() );
@@ -834,7 +841,7 @@ void GLWidget::drawSelectedIDs( QPainter *painter, const GLdouble *model, const
 	
     if( !mShowEdgeIDs ) {
       if ( !object->sel_eptr_array.empty() ){
-	DLFLEdgePtrArray::iterator first, last;
+	DLFLEdgePtrArray::const_iterator first, last;
 	first = object->sel_eptr_array.begin(); last = object->sel_eptr_array.end();
 	while ( first != last ){
 	  QString id = QString::number( (*first)->getID() );
@@ -858,7 +865,7 @@ void GLWidget::drawSelectedIDs( QPainter *painter, const GLdouble *model, const
 
     if( !mShowFaceIDs ) {
       if ( !object->sel_fptr_array.empty() ){
-	DLFLFacePtrArray::iterator first, last;
+	DLFLFacePtrArray::const_iterator first, last;
 	first = object->sel_fptr_array.begin(); last = object->sel_fptr_array.end();
 	while ( first != last )	{
 	  QString id = QString::number( (*first)->getID() );
@@ -883,7 +890,7 @@ void GLWidget::drawSelectedIDs( QPainter *painter, const GLdouble *model, const
 
     if( !mShowFaceVertexIDs ) {
       if ( !object->sel_fvptr_array.empty() ) {
-	DLFLFaceVertexPtrArray::iterator first, last;
+	DLFLFaceVertexPtrArray::const_iterator first, last;
 	first = object->sel_fvptr_array.begin(); last = object->sel_fvptr_array.end();
 	while ( first != last ){
 	  QString id = QString::number( (*first)->vertex->getID() );
@@ -929,117 +936,32 @@ void GLWidget::drawSelectedIDs( QPainter *painter, const GLdouble *model, const
 // 	// mIsFullScreen != mIsFullScreen;
 // }
 
+// Pick region for DLFLPicker, the region gluPickMatrix gets in selection mode
+void GLWidget::setPickRegion(int mx, int my, int w, int h) {
+  double proj[16], view[16], mvp[16];
+  GLint vp[4] = { 0, 0, width(), height() };
+
+  mCamera->GetProjectionMatrix(width(),height(),proj);
+  mCamera->GetViewMatrix(view);
+  for ( int c = 0; c < 4; c++ )
+    for ( int r = 0; r < 4; r++ ) {
+      mvp[4*c+r] = 0.0;
+      for ( int k = 0; k < 4; k++ )
+	mvp[4*c+r] += proj[4*k+r]*view[4*c+k];
+    }
+  DLFLPicker::instance()->setRegion(mvp,vp,mx,my,w,h);
+}
+
 // Subroutine for selecting a Vertex
 DLFLVertexPtr GLWidget::selectVertex(int mx, int my, int w, int h) {
-  GLuint selectBuf[8192];
-  uint closest;
-  GLuint dist;
-  long hits, index;
-  DLFLVertexPtr sel(NULL);
-
-  glSelectBuffer(8192,selectBuf);
-  glRenderMode(GL_SELECT);
-
-  glInitNames(); glPushName(0);
-
-  GLint vp[4];
-  glGetIntegerv(GL_VIEWPORT, vp);
-  // viewport.camera.enterSelectionMode(mx,my,30,30,vp); // Reduced sensitivity for picking points
-  mCamera->enterSelectionMode(mx,my,w,h,vp); // Reduced sensitivity for picking points
-
-  // Make sure earlier matrices are preserved, since multiple windows
-  // seem to be sharing the same matrix stacks
-  glMatrixMode(GL_PROJECTION);
-  glPushMatrix();
-
-  glMatrixMode(GL_MODELVIEW);
-  glPushMatrix();
-
-  // viewport.reshape();
-  // viewport.apply_transform();
-  // glViewport(0,0,width(),height());
-  mCamera->SetProjection(width(),height());
-  // viewport.apply_transform();
-  glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-  renderVerticesForSelect(object);
-  glFlush();
-
-  glPopMatrix();
-
-  glMatrixMode(GL_PROJECTION);
-  glPopMatrix();
-
-  mCamera->leaveSelectionMode();
-
-  hits = glRenderMode(GL_RENDER);
-  if ( hits > 0 ){
-    closest = 0; dist = 0xffffffff;
-    while ( hits ){
-      index = (hits-1)*4;
-      if ( selectBuf[index+1] < dist ){
-	dist = selectBuf[index+1];
-	closest = selectBuf[index+3];
-      }
-      hits--;
-    }
-    // closest now has the id of the selected vertex
-    sel = DLFLObject::vparray[closest];
-  }
-  return sel;
+  setPickRegion(mx,my,w,h);
+  return DLFLPicker::instance()->pickVertex(object);
 }
 
 // Subroutine for selecting a Vertex
 DLFLVertexPtrArray GLWidget::selectVertices(int mx, int my, int w, int h) {
-  GLuint selectBuf[8192];
-  long hits, index;
-  DLFLVertexPtrArray vparray;
-
-  glSelectBuffer(8192,selectBuf);
-  glRenderMode(GL_SELECT);
-
-  glInitNames(); glPushName(0);
-
-  GLint vp[4];
-  glGetIntegerv(GL_VIEWPORT, vp);
-  mCamera->enterSelectionMode(mx,my,w,h,vp); // Reduced sensitivity for picking points
-
-  // Make sure earlier matrices are preserved, since multiple windows
-  // seem to be sharing the same matrix stacks
-  glMatrixMode(GL_PROJECTION);
-  glPushMatrix();
-
-  glMatrixMode(GL_MODELVIEW);
-  glPushMatrix();
-
-  // viewport.reshape();
-  // viewport.apply_transform();
-  // glViewport(0,0,width(),height());
-  mCamera->SetProjection(width(),height());
-  // viewport.apply_transform();
-  glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-  renderVerticesForSelect(object);
-  glFlush();
-
-  glPopMatrix();
-
-  glMatrixMode(GL_PROJECTION);
-  glPopMatrix();
-
-  mCamera->leaveSelectionMode();
-
-  hits = glRenderMode(GL_RENDER);
-  // std::cout <<  "hits = " << hits << "\n";
-  if ( hits > 0 ){
-    while ( hits ){
-      index = (hits-1)*4;
-      // if(DLFLObject::vparray[selectBuf[index+3]])
-      vparray.push_back(DLFLObject::vparray[selectBuf[index+3]]);
-      hits--;
-    }
-    return vparray;
-  }
-  vparray.clear();
-  return vparray;
+  setPickRegion(mx,my,w,h);
+  return DLFLPicker::instance()->pickVertices(object);
 }
 
 // Subroutine for selecting a locator
@@ -1110,345 +1032,42 @@ DLFLLocatorPtr GLWidget::selectLocator(int mx, int my, int w, int h) // brianb
 
 // Subroutine for selecting an Edge
 DLFLEdgePtr GLWidget::selectEdge(int mx, int my,int w, int h) {
-  GLuint selectBuf[8192];
-  uint closest;
-  GLuint dist;
-  long hits, index;
-  DLFLEdgePtr sel(NULL);
-
-  glSelectBuffer(8192,selectBuf);
-  glRenderMode(GL_SELECT);
-
-  glInitNames(); glPushName(0);
-
-  GLint vp[4];
-  glGetIntegerv(GL_VIEWPORT, vp);
-  mCamera->enterSelectionMode(mx,my,w,h,vp);
-
-  // Make sure earlier matrices are preserved, since multiple windows
-  // seem to be sharing the same matrix stacks
-  glMatrixMode(GL_PROJECTION);
-  glPushMatrix();
-
-  glMatrixMode(GL_MODELVIEW);
-  glPushMatrix();
-
-  // viewport.reshape();
-  // viewport.apply_transform();
-  mCamera->SetProjection(width(),height());
-  // viewport.apply_transform();
-  glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-  renderEdgesForSelect(object);
-  glFlush();
-
-  glPopMatrix();
-
-  glMatrixMode(GL_PROJECTION);
-  glPopMatrix();
-
-  mCamera->leaveSelectionMode();
-
-  hits = glRenderMode(GL_RENDER);
-  if ( hits > 0 ){
-    closest = 0; dist = 0xffffffff;
-    while ( hits ){
-      index = (hits-1)*4;
-      if ( selectBuf[index+1] < dist ){
-	dist = selectBuf[index+1];
-	closest = selectBuf[index+3];
-      }
-      hits--;
-    }
-    // closest now has the id of the selected edge
-    sel = DLFLObject::eparray[closest];
-  }
-  return sel;
+  setPickRegion(mx,my,w,h);
+  return DLFLPicker::instance()->pickEdge(object);
 }
 
 // Subroutine for selecting an Edge
 DLFLEdgePtrArray GLWidget::selectEdges(int mx, int my,int w, int h) {
-  GLuint selectBuf[8192];
-  long hits, index;
-  DLFLEdgePtr sel(NULL);
-  DLFLEdgePtrArray eparray;
-
-  glSelectBuffer(8192,selectBuf);
-  glRenderMode(GL_SELECT);
-
-  glInitNames(); glPushName(0);
-
-  GLint vp[4];
-  glGetIntegerv(GL_VIEWPORT, vp);
-  mCamera->enterSelectionMode(mx,my,w,h,vp);
-
-  // Make sure earlier matrices are preserved, since multiple windows
-  // seem to be sharing the same matrix stacks
-  glMatrixMode(GL_PROJECTION);
-  glPushMatrix();
-  glMatrixMode(GL_MODELVIEW);
-  glPushMatrix();
-
-  mCamera->SetProjection(width(),height());
-  glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-  renderEdgesForSelect(object);
-  glFlush();
-
-  glPopMatrix();
-
-  glMatrixMode(GL_PROJECTION);
-  glPopMatrix();
-
-  mCamera->leaveSelectionMode();
-
-  hits = glRenderMode(GL_RENDER);
-  if ( hits > 0 ){
-    while ( hits ){
-      index = (hits-1)*4;
-      // if(DLFLObject::eparray[selectBuf[index+3]])
-      eparray.push_back(DLFLObject::eparray[selectBuf[index+3]]);
-      hits--;
-    }
-    return eparray;
-  }
-  eparray.clear();
-  return eparray;
+  setPickRegion(mx,my,w,h);
+  return DLFLPicker::instance()->pickEdges(object);
 }
 
 // Subroutine for selecting a Face
 DLFLFacePtr GLWidget::selectFace(int mx, int my, int w, int h) {
-  GLuint selectBuf[8192];
-  uint closest;
-  GLuint dist;
-  long hits, index;
-  DLFLFacePtr sel(NULL);
-
-  glSelectBuffer(8192,selectBuf);
-  glRenderMode(GL_SELECT);
-
-  glInitNames(); glPushName(0);
-
-  GLint vp[4];
-  glGetIntegerv(GL_VIEWPORT, vp);
-  mCamera->enterSelectionMode(mx,my,w,h,vp);
-
-  // Make sure earlier matrices are preserved, since multiple windows
-  // seem to be sharing the same matrix stacks
-  // glLoadIdentity();
-  glMatrixMode(GL_PROJECTION);
-  glPushMatrix();
-
-  glMatrixMode(GL_MODELVIEW);
-  glPushMatrix();
-
-  // viewport.reshape();
-  // viewport.apply_transform();
-  mCamera->SetProjection(width(),height());
-  // viewport.apply_transform();
-  glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-  renderFacesForSelect(object);
-  glFlush();
-
-  glPopMatrix();
-
-  glMatrixMode(GL_PROJECTION);
-  glPopMatrix();
-
-  mCamera->leaveSelectionMode();
-
-  hits = glRenderMode(GL_RENDER);
-  if ( hits > 0 ){
-    closest = 0; dist = 0xffffffff;
-    while ( hits ){
-      index = (hits-1)*4;
-      if ( selectBuf[index+1] < dist ){
-	dist = selectBuf[index+1];
-	closest = selectBuf[index+3];
-      }
-      hits--;
-    }
-    // closest now has the id of the selected face
-    sel = DLFLObject::fparray[closest];
-  }	
-  return sel;
+  setPickRegion(mx,my,w,h);
+  return DLFLPicker::instance()->pickFace(object,GeometryRenderer::instance()->useOutline);
 }
 
 // Subroutine for selecting multiple faces at once
 DLFLFacePtrArray GLWidget::selectFaces(int mx, int my, int w, int h) {
-  // glEnable(GL_CULL_FACE);
-  GLuint selectBuf[8192];
-  long hits, index;
-  DLFLFacePtr sel(NULL);
-  DLFLFacePtrArray fparray;
-  fparray.clear();
-
-  glSelectBuffer(8192,selectBuf);
-  glRenderMode(GL_SELECT);
-
-  glInitNames(); glPushName(0);
-
-  GLint vp[4];
-  glGetIntegerv(GL_VIEWPORT, vp);
-  mCamera->enterSelectionMode(mx,my,w,h,vp);
-
-  // Make sure earlier matrices are preserved, since multiple windows
-  // seem to be sharing the same matrix stacks
-  glMatrixMode(GL_PROJECTION);
-  glPushMatrix();
-  glMatrixMode(GL_MODELVIEW);
-  glPushMatrix();
-
-  mCamera->SetProjection(width(),height());
-  glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-  renderFacesForSelect(object);
-  glFlush();
-
-  glPopMatrix();
-
-  glMatrixMode(GL_PROJECTION);
-  glPopMatrix();
-
-  mCamera->leaveSelectionMode();
-
-  hits = glRenderMode(GL_RENDER);
-  // std::cout << hits << " = hits\n";
-  if ( hits > 0 ){
-    while ( hits ){
-      index = (hits-1)*4;			
-      // if(DLFLObject::fparray[selectBuf[index+3]])
-      fparray.push_back(DLFLObject::fparray[selectBuf[index+3]]);
-      hits--;
-    }	
-    // glDisable(GL_CULL_FACE);
-    return fparray;		
-  }	
-  // glDisable(GL_CULL_FACE);
-  fparray.clear();
-  return fparray;
+  setPickRegion(mx,my,w,h);
+  return DLFLPicker::instance()->pickFaces(object,GeometryRenderer::instance()->useOutline);
 }
 
 
 // Subroutine for selecting multiple faces at once
 // DLFLFacePtrArray GLWidget::deselectFaces(int mx, int my) {
 DLFLFacePtr GLWidget::deselectFaces(int mx, int my, int w, int h) {
-  glEnable(GL_CULL_FACE);
-  GLuint selectBuf[8192];
-  uint closest;
-  GLuint dist;
-  long hits, index;
-  DLFLFacePtr sel(NULL);
-  DLFLFacePtrArray fparray;
-
-  glSelectBuffer(8192,selectBuf);
-  glRenderMode(GL_SELECT);
-
-  glInitNames(); glPushName(0);
-
-  GLint vp[4];
-  glGetIntegerv(GL_VIEWPORT, vp);
-  mCamera->enterSelectionMode(mx,my,mBrushSize,mBrushSize,vp);
-
-  // Make sure earlier matrices are preserved, since multiple windows
-  // seem to be sharing the same matrix stacks
-  // glLoadIdentity();
-  glMatrixMode(GL_PROJECTION);
-  glPushMatrix();
-
-  glMatrixMode(GL_MODELVIEW);
-  glPushMatrix();
-
-  // viewport.reshape();
-  // viewport.apply_transform();
-  mCamera->SetProjection(width(),height());
-  // viewport.apply_transform();
-  glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-  renderFacesForSelect(object);
-  glFlush();
-
-  glPopMatrix();
-
-  glMatrixMode(GL_PROJECTION);
-  glPopMatrix();
-
-  mCamera->leaveSelectionMode();
-
-  hits = glRenderMode(GL_RENDER);
-  if ( hits > 0 ){
-    closest = 0; dist = 0xffffffff;
-    while ( hits ){
-      index = (hits-1)*4;
-      if ( selectBuf[index+1] < dist ){
-	dist = selectBuf[index+1];
-	closest = selectBuf[index+3];
-      }
-			
-      //if (DLFLObject::fparray[selectBuf[index+3]].normalCentroid()*camera.getPos()){
-      // if(isSelected(DLFLObject::fparray[selectBuf[index+3]]))
-      // fparray.push_back(DLFLObject::fparray[selectBuf[index+3]]);
-      //}
-      hits--;
-    }
-    // closest now has the id of the selected face
-    sel = DLFLObject::fparray[closest];
-  }	
-  glDisable(GL_CULL_FACE);
-  // return fparray;
-  return sel;
+  // Only faces turned towards the viewer, as with culling enabled
+  setPickRegion(mx,my,mBrushSize,mBrushSize);
+  return DLFLPicker::instance()->pickFace(object,GeometryRenderer::instance()->useOutline,
+					  DLFLRenderer::isReversed() ? -1 : 1);
 }
 
 // Subroutine for selecting a FaceVertex (Corner) within a Face
 DLFLFaceVertexPtr GLWidget::selectFaceVertex(DLFLFacePtr fp, int mx, int my, int w, int h) {
-  GLuint selectBuf[8192];
-  uint closest;
-  GLuint dist;
-  long hits, index;
-  DLFLFaceVertexPtr sel(NULL);
-
-  glSelectBuffer(8192,selectBuf);
-  glRenderMode(GL_SELECT);
-
-  glInitNames(); glPushName(0);
-
-  GLint vp[4];
-  glGetIntegerv(GL_VIEWPORT, vp);
-  mCamera->enterSelectionMode(mx,my,w,h,vp);
-  // Make sure earlier matrices are preserved, since multiple windows
-  // seem to be sharing the same matrix stacks
-  glMatrixMode(GL_PROJECTION);
-  glPushMatrix();
-
-  glMatrixMode(GL_MODELVIEW);
-  glPushMatrix();
-
-  // viewport.reshape();
-  // viewport.apply_transform();
-  mCamera->SetProjection(width(),height());
-  // viewport.apply_transform();
-  glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-  renderFaceVerticesForSelect(fp);
-  glFlush();
-
-  glPopMatrix();
-
-  glMatrixMode(GL_PROJECTION);
-  glPopMatrix();
-
-  mCamera->leaveSelectionMode();
-
-  hits = glRenderMode(GL_RENDER);
-  if ( hits > 0 ){
-    closest = 0; dist = 0xffffffff;
-    while ( hits ){
-      index = (hits-1)*4;
-      if ( selectBuf[index+1] < dist ){
-	dist = selectBuf[index+1];
-	closest = selectBuf[index+3];
-      }
-      hits--;
-    }
-    // closest now has the id of the selected face vertex
-    sel = DLFLObject::fvparray[closest];
-  }
-  return sel;
+  setPickRegion(mx,my,w,h);
+  return DLFLPicker::instance()->pickFaceVertex(fp);
 }
 
 // Draw the selected items
@@ -1461,7 +1080,7 @@ void GLWidget::drawSelected(void) {
     glPointSize(mSelectedVertexThickness);
     //glBegin(GL_POINTS);
     glColor4f(mSelectedVertexColor.redF(),mSelectedVertexColor.greenF(),mSelectedVertexColor.blueF(),mSelectedVertexColor.alphaF());
-    DLFLVertexPtrArray::iterator first, last;
+    DLFLVertexPtrArray::const_iterator first, last;
     first = object->sel_vptr_array.begin(); last = object->sel_vptr_array.end();
     while ( first != last ){
       GeometryRenderer::instance()->renderVertex(*first);
@@ -1475,7 +1094,7 @@ void GLWidget::drawSelected(void) {
   if ( !object->sel_eptr_array.empty() ){
     glLineWidth(mSelectedEdgeThickness);
     glColor4f(mSelectedEdgeColor.redF(),mSelectedEdgeColor.greenF(),mSelectedEdgeColor.blueF(),mSelectedEdgeColor.alphaF());
-    DLFLEdgePtrArray::iterator first, last;
+    DLFLEdgePtrArray::const_iterator first, last;
     first = object->sel_eptr_array.begin(); last = object->sel_eptr_array.end();
     while ( first != last ){
       glBegin(GL_LINES); {
@@ -1490,7 +1109,7 @@ void GLWidget::drawSelected(void) {
   if ( !object->sel_fptr_array.empty() ){
     glLineWidth(mSelectedEdgeThickness);
     glColor4f(mSelectedFaceColor.redF(),mSelectedFaceColor.greenF(),mSelectedFaceColor.blueF(),mSelectedFaceColor.alphaF());
-    DLFLFacePtrArray::iterator first, last;
+    DLFLFacePtrArray::const_iterator first, last;
     first = object->sel_fptr_array.begin(); last = object->sel_fptr_array.end();
     while ( first != last )	{
       GeometryRenderer::instance()->renderFace(*first,false);
@@ -1504,7 +1123,7 @@ void GLWidget::drawSelected(void) {
     glPointSize(mSelectedVertexThickness);
     glColor4f(mSelectedVertexColor.redF(),mSelectedVertexColor.greenF(),mSelectedVertexColor.blueF(),mSelectedVertexColor.alphaF());
     glBegin(GL_POINTS);
-    DLFLFaceVertexPtrArray::iterator first, last;
+    DLFLFaceVertexPtrArray::const_iterator first, last;
     first = object->sel_fvptr_array.begin(); last = object->sel_fvptr_array.end();
     while ( first != last ){
       GeometryRenderer::instance()->renderFaceVertex(*first,false);
@@ -1749,18 +1368,47 @@ void erase_dlp(DLFLLocatorPtr lp)  { delete lp; } // brianb
 // Global operations (don't require selection)
 void GLWidget::recomputeNormals(void)     // Recompute normals and lighting
 {
-  object->computeNormals();
-  computeLighting( object, patchObject, &plight, mUseGPU);
+  // If the last operation tracked what it changed, only that region needs
+  // new normals and lighting. Otherwise (or if it changed most of the
+  // object anyway) recompute everything
+  DLFLFacePtrArray region;
+  if ( object->isTrackingChanges() ) object->getChangedFaces(region);
+  if ( object->isTrackingChanges() && region.size() < object->num_faces() / 2 ) {
+    object->computeNormals(region);
+    computeLighting( region, patchObject, &plight, mUseGPU);
+  } else {
+    object->computeNormals();
+    computeLighting( object, patchObject, &plight, mUseGPU);
+  }
+  object->stopTrackingChanges();
+  GeometryRenderer::instance()->invalidate();
+  DLFLPicker::instance()->invalidate();
 }
 
 void GLWidget::recomputeLighting(void)                // Recompute lighting
 {
   computeLighting( object, patchObject, &plight, mUseGPU);
+  GeometryRenderer::instance()->invalidate();
+}
+
+void GLWidget::setBusy(bool b)
+{
+  // Keep the last frame to show while the object can't be drawn
+  if ( b && !mBusy ) mBusyFrame = grabFrameBuffer();
+  else if ( !b ) mBusyFrame = QImage();
+  mBusy = b;
 }
 
 void GLWidget::recomputePatches(void) // Recompute the patches for patch rendering
 {
-  if(patchObject)
+  if ( !patchObject ) return;
+  // Called before recomputeNormals, while the changes of the last operation
+  // are still tracked. A small region only needs the patches around it rebuilt
+  DLFLFacePtrArray region;
+  if ( object->isTrackingChanges() ) object->getChangedFaces(region);
+  if ( object->isTrackingChanges() && region.size() < object->num_faces() / 2 )
+    patchObject->updatePatches(object,region);
+  else
     patchObject->updatePatches(object);
 }
 
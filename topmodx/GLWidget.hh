@@ -46,6 +46,7 @@
 
 #include <DLFLObject.hh>
 #include "DLFLRenderer.hh"
+#include "DLFLPicker.hh"
 #include "TMPatchObject.hh"
 
 #include "DLFLLighting.hh"
@@ -259,20 +260,17 @@ public :
 	}
 
 	void selectAllFaces(){
-		clearSelectedFaces();
-		object->getFaces(object->sel_fptr_array);
+		object->sel_fptr_array.assign(object->beginFace(),object->endFace());
 		repaint();
 	}
 
 	void selectAllEdges(){
-		clearSelectedEdges();
-		object->getEdges(object->sel_eptr_array);
+		object->sel_eptr_array.assign(object->beginEdge(),object->endEdge());
 		repaint();
 	}
 
 	void selectAllVertices(){
-		clearSelectedVertices();
-		object->getVertices(object->sel_vptr_array);
+		object->sel_vptr_array.assign(object->beginVertex(),object->endVertex());
 		repaint();
 	}
 
@@ -283,41 +281,23 @@ public :
 	}
 	
 	void selectInverseFaces(){
-		DLFLFacePtrArray fparray;
-		vector<DLFLFacePtr>::iterator it;
-		object->getFaces(fparray);
-		for (it = fparray.begin(); it != fparray.end(); it++){
-			if (!isSelected(*it)){
-				addToSelection(*it);
-			}
-			else clearSelectedFace(*it);
-		}
+		DLFLFacePtrList::iterator it;
+		for (it = object->beginFace(); it != object->endFace(); it++)
+			object->sel_fptr_array.toggle(*it);
 		repaint();
 	}
 
 	void selectInverseEdges(){
-		DLFLEdgePtrArray eparray;
-		vector<DLFLEdgePtr>::iterator it;
-		object->getEdges(eparray);
-		for (it = eparray.begin(); it != eparray.end(); it++){
-			if (!isSelected(*it)){
-				addToSelection(*it);
-			}
-			else clearSelectedEdge(*it);
-		}
+		DLFLEdgePtrList::iterator it;
+		for (it = object->beginEdge(); it != object->endEdge(); it++)
+			object->sel_eptr_array.toggle(*it);
 		repaint();
 	}
 
 	void selectInverseVertices(){
-		DLFLVertexPtrArray vparray;
-		vector<DLFLVertexPtr>::iterator it;
-		object->getVertices(vparray);
-		for (it = vparray.begin(); it != vparray.end(); it++){
-			if (!isSelected(*it)){
-				addToSelection(*it);
-			}
-			else clearSelectedVertex(*it);
-		}
+		DLFLVertexPtrList::iterator it;
+		for (it = object->beginVertex(); it != object->endVertex(); it++)
+			object->sel_vptr_array.toggle(*it);
 		repaint();
 	}
 		//maybe this isn't necessary? ??
@@ -391,6 +371,11 @@ public :
 	//temporarily disable object rendering
 	bool renderObject;
 
+	// Set while an operator changes the object in another thread. The viewport
+	// shows the last frame drawn until then
+	bool mBusy;
+	QImage mBusyFrame;
+
 		// Selection lists - these are shared by all viewports
 	static DLFLLocatorPtrArray sel_lptr_array; // List of selected DLFLLocator pointers  // brianb  
   //static DLFLVertexPtrArray sel_vptr_array; // List of selected DLFLVertex pointers
@@ -442,6 +427,8 @@ public :
 	// }
 	
 	void setRenderingEnabled(bool b){ renderObject = b; };
+	void setBusy(bool b);
+	bool isBusy() const { return mBusy; }
 	
 	void setModeString(QString s){
 		mModeString = s;
@@ -490,19 +477,19 @@ public :
 	}
 
 	void addToSelection(DLFLVertexPtr vp) {
-		if ( vp ) object->sel_vptr_array.push_back(vp);
+		object->sel_vptr_array.insert(vp);
 	}
 
 	void addToSelection(DLFLEdgePtr ep) {
-		if ( ep ) object->sel_eptr_array.push_back(ep);
+		object->sel_eptr_array.insert(ep);
 	}
 
 	void addToSelection(DLFLFacePtr fp) {
-		if ( fp ) object->sel_fptr_array.push_back(fp);
+		object->sel_fptr_array.insert(fp);
 	}
 
 	void addToSelection(DLFLFaceVertexPtr fvp) {
-		if ( fvp ) object->sel_fvptr_array.push_back(fvp);
+		object->sel_fvptr_array.insert(fvp);
 	}
 
 		//--- Check if given item is there in the selection list ---//
@@ -522,55 +509,19 @@ public :
 	}
 
 	bool isSelected(DLFLVertexPtr vp) {
-		bool found = false;
-		if ( vp )
-		{
-			for (uint i=0; i < object->sel_vptr_array.size(); ++i)
-				if ( object->sel_vptr_array[i] == vp )
-			{
-				found = true; break;
-			}
-		}
-		return found;
+		return object->sel_vptr_array.contains(vp);
 	}
 
 	bool isSelected(DLFLEdgePtr ep) {
-		bool found = false;
-		if ( ep )
-		{
-			for (uint i=0; i < object->sel_eptr_array.size(); ++i)
-				if ( object->sel_eptr_array[i] == ep )
-			{
-				found = true; break;
-			}
-		}
-		return found;
+		return object->sel_eptr_array.contains(ep);
 	}
 
 	bool isSelected(DLFLFacePtr fp) {
-		bool found = false;
-		if ( fp )
-		{
-			for (uint i=0; i < object->sel_fptr_array.size(); ++i)
-				if ( object->sel_fptr_array[i] == fp )
-			{
-				found = true; break;
-			}
-		}
-		return found;
+		return object->sel_fptr_array.contains(fp);
 	}
 
 	bool isSelected(DLFLFaceVertexPtr fvp) {
-		bool found = false;
-		if ( fvp )
-		{
-			for (uint i=0; i < object->sel_fvptr_array.size(); ++i)
-				if ( object->sel_fvptr_array[i] == fvp )
-			{
-				found = true; break;
-			}
-		}
-		return found;
+		return object->sel_fvptr_array.contains(fvp);
 	}
 
 		//--- Set the selected item at given index ---//
@@ -585,75 +536,35 @@ public :
 	}
 
 	void setSelectedVertex(int index, DLFLVertexPtr vp) {
-		if ( vp && index >= 0 )
-		{
-			if ( (uint) index < object->sel_vptr_array.size() ) object->sel_vptr_array[index] = vp;
-			else object->sel_vptr_array.push_back(vp);
-		}
+		if ( index >= 0 ) object->sel_vptr_array.set(index,vp);
 	}
 
 	void setSelectedEdge(int index, DLFLEdgePtr ep) {
-		if ( ep && index >= 0 )
-		{
-			if ( (uint) index < object->sel_eptr_array.size() ) object->sel_eptr_array[index] = ep;
-			else object->sel_eptr_array.push_back(ep);
-		}
+		if ( index >= 0 ) object->sel_eptr_array.set(index,ep);
 	}
 
 	void setSelectedFace(int index, DLFLFacePtr fp) {
-		if ( fp && index >= 0 )
-		{
-			if ( (uint) index < object->sel_fptr_array.size() ) object->sel_fptr_array[index] = fp;
-			else object->sel_fptr_array.push_back(fp);
-		}
+		if ( index >= 0 ) object->sel_fptr_array.set(index,fp);
 	}
 
 	void setSelectedFaceVertex(int index, DLFLFaceVertexPtr fvp) {
-		if ( fvp && index >= 0 )
-		{
-			if ( (uint) index < object->sel_fvptr_array.size() ) object->sel_fvptr_array[index] = fvp;
-			else object->sel_fvptr_array.push_back(fvp);
-		}
+		if ( index >= 0 ) object->sel_fvptr_array.set(index,fvp);
 	}
 
 	void setSelectedVertex(DLFLVertexPtr vp) {
-		if ( vp )
-		{
-			if (!isSelected(vp)){
-				// if ( (uint) index < object->sel_vptr_array.size() ) object->sel_vptr_array[index] = vp;
-				object->sel_vptr_array.push_back(vp);
-			}
-		}
+		object->sel_vptr_array.insert(vp);
 	}
 
 	void setSelectedEdge(DLFLEdgePtr ep) {
-		if ( ep )
-		{
-			if (!isSelected(ep)){
-				// if ( (uint) index < object->sel_eptr_array.size() ) object->sel_eptr_array[index] = ep;
-				 object->sel_eptr_array.push_back(ep);
-			}
-		}
+		object->sel_eptr_array.insert(ep);
 	}
 
 	void setSelectedFace(DLFLFacePtr fp) {
-		if ( fp )
-		{
-			if (!isSelected(fp)){
-				// if ( (uint) index < object->sel_fptr_array.size() ) object->sel_fptr_array[index] = fp;
-				object->sel_fptr_array.push_back(fp);
-			}
-		}
+		object->sel_fptr_array.insert(fp);
 	}
 
 	void setSelectedFaceVertex(DLFLFaceVertexPtr fvp) {
-		if ( fvp )
-		{
-			if (!isSelected(fvp)){
-				// if ( (uint) index < object->sel_fvptr_array.size() ) object->sel_fvptr_array[index] = fvp;
-				object->sel_fvptr_array.push_back(fvp);
-			}
-		}
+		object->sel_fvptr_array.insert(fvp);
 	}
 
 		//--- Return the selected items at given index ---//
@@ -747,44 +658,19 @@ void clearSelectedCorners(void) {
 }
 
 void clearSelectedFace(DLFLFacePtr fp){
-	vector<DLFLFacePtr>::iterator fiterator;
-	for(fiterator = object->sel_fptr_array.begin(); fiterator != object->sel_fptr_array.end(); fiterator++) {
-		if (fp == *fiterator){
-			// delete fp;
-			object->sel_fptr_array.erase(fiterator);
-			return;
-		}
-	}
+	object->sel_fptr_array.erase(fp);
 }
 
 void clearSelectedEdge(DLFLEdgePtr ep){
-	vector<DLFLEdgePtr>::iterator it;
-	for(it = object->sel_eptr_array.begin(); it != object->sel_eptr_array.end(); it++) {
-		if (ep == *it){
-			object->sel_eptr_array.erase(it);
-			return;
-		}
-	}
+	object->sel_eptr_array.erase(ep);
 }
 
 void clearSelectedVertex(DLFLVertexPtr vp){
-	vector<DLFLVertexPtr>::iterator it;
-	for(it = object->sel_vptr_array.begin(); it != object->sel_vptr_array.end(); it++) {
-		if (vp == *it){
-			object->sel_vptr_array.erase(it);
-			return;
-		}
-	}
+	object->sel_vptr_array.erase(vp);
 }
 
 void clearSelectedFaceVertex(DLFLFaceVertexPtr fvp){
-	vector<DLFLFaceVertexPtr>::iterator it;
-	for(it = object->sel_fvptr_array.begin(); it != object->sel_fvptr_array.end(); it++) {
-		if (fvp == *it){
-			object->sel_fvptr_array.erase(it);
-			return;
-		}
-	}
+	object->sel_fvptr_array.erase(fvp);
 }
 
 void clearSelectedFaceVertices(void) {
@@ -872,6 +758,7 @@ void wheelEvent(QWheelEvent *event);
 
 private :
 friend class QGLFormat;
+void setPickRegion(int mx, int my, int w, int h);		// Pick region for the select subroutines
 QColor mGlobalAmbient;
 QColor mRenderColor;
 QColor mViewportColor;
@@ -0,0 +1,355 @@
+/*
+*
+* ***** BEGIN GPL LICENSE BLOCK *****
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software  Foundation,
+* Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*
+* The Original Code is Copyright (C) 2005 by xxxxxxxxxxxxxx
+* All rights reserved.
+*
+* The Original Code is: all of this file.
+*
+* Contributor(s): none yet.
+*
+* ***** END GPL LICENSE BLOCK *****
+*
+* Short description of this file
+*
+* name of .hh file containing function prototypes
+*
+*/
+
+
+#include <QGLContext>
+
+#include "GeometryBuffer.hh"
+#include "GeometryRenderer.hh"
+
+/*!
+\ingroup gui
+@{
+
+	\class GeometryBuffer
+		\brief retained mode storage of a DLFL object for GeometryRenderer
+
+		\note The faces are triangulated and packed into vertex arrays grouped
+		by material. Vertex buffer objects are used when the OpenGL implementation
+		provides them, otherwise the arrays are drawn from client memory.
+
+		\see GeometryRenderer
+*/
+
+// Buffer object entry points are not part of OpenGL 1.1 and are looked up at runtime
+#ifndef APIENTRY
+#define APIENTRY
+#endif
+#ifndef GL_ARRAY_BUFFER
+#define GL_ARRAY_BUFFER 0x8892
+#endif
+#ifndef GL_DYNAMIC_DRAW
+#define GL_DYNAMIC_DRAW 0x88E8
+#endif
+
+typedef void (APIENTRY *GenBuffersProc)( GLsizei n, GLuint *buffers );
+typedef void (APIENTRY *BindBufferProc)( GLenum target, GLuint buffer );
+typedef void (APIENTRY *BufferDataProc)( GLenum target, ptrdiff_t size, const GLvoid *data, GLenum usage );
+typedef void (APIENTRY *BufferSubDataProc)( GLenum target, ptrdiff_t offset, ptrdiff_t size, const GLvoid *data );
+
+static GenBuffersProc genBuffers = 0;
+static BindBufferProc bindBuffer = 0;
+static BufferDataProc bufferData = 0;
+static BufferSubDataProc bufferSubData = 0;
+
+static void *procAddress( const QGLContext *context, const char *name ) {
+	void *proc = context->getProcAddress( QString(name) );
+	if( !proc ) proc = context->getProcAddress( QString(name) + "ARB" );
+	return proc;
+}
+
+// Look up the buffer object functions. Returns false if they are not available
+static bool initBufferProcs( ) {
+	static bool initialized = false;
+	if( !initialized ) {
+		const QGLContext *context = QGLContext::currentContext( );
+		if( !context ) return false;
+		initialized = true;
+		genBuffers = (GenBuffersProc) procAddress( context, "glGenBuffers" );
+		bindBuffer = (BindBufferProc) procAddress( context, "glBindBuffer" );
+		bufferData = (BufferDataProc) procAddress( context, "glBufferData" );
+		bufferSubData = (BufferSubDataProc) procAddress( context, "glBufferSubData" );
+		if( !genBuffers || !bindBuffer || !bufferData || !bufferSubData )
+			genBuffers = 0;
+	}
+	return genBuffers != 0;
+}
+
+static void transform( DLFLObjectPtr obj ) {
+	double mat[16];
+	obj->tr.fillArrayColumnMajor(mat);
+	glMultMatrixd(mat);
+}
+
+// Flags of GeometryRenderer which change the packed arrays
+static int renderMode( const GeometryRenderer& gr ) {
+	int mode = 0;
+	if( gr.useLighting ) mode |= 1;
+	if( gr.useMaterial ) mode |= 2;
+	if( gr.useColorable ) mode |= 4;
+	if( gr.useTexture ) mode |= 8;
+	if( gr.useNormal ) mode |= 16;
+	if( gr.useGPU ) mode |= 32;
+	return mode;
+}
+
+GeometryBuffer::GeometryBuffer( )
+	: mObject(NULL), mDirty(true), mTopologyStamp(0), mAttributeStamp(0), mMode(-1) {
+	for( int i = 0; i < 4; i++ ) mColorKey[i] = -1.0;
+	for( int i = 0; i < NumBuffers; i++ ) mBuffers[i] = 0;
+}
+
+GeometryBuffer::~GeometryBuffer( ) {
+	// The GL context may be gone already, the buffers are released with it
+}
+
+void GeometryBuffer::update( DLFLObjectPtr obj, const GeometryRenderer& gr ) {
+	// Edits of vertex positions report themselves through invalidate(). Changes of the
+	// topology, of materials and corner attributes (see DLFLObject::attributesChanged)
+	// and of the render settings are picked up here
+	int mode = renderMode( gr );
+	bool colorChanged = false;
+	for( int i = 0; i < 4; i++ )
+		if( mColorKey[i] != gr.renderColor[i] ) colorChanged = true;
+	if( !mDirty && obj == mObject && mode == mMode && !colorChanged &&
+			obj->topologyStamp() == mTopologyStamp && obj->attributeStamp() == mAttributeStamp )
+		return;
+
+	if( mBuffers[Positions] == 0 && initBufferProcs( ) )
+		genBuffers( NumBuffers, mBuffers );
+
+	FloatArray arrays[NumBuffers];
+	pack( obj, gr, arrays );
+	for( int i = 0; i < NumBuffers; i++ )
+		upload( i, arrays[i] );
+
+	mObject = obj;
+	mDirty = false;
+	mMode = mode;
+	for( int i = 0; i < 4; i++ ) mColorKey[i] = gr.renderColor[i];
+	mTopologyStamp = obj->topologyStamp( );
+	mAttributeStamp = obj->attributeStamp( );
+}
+
+// Triangulate the faces as fans and write the attributes of every triangle corner in
+// the same way GeometryRenderer::renderFaceVertex passes them to OpenGL
+void GeometryBuffer::pack( DLFLObjectPtr obj, const GeometryRenderer& gr, FloatArray *arrays ) {
+	mGroups.clear( );
+	mOthers.clear( );
+
+	// Count the triangle corners of each material first so the arrays are filled in place
+	DLFLMaterialPtrList::iterator mp_it;
+	DLFLFacePtrList::iterator fp_it;
+	GLint count = 0;
+	for( mp_it = obj->beginMaterial(); mp_it != obj->endMaterial(); mp_it++ ) {
+		Group group;
+		group.material = *mp_it;
+		group.first = count;
+		for( fp_it = group.material->faces.begin(); fp_it != group.material->faces.end(); fp_it++ ) {
+			int size = (*fp_it)->size( );
+			if( size > 2 ) count += 3 * (size - 2);
+			else if( size > 0 ) mOthers.push_back( *fp_it );
+		}
+		group.count = count - group.first;
+		if( group.count > 0 ) mGroups.push_back( group );
+	}
+
+	const GLdouble *rc = gr.renderColor;
+	bool modulate = true;
+	#ifdef GPU_OK
+	modulate = !gr.useGPU;
+	#endif
+	int colors = 0;                                // Same order of precedence as renderFaceVertex
+	if( gr.useLighting && gr.useMaterial ) colors = 1;
+	else if( gr.useColorable ) colors = 2;
+	else if( gr.useMaterial ) colors = 3;
+	else if( gr.useLighting ) colors = 4;
+
+	arrays[Positions].resize( 3 * count );
+	arrays[Normals].resize( gr.useNormal ? 3 * count : 0 );
+	arrays[Colors].resize( colors ? 4 * count : 0 );
+	arrays[TexCoords].resize( gr.useTexture ? 2 * count : 0 );
+	GLfloat *pos = count ? &arrays[Positions][0] : NULL;
+	GLfloat *nor = gr.useNormal && count ? &arrays[Normals][0] : NULL;
+	GLfloat *col = colors && count ? &arrays[Colors][0] : NULL;
+	GLfloat *tex = gr.useTexture && count ? &arrays[TexCoords][0] : NULL;
+
+	DLFLFaceVertexPtrArray corners;
+	vector<Group>::iterator it;
+	for( it = mGroups.begin(); it != mGroups.end(); it++ ) {
+		DLFLMaterialPtr mat = it->material;
+		for( fp_it = mat->faces.begin(); fp_it != mat->faces.end(); fp_it++ ) {
+			DLFLFaceVertexPtr head = (*fp_it)->front( );
+			if( head == NULL || head->next() == head || head->next()->next() == head )
+				continue;
+			// Fan around the first corner, like GL_POLYGON
+			corners.clear( );
+			DLFLFaceVertexPtr curr = head;
+			do {
+				corners.push_back( curr );
+				curr = curr->next( );
+			} while( curr != head );
+			for( uint k = 0; k < 3 * (corners.size() - 2); k++ ) {
+				DLFLFaceVertexPtr dfv = corners[ k % 3 == 0 ? 0 : k / 3 + k % 3 ];
+				const Vector3d& p = dfv->vertex->coords;
+				*pos++ = p[0]; *pos++ = p[1]; *pos++ = p[2];
+				if( nor ) {
+					*nor++ = dfv->normal[0]; *nor++ = dfv->normal[1]; *nor++ = dfv->normal[2];
+				}
+				switch( colors ) {
+				case 1 :
+					if( modulate ) {
+						*col++ = rc[0] * dfv->color.r; *col++ = rc[1] * dfv->color.g; *col++ = rc[2] * dfv->color.b;
+					} else {
+						*col++ = rc[0]; *col++ = rc[1]; *col++ = rc[2];
+					}
+					*col++ = rc[3];
+					break;
+				case 2 :
+					*col++ = mat->color.r; *col++ = mat->color.g; *col++ = mat->color.b; *col++ = rc[3];
+					break;
+				case 3 :
+					*col++ = rc[0]; *col++ = rc[1]; *col++ = rc[2]; *col++ = rc[3];
+					break;
+				case 4 :
+					*col++ = dfv->color.r; *col++ = dfv->color.g; *col++ = dfv->color.b; *col++ = 1.0;
+					break;
+				}
+				if( tex ) {
+					*tex++ = 1.0 - dfv->texcoord[0]; *tex++ = 1.0 - dfv->texcoord[1];
+				}
+			}
+		}
+	}
+
+	DLFLEdgePtrList::iterator eit;
+	DLFLFaceVertexPtr fvptr1, fvptr2;
+	arrays[Edges].resize( 6 * obj->num_edges() );
+	GLfloat *edge = arrays[Edges].empty() ? NULL : &arrays[Edges][0];
+	for( eit = obj->beginEdge(); eit != obj->endEdge(); eit++ ) {
+		(*eit)->getFaceVertexPointers( fvptr1, fvptr2 );
+		const Vector3d& p1 = fvptr1->vertex->coords;
+		const Vector3d& p2 = fvptr2->vertex->coords;
+		*edge++ = p1[0]; *edge++ = p1[1]; *edge++ = p1[2];
+		*edge++ = p2[0]; *edge++ = p2[1]; *edge++ = p2[2];
+	}
+}
+
+// Replace the contents of a buffer with the packed array. If the size is unchanged only
+// the span between the first and last changed values is sent
+void GeometryBuffer::upload( int buffer, FloatArray& packed ) {
+	FloatArray& current = mArrays[buffer];
+	GLuint id = mBuffers[buffer];
+	if( current.size() != packed.size() ) {
+		current.swap( packed );
+		if( id ) {
+			bindBuffer( GL_ARRAY_BUFFER, id );
+			bufferData( GL_ARRAY_BUFFER, current.size() * sizeof(GLfloat),
+									current.empty() ? NULL : &current[0], GL_DYNAMIC_DRAW );
+			bindBuffer( GL_ARRAY_BUFFER, 0 );
+		}
+		return;
+	}
+
+	size_t first = 0, last = current.size();
+	while( first < last && current[first] == packed[first] ) ++first;
+	if( first == last ) return;
+	while( last > first && current[last-1] == packed[last-1] ) --last;
+	std::copy( packed.begin() + first, packed.begin() + last, current.begin() + first );
+	if( id ) {
+		bindBuffer( GL_ARRAY_BUFFER, id );
+		bufferSubData( GL_ARRAY_BUFFER, first * sizeof(GLfloat), (last - first) * sizeof(GLfloat), &current[first] );
+		bindBuffer( GL_ARRAY_BUFFER, 0 );
+	}
+}
+
+// Bind a buffer and return the pointer to pass to the gl*Pointer functions
+const GLvoid * GeometryBuffer::bind( int buffer ) {
+	if( mBuffers[buffer] ) {
+		bindBuffer( GL_ARRAY_BUFFER, mBuffers[buffer] );
+		return 0;
+	}
+	return &(mArrays[buffer][0]);
+}
+
+void GeometryBuffer::renderFaces( DLFLObjectPtr obj, const GeometryRenderer& gr ) {
+	update( obj, gr );
+
+	glPushMatrix( ); {
+		transform( obj );
+		if( !mArrays[Positions].empty() ) {
+			glPushClientAttrib( GL_CLIENT_VERTEX_ARRAY_BIT );
+			glEnableClientState( GL_VERTEX_ARRAY );
+			glVertexPointer( 3, GL_FLOAT, 0, bind( Positions ) );
+			if( !mArrays[Normals].empty() ) {
+				glEnableClientState( GL_NORMAL_ARRAY );
+				glNormalPointer( GL_FLOAT, 0, bind( Normals ) );
+			}
+			if( !mArrays[Colors].empty() ) {
+				glEnableClientState( GL_COLOR_ARRAY );
+				glColorPointer( 4, GL_FLOAT, 0, bind( Colors ) );
+			}
+			if( !mArrays[TexCoords].empty() ) {
+				glEnableClientState( GL_TEXTURE_COORD_ARRAY );
+				glTexCoordPointer( 2, GL_FLOAT, 0, bind( TexCoords ) );
+			}
+			if( mBuffers[Positions] ) bindBuffer( GL_ARRAY_BUFFER, 0 );
+
+			vector<Group>::iterator it;
+			for( it = mGroups.begin(); it != mGroups.end(); it++ ) {
+				#ifdef GPU_OK
+				if( gr.useGPU ) {
+					DLFLMaterialPtr mat = it->material;
+					cgSetParameter3f(CgData::instance()->basecolor, mat->color.r, mat->color.g, mat->color.b);
+					cgSetParameter3f(CgData::instance()->Ka, mat->Ka, mat->Ka, mat->Ka);
+					cgSetParameter3f(CgData::instance()->Kd, mat->Kd, mat->Kd, mat->Kd);
+					cgSetParameter3f(CgData::instance()->Ks, mat->Ks, mat->Ks, mat->Ks);
+					cgSetParameter1f(CgData::instance()->shininess, 50);
+				}
+				#endif
+				glDrawArrays( GL_TRIANGLES, it->first, it->count );
+			}
+			glPopClientAttrib( );
+		}
+
+		// Points and lines
+		DLFLFacePtrArray::iterator fp_it;
+		for( fp_it = mOthers.begin(); fp_it != mOthers.end(); fp_it++ )
+			gr.renderFace( *fp_it );
+	} glPopMatrix( );
+}
+
+void GeometryBuffer::renderEdges( DLFLObjectPtr obj, const GeometryRenderer& gr ) {
+	update( obj, gr );
+	if( mArrays[Edges].empty() ) return;
+	glPushClientAttrib( GL_CLIENT_VERTEX_ARRAY_BIT );
+	glEnableClientState( GL_VERTEX_ARRAY );
+	glVertexPointer( 3, GL_FLOAT, 0, bind( Edges ) );
+	if( mBuffers[Edges] ) bindBuffer( GL_ARRAY_BUFFER, 0 );
+	glDrawArrays( GL_LINES, 0, mArrays[Edges].size() / 3 );
+	glPopClientAttrib( );
+}
+
+/*!
+@}
+*/
@@ -0,0 +1,96 @@
+/*
+*
+* ***** BEGIN GPL LICENSE BLOCK *****
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software  Foundation,
+* Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*
+* The Original Code is Copyright (C) 2005 by xxxxxxxxxxxxxx
+* All rights reserved.
+*
+* The Original Code is: all of this file.
+*
+* Contributor(s): none yet.
+*
+* ***** END GPL LICENSE BLOCK *****
+*/
+
+#ifndef _GEOMETRY_BUFFER_H_
+#define _GEOMETRY_BUFFER_H_
+
+#ifdef __APPLE__
+#include <OpenGL/gl.h>
+#else
+#include <GL/gl.h>
+#endif
+
+#include <DLFLObject.hh>
+
+using namespace DLFL;
+
+/*!
+	\file GeometryBuffer.hh
+	\brief Definition of the GeometryBuffer class
+	
+	\see GeometryBuffer
+*/
+
+class GeometryRenderer;
+
+class GeometryBuffer {
+public :
+  GeometryBuffer( );
+  ~GeometryBuffer( );
+
+  // Mark the buffers as out of date. They are repacked before the next draw and only
+  // the ranges which actually changed are sent to the GPU
+  void invalidate( ) { mDirty = true; };
+
+  // Draw the faces of the object as triangles, one draw call per material.
+  // Faces with less than 3 corners are drawn through the renderer as before
+  void renderFaces( DLFLObjectPtr obj, const GeometryRenderer& gr );
+  // Draw the edges of the object as lines. The object transformation is not applied
+  void renderEdges( DLFLObjectPtr obj, const GeometryRenderer& gr );
+
+private :
+  enum { Positions=0, Normals, Colors, TexCoords, Edges, NumBuffers };
+
+  // Range of triangle vertices sharing a material
+  struct Group {
+    DLFLMaterialPtr material;
+    GLint first;
+    GLsizei count;
+  };
+
+  typedef vector<GLfloat> FloatArray;
+
+  void update( DLFLObjectPtr obj, const GeometryRenderer& gr );
+  void pack( DLFLObjectPtr obj, const GeometryRenderer& gr, FloatArray *arrays );
+  void upload( int buffer, FloatArray& packed );
+  const GLvoid * bind( int buffer );
+
+  DLFLObjectPtr mObject;                         // Object the buffers were built for
+  bool mDirty;                                   // Buffers have to be repacked
+  uint mTopologyStamp, mAttributeStamp;         // Stamps of the object when packed
+  GLdouble mColorKey[4];                         // Render color used for the colors
+  int mMode;                                     // Renderer flags used for the arrays
+
+  vector<Group> mGroups;                         // Triangles for each material
+  DLFLFacePtrArray mOthers;                      // Points and lines, drawn as before
+
+  FloatArray mArrays[NumBuffers];                // Copies of the data in the buffers
+  GLuint mBuffers[NumBuffers];                   // Buffer objects, 0 if not supported
+};
+
+#endif // _GEOMETRY_BUFFER_H_
@@ -54,6 +54,11 @@ static void transform( DLFLObjectPtr obj ) {
 
 void GeometryRenderer::render( DLFLObjectPtr obj ) const {
 	// std::cout << "usegpu  = " << useGPU << "\n";
+	if( !useOutline ) {
+		mBuffer->renderFaces( obj, *this );
+		return;
+	}
+	// Outlines are drawn one face at a time
 	DLFLMaterialPtrList::iterator mp_it;
 	DLFLFacePtrList::iterator fp_it;
 	glPushMatrix( ); {
@@ -164,16 +169,11 @@ void GeometryRenderer::renderVertices( DLFLObjectPtr obj, double size ) const {
 }
 
 void GeometryRenderer::renderEdges( DLFLObjectPtr obj, double width ) const {
-	DLFLEdgePtrList::iterator it;
 // Just render all the edges with specified line width
 	glPushMatrix(); {
 		transform( obj );
 		glLineWidth( width );
-		glBegin(GL_LINES);
-		for( it = obj->beginEdge(); it != obj->endEdge(); it++ ) {
-			renderEdge( *it );
-		}
-		glEnd();
+		mBuffer->renderEdges( obj, *this );
 		glLineWidth(1.0);
 		glPopMatrix();
 	}
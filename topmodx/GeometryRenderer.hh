@@ -31,6 +31,7 @@
 
 #include <DLFLObject.hh>
 #include "CgData.hh"
+#include "GeometryBuffer.hh"
 
 
 #ifdef GPU_OK
@@ -51,12 +52,16 @@ public :
   /** Singleton Methods **/
   //static GeometryRenderer& instance( );
   static GeometryRenderer* instance( );
-  ~GeometryRenderer( ) { delete renderColor; renderColor = 0; };
+  ~GeometryRenderer( ) { delete renderColor; renderColor = 0; delete mBuffer; };
 
   //void setObject( DLFLObjectPtr obj ) { mObj = obj; };
   static void glBeginFace( int num, bool outline = false );
 
   void render( DLFLObjectPtr obj ) const;
+  // The object is drawn from vertex arrays which are rebuilt when the topology or
+  // the attributes of the object change (see DLFLObject::attributesChanged).
+  // Call this after moving vertices
+  void invalidate( ) { mBuffer->invalidate(); };
   void renderFace( DLFLFacePtr dfp, bool useAttrs = true ) const;
   void renderFaceVertex( DLFLFaceVertexPtr dfvp, bool useAttrs = true ) const;
   void renderEdge( DLFLEdgePtr dep ) const;
@@ -92,6 +97,7 @@ public :
 
 private :
   //DLFLObjectPtr mObj;
+  GeometryBuffer *mBuffer;                       // Packed faces and edges of the object
 
   static GeometryRenderer *mInstance;
   GeometryRenderer( bool gpu = false) : useMaterial(false), useColorable(false), useLighting(false), 
@@ -100,6 +106,7 @@ private :
 							drawSilhouette(false),drawWireframe(true),
 				       drawFaceNormals(false), isReversed(false), useGPU(gpu) {
     renderColor = new GLdouble[4];
+    mBuffer = new GeometryBuffer;
   };
 };
 
@@ -213,10 +213,6 @@ bool MainWindow::deselect_edges = false;
 bool MainWindow::deselect_faces = false;
 bool MainWindow::deselect_faceverts = false;
 
-// for face loop selection 
-DLFLEdgePtr MainWindow::face_loop_start_edge = NULL;
-DLFLEdgePtr MainWindow::edge_ring_start_edge = NULL;
-
 //incremental save...
 int MainWindow::incremental_save_count = 0;
 
@@ -228,7 +224,7 @@ QColor MainWindow::paint_bucket_color = QColor(0.5,0.5,0.5);
  * asdflkjasdf
  * asdfl;jkas;df
  **/
-MainWindow::MainWindow(char *filename) : object(), mode(NormalMode), undoList(), undoMtlList(), redoList(), redoMtlList(), 
+MainWindow::MainWindow(char *filename) : object(), mode(NormalMode), undoList(), redoList(), 
 																				 undolimit(20), useUndo(true), mIsModified(false), mIsPrimitive(false), mWasPrimitive(false), mSpinBoxMode(None) {
 																					
 																					
@@ -315,6 +311,9 @@ MainWindow::MainWindow(char *filename) : object(), mode(NormalMode), undoList(),
 	connect( mScriptEditor, SIGNAL(cmdExecuted()), this, SLOT(recomputeAll()) );
 	connect( mScriptEditor, SIGNAL(cmdExecuted()), this->getActive(), SLOT(update()) );
 	connect( mScriptEditor, SIGNAL(requestObject(QString)), this, SLOT(openFile(QString)) );
+	connect( mScriptEditor, SIGNAL(scriptStarted()), this, SLOT(beginScript()) );
+	connect( mScriptEditor, SIGNAL(viewChanged()), this, SLOT(refreshScriptView()) );
+	connect( mScriptEditor, SIGNAL(scriptFinished()), this, SLOT(endScript()) );
 
 	if( !Py_IsInitialized() )
 		Py_Initialize( );
@@ -1947,6 +1946,7 @@ void MainWindow::newFile(){
 	
 	if (maybeSave()){
 		clearUndoList();
+		clearRedoList();
 		object.destroy();
 		active->redraw();
   	}
@@ -2119,7 +2119,12 @@ void MainWindow::setUndoLimit(int limit) {
 }
 
 void MainWindow::toggleUndo(void) {
-	if ( useUndo ) useUndo = false;
+	if ( useUndo ) {
+		// Journals can't follow changes made while undo is off
+		snapshotUndoJournals();
+		snapshotRedoJournals();
+		useUndo = false;
+	}
 	else useUndo = true;
 }
 
@@ -2227,6 +2232,8 @@ void MainWindow::doDrag(int x, int y) { // brianb
 					}
 
 				vptr->setCoords(Vector3d(obj_world[0],obj_world[1],obj_world[2]));
+				GeometryRenderer::instance()->invalidate();
+				DLFLPicker::instance()->invalidate();
 
 				// Reset drag start points
 				startDrag(drag_endx,drag_endy);
@@ -2425,15 +2432,10 @@ void MainWindow::doSelection(int x, int y) {
 		septr = active->selectEdge(x,y);
 		if (septr && QApplication::keyboardModifiers() == Qt::ControlModifier && active->isSelected(septr)){
 			deselect_edges = true;
-			active->clearSelectedEdge(septr);
-			num_sel_edges--;
 			getEdgeLoopSelection(septr);
 			deselect_edges = false;
 		}
 		else if ( septr && !active->isSelected(septr)){
-			// active->setSelectedEdge(num_sel_edges,septr);
-			active->setSelectedEdge(septr);
-			num_sel_edges++;
 			getEdgeLoopSelection(septr);
 		}
 		active->redraw();
@@ -2605,12 +2607,10 @@ void MainWindow::doSelection(int x, int y) {
 		active->setSelectedEdge(septr);
 		if ( septr ){
 			if (QApplication::keyboardModifiers() == Qt::ControlModifier){ // deselect
-				face_loop_start_edge = septr;
-				getFaceLoopSelection(septr, true, NULL, false);
+				getFaceLoopSelection(septr, false);
 			}
 			else { //select
-				face_loop_start_edge = septr;
-				getFaceLoopSelection(septr, true, NULL, true);
+				getFaceLoopSelection(septr, true);
 			}
 		}
 		active->redraw();
@@ -2623,12 +2623,10 @@ void MainWindow::doSelection(int x, int y) {
 		active->setSelectedEdge(septr);
 		if ( septr ){
 			if (QApplication::keyboardModifiers() == Qt::ControlModifier){ // deselect
-				edge_ring_start_edge = septr;
-				getEdgeRingSelection(septr, true, NULL, false);
+				getEdgeRingSelection(septr, false);
 			}
 			else { //select
-				edge_ring_start_edge = septr;
-				getEdgeRingSelection(septr, true, NULL, true);
+				getEdgeRingSelection(septr, true);
 			}
 		}
 		active->redraw();
@@ -2670,13 +2668,11 @@ void MainWindow::doSelection(int x, int y) {
 		//get one selected face
 		sfptr = active->selectFace(x,y);
 		if (sfptr && active->isSelected(sfptr) && QApplication::keyboardModifiers() == Qt::ControlModifier){
-			active->clearSelectedFace(sfptr);
-			num_sel_faces--;
+			deselect_faces = true;
 			getCheckerboardSelection(sfptr);
+			deselect_faces = false;
 		}
 		else if (sfptr && !active->isSelected(sfptr) ){
-			active->setSelectedFace(sfptr);
-			num_sel_faces++;
 			getCheckerboardSelection(sfptr);
 		}		
 		active->redraw();
@@ -3071,12 +3067,10 @@ void MainWindow::mouseReleaseEvent(QMouseEvent *event)  {
 						DLFLEdgePtr septr = active->getSelectedEdge(0);
 						if (septr){
 							if (QApplication::keyboardModifiers() == Qt::ControlModifier){ // deselect
-								edge_ring_start_edge = septr;
-								getEdgeRingSelection(septr, true, NULL, false);
+								getEdgeRingSelection(septr, false);
 							}
 							else { //select
-								edge_ring_start_edge = septr;
-								getEdgeRingSelection(septr, true, NULL, true);
+								getEdgeRingSelection(septr, true);
 							}
 						}
 					}
@@ -3087,12 +3081,10 @@ void MainWindow::mouseReleaseEvent(QMouseEvent *event)  {
 						DLFLEdgePtr septr = active->getSelectedEdge(0);
 						if (septr){
 							if (QApplication::keyboardModifiers() == Qt::ControlModifier){ // deselect
-								face_loop_start_edge = septr;
-								getFaceLoopSelection(septr, true, NULL, false);
+								getFaceLoopSelection(septr, false);
 							}
 							else { //select
-								face_loop_start_edge = septr;
-								getFaceLoopSelection(septr, true, NULL, true);
+								getFaceLoopSelection(septr, true);
 							}
 						}
 					}
@@ -3115,6 +3107,7 @@ void MainWindow::mouseReleaseEvent(QMouseEvent *event)  {
 						// first search for the material in the existing list
 						// DLFLMaterialPtr m = object.findMaterial(RGBColor(paint_bucket_color.redF(),paint_bucket_color.greenF(),paint_bucket_color.blueF() ));
 						fp->setMaterial(object.addMaterial(RGBColor(paint_bucket_color.redF(),paint_bucket_color.greenF(),paint_bucket_color.blueF())) );
+						object.attributesChanged();
 						// if ( m ){
 						// 	
 						// }
@@ -3228,8 +3221,9 @@ void MainWindow::mouseReleaseEvent(QMouseEvent *event)  {
 							if ( sfvptr1 && sfvptr2 )
 								{
 									DLFLMaterialPtr mptr = sfvptr1->getFacePtr()->material();
-									undoPush();
+									undoPushJournal();
 									setModified(true);
+									object.trackChanges();
 #if WITH_PYTHON
 									cmd = QString( "insertEdge((" );
 									cmd += QString().setNum(sfvptr1->getFaceID()) + QString(",");
@@ -3238,12 +3232,15 @@ void MainWindow::mouseReleaseEvent(QMouseEvent *event)  {
 									cmd += QString().setNum(sfvptr2->getVertexID()) + QString("))");
 									emit echoCommand(cmd);
 									if( Py_IsInitialized() ) {
+										PyGILState_STATE gstate = PyGILState_Ensure();
 										PyRun_SimpleString( "from dlfl import *");
 										PyRun_SimpleString( cmd.toLocal8Bit().constData() );
+										PyGILState_Release(gstate);
 									}
 #else
 									DLFL::insertEdge(&object,sfvptr1,sfvptr2,false,mptr);
 #endif
+									object.detachJournal();
 									active->clearSelectedFaces();
 									active->clearSelectedCorners();
 									num_sel_faceverts = 0; // num_sel_faces = 0;
@@ -3263,14 +3260,16 @@ void MainWindow::mouseReleaseEvent(QMouseEvent *event)  {
 							DLFLEdgePtr septr = active->getSelectedEdge(0);
 							if ( septr )
 								{
-									undoPush();
+									undoPushJournal();
 									setModified(true);
 #if WITH_PYTHON
 									cmd = QString( "deleteEdge(" );
 									cmd += QString().setNum(septr->getID()) + QString(")");
 									emit echoCommand(cmd);
 #endif
+									object.trackChanges();
 									DLFL::deleteEdge( &object, septr, MainWindow::delete_edge_cleanup);
+									object.detachJournal();
 									active->recomputePatches();
 									active->recomputeNormals();
 								}
@@ -3284,14 +3283,16 @@ void MainWindow::mouseReleaseEvent(QMouseEvent *event)  {
 							DLFLEdgePtr septr = active->getSelectedEdge(0);
 							if ( septr )
 								{
-									undoPush();
+									undoPushJournal();
 									setModified(true);
 #if WITH_PYTHON
 									cmd = QString( "subdivideEdge(" );
 									cmd += QString().setNum(septr->getID()) + QString(")");
 									emit echoCommand(cmd);
 #endif
+									object.trackChanges();
 									DLFL::subdivideEdge(&object, num_e_subdivs,septr);
+									object.detachJournal();
 									active->recomputePatches();
 									active->recomputeNormals();
 								}
@@ -3305,14 +3306,16 @@ void MainWindow::mouseReleaseEvent(QMouseEvent *event)  {
 							DLFLEdgePtr septr = active->getSelectedEdge(0);
 							if ( septr )
 								{
-									undoPush();
+									undoPushJournal();
 									setModified(true);
 #if WITH_PYTHON
 									cmd = QString( "collapseEdge(" );
 									cmd += QString().setNum(septr->getID()) + QString(")");
 									emit echoCommand(cmd);
 #endif
+									object.trackChanges();
 									DLFL::collapseEdge(&object,septr);
+									object.detachJournal();
 									active->recomputePatches();
 									active->recomputeNormals();
 								}
@@ -3329,10 +3332,12 @@ void MainWindow::mouseReleaseEvent(QMouseEvent *event)  {
 							if ( sfvptr1 && sfvptr2 )
 								{
 									DLFLMaterialPtr mptr = sfvptr1->getFacePtr()->material();
-									undoPush();
+									undoPushJournal();
 									setModified(true);
 									//object.spliceCorners(sfvptr1,sfvptr2);
+									object.trackChanges();
 									DLFL::spliceCorners(&object,sfvptr1,sfvptr2);
+									object.detachJournal();
 									active->clearSelectedFaces();
 									active->clearSelectedCorners();
 									num_sel_faceverts = 0; num_sel_faces = 0;
@@ -3426,6 +3431,7 @@ void MainWindow::mouseReleaseEvent(QMouseEvent *event)  {
 								{
 									undoPush();
 									setModified(true);
+									object.trackChanges();
 									DLFL::extrudeFace(&object,sfptr,extrude_dist,num_extrusions,extrude_rot,extrude_scale);
 									active->recomputePatches();
 									active->recomputeNormals();
@@ -3465,6 +3471,7 @@ void MainWindow::mouseReleaseEvent(QMouseEvent *event)  {
 								{
 									undoPush();
 									setModified(true);
+									object.trackChanges();
 									DLFL::extrudeFaceDS(&object,sfptr,extrude_dist,num_extrusions, ds_ex_twist,extrude_scale);
 									active->recomputePatches();
 									active->recomputeNormals();
@@ -3483,6 +3490,7 @@ void MainWindow::mouseReleaseEvent(QMouseEvent *event)  {
 								{
 									undoPush();
 									setModified(true);
+									object.trackChanges();
 									DLFL::extrudeDualFace(&object,sfptr,extrude_dist,num_extrusions, extrude_rot,extrude_scale, dual_mesh_edges_check);
 									active->recomputePatches();
 									active->recomputeNormals();
@@ -3539,6 +3547,7 @@ void MainWindow::mouseReleaseEvent(QMouseEvent *event)  {
 								{
 									undoPush();
 									setModified(true);
+									object.trackChanges();
 									DLFL::stellateFace(&object,sfptr,extrude_dist);
 									active->recomputePatches();
 									active->recomputeNormals();
@@ -3557,6 +3566,7 @@ void MainWindow::mouseReleaseEvent(QMouseEvent *event)  {
 								{
 									undoPush();
 									setModified(true);
+									object.trackChanges();
 									DLFL::doubleStellateFace(&object,sfptr,extrude_dist);
 									active->recomputePatches();
 									active->recomputeNormals();
@@ -4392,6 +4402,12 @@ void MainWindow::setRemeshingScheme(RemeshingScheme scheme) {
 // Read the DLFL object from a file
 void MainWindow::readObject(const char * filename, const char *mtlfilename) {
 	active->clearSelected();
+	dropUndoJournals();
+	// Binary files carry their own materials and are memory mapped
+	if ( strstr(filename,".dlfb") || strstr(filename,".DLFB") ) {
+		object.readDLFB(filename);
+		return;
+	}
 	ifstream file, mtlfile;
 	file.open(filename);
 	mtlfile.open(mtlfilename);
@@ -4406,6 +4422,7 @@ void MainWindow::readObject(const char * filename, const char *mtlfilename) {
 // Read the DLFL object from a file
 void MainWindow::readObjectQFile(QString filename) {
 	active->clearSelected();
+	dropUndoJournals();
 	QFile file(filename);
 	file.open(QIODevice::ReadOnly);
 
@@ -4417,7 +4434,9 @@ void MainWindow::readObjectQFile(QString filename) {
 	ifstream mtlfile;
 	// mtlfile = 0;
 
-	if ( filename.indexOf(".dlfl") == filename.length()-4 || filename.indexOf(".dlfl") == filename.length()-4 )
+	if ( filename.endsWith(".dlfb",Qt::CaseInsensitive) )
+		object.readDLFBMemory(ba.constData(), ba.size());
+	else if ( filename.indexOf(".dlfl") == filename.length()-4 || filename.indexOf(".dlfl") == filename.length()-4 )
 		object.readDLFL(filestring, mtlfile);
 	else if ( filename.indexOf(".OBJ") == filename.length()-4 || filename.indexOf(".obj") == filename.length()-4 )
 		object.readObject(filestring, mtlfile);
@@ -4447,6 +4466,12 @@ void MainWindow::readObjectAlt(const char * filename) {
 
 // Write the DLFL object to a file
 void MainWindow::writeObject(const char * filename, const char* mtlfilename, bool with_normals, bool with_tex_coords) {
+	if ( strstr(filename,".dlfb") || strstr(filename,".DLFB") ) {
+		ofstream file(filename, ios::out | ios::binary);
+		object.writeDLFB(file);
+		file.close();
+		return;
+	}
 	ofstream file;
 	ofstream mtlfile;
 	file.open(filename);
@@ -4508,7 +4533,7 @@ void MainWindow::writeSTL( const char *filename) {
 // File handling
 void MainWindow::openFile(void) {
 	QString fileName = QFileDialog::getOpenFileName(this, tr("Open File..."),
-																									mSaveDirectory, tr("All Supported Files (*.obj *.dlfl);;Wavefront OBJ Files (*.obj);;DLFL Files (*.dlfl);;All Files (*)"),
+																									mSaveDirectory, tr("All Supported Files (*.obj *.dlfl *.dlfb);;Wavefront OBJ Files (*.obj);;DLFL Files (*.dlfl);;DLFL Binary Files (*.dlfb);;All Files (*)"),
 																									0, QFileDialog::DontUseSheet);
 	if (!fileName.isEmpty()){
 		if (!curFile.isEmpty()){
@@ -4596,7 +4621,7 @@ bool MainWindow::saveFile(bool with_normals, bool with_tex_coords) {
 			QString fileName = QFileDialog::getSaveFileName(this,
 																											tr("Save File As..."),
 																											mSaveDirectory + "/" + curFileTemp,
-																											tr("All Supported Files (*.obj *.dlfl);;Wavefront OBJ Files (*.obj);;DLFL Files (*.dlfl);;All Files (*)"),
+																											tr("All Supported Files (*.obj *.dlfl *.dlfb);;Wavefront OBJ Files (*.obj);;DLFL Files (*.dlfl);;DLFL Binary Files (*.dlfb);;All Files (*)"),
 																											0, QFileDialog::DontUseSheet);
 			if (!fileName.isEmpty()){
 				//for incremental save test - dave
@@ -4649,7 +4674,7 @@ bool MainWindow::saveFileAs(bool with_normals, bool with_tex_coords) {
 	QString fileName = QFileDialog::getSaveFileName(this,
 																									tr("Save File As..."),
 																									mSaveDirectory + "/" + curFile,
-																									tr("All Supported Files (*.obj *.dlfl);;Wavefront OBJ Files (*.obj);;DLFL Files (*.dlfl);;All Files (*)"),
+																									tr("All Supported Files (*.obj *.dlfl *.dlfb);;Wavefront OBJ Files (*.obj);;DLFL Files (*.dlfl);;DLFL Binary Files (*.dlfb);;All Files (*)"),
 																									0, QFileDialog::DontUseSheet );
 	if (!fileName.isEmpty()){
 		//reset the incremental save count no matter what...?
@@ -4977,161 +5002,69 @@ void MainWindow::switchBackView(){
 	active->redraw();
 }
 
-//recurse through selected faces to get a list of checkerboard selection for the entire object
+//select or deselect the checkerboard pattern of faces through the given face
 void MainWindow::getCheckerboardSelection(DLFLFacePtr fptr) {
 	if (fptr){
-		int numShared = 0;
 		DLFLFacePtrArray fparray;
-		vector<DLFLFacePtr>::iterator it;
-		fptr->getNeighboringFaces(fparray);
-		for ( it = fparray.begin(); it != fparray.end(); it++){
-			if (fptr->sharesOneVertex((*it)) && !active->isSelected(*it)){
-				numShared++;
-				if (deselect_edges){
-					active->clearSelectedFace(*it);
-					num_sel_faces--;
-				}
-				else {
-					active->setSelectedFace(*it);
-					num_sel_faces++;					
-				}
-				getCheckerboardSelection((*it));
-			}
-		}//end for loop
-		if (numShared == 0) return; //break out of recursive loop is there are no one vertex sharing faces
-	}		
+		mTraversal.checkerboard(&object,fptr,fparray);
+		selectFaces(fparray, !deselect_faces);
+	}
 }
 
-//recurse through selected edge to get a list of 
+//select or deselect the edge loop through the given edge
 void MainWindow::getEdgeLoopSelection(DLFLEdgePtr eptr) {
 	if (eptr){
-		//first check to see if edge only connects to only three other edges
-		DLFLVertexPtr vp1, vp2;
 		DLFLEdgePtrArray eparray;
-		vector<DLFLEdgePtr>::iterator it;
-		eptr->getVertexPointers(vp1,vp2);
-		if (vp1->valence() == 4 && vp2->valence() == 4){
-			//get edges conected to vertex 1
-			eparray.clear();
-			vp1->getEdges(eparray);
-			//loop through them to find the one that doesn't share a face
-			for (it = eparray.begin(); it != eparray.end(); it++){
-				if ( !coFacial(*it,eptr) ){
-					if (deselect_edges){
-						active->clearSelectedEdge(*it);
-						num_sel_edges--;
-						getEdgeLoopSelection(*it);
-					}
-					else if (!active->isSelected(*it)){
-						active->setSelectedEdge(*it);
-						num_sel_edges++;
-						getEdgeLoopSelection(*it);
-					}
-				}
-			}//end for loop
-			//get edges conected to vertex 2
-			eparray.clear();
-			vp2->getEdges(eparray);
-			//loop through them to find the one that doesn't share a face
-			for (it = eparray.begin(); it != eparray.end(); it++){
-				if ( !coFacial(*it,eptr) ){
-					if (deselect_edges){
-						active->clearSelectedEdge(*it);
-						num_sel_edges--;
-						getEdgeLoopSelection(*it);
-					}
-					else if (!active->isSelected(*it)){
-						active->setSelectedEdge(*it);
-						num_sel_edges++;
-						getEdgeLoopSelection(*it);
-					}
-				}
-			}//end for loop
-			return;
-		}//end if vp->valence
-		return;
-	}	
+		mTraversal.edgeLoop(&object,eptr,eparray);
+		selectEdges(eparray, !deselect_edges);
+	}
 }
 
-//recurse through selected edge to get a list of 
-void MainWindow::getFaceLoopSelection(DLFLEdgePtr eptr, bool start, DLFLFacePtr face_loop_marker, bool select_face_loop) {
-	if ( (eptr == face_loop_start_edge) && !start) 
-		return;
+//select or deselect the quads of the face loop across the given edge
+void MainWindow::getFaceLoopSelection(DLFLEdgePtr eptr, bool select_face_loop) {
+	if (eptr){
+		DLFLFacePtrArray fparray;
+		mTraversal.faceLoop(&object,eptr,fparray);
+		selectFaces(fparray, select_face_loop);
+	}
+}
 
-	int idx = 0;
-	DLFLEdgePtrArray edges;
-	vector<DLFLEdgePtr>::iterator it;
-	DLFLFacePtr fptr1, fptr2;
-	//get the two faces corresponding to this edge ptr
-	eptr->getFacePointers(fptr1,fptr2);
-	//check if the two faces are quads
-	if (fptr1 && fptr1->numFaceVertexes() == 4 && !(fptr1 == face_loop_marker) ){
-		if (!active->isSelected(fptr1)){
-			active->setSelectedFace(num_sel_faces,fptr1);
-			num_sel_faces++;
-		}
-		fptr1->getEdges(edges);
-		idx =0;
-		for (it = edges.begin(); it != edges.end(); it++){
-			if (*it == eptr){
-				getFaceLoopSelection(edges[(idx+2)%4],false,fptr1, select_face_loop);
-			}
-			idx++;
-		}//end for loop
+//select or deselect the edge ring through the given edge
+void MainWindow::getEdgeRingSelection(DLFLEdgePtr eptr, bool select_edge_ring) {
+	if (eptr){
+		DLFLEdgePtrArray eparray;
+		mTraversal.edgeRing(&object,eptr,eparray);
+		selectEdges(eparray, select_edge_ring);
 	}
-	if (fptr2 && fptr2->numFaceVertexes() == 4 && !(fptr2 == face_loop_marker) ){
-		if (!active->isSelected(fptr2)){
-			active->setSelectedFace(num_sel_faces,fptr2);
-			num_sel_faces++;
+}
+
+//add the edges to the selection, or remove them from it
+void MainWindow::selectEdges(const DLFLEdgePtrArray& eparray, bool select) {
+	vector<DLFLEdgePtr>::const_iterator it;
+	for (it = eparray.begin(); it != eparray.end(); it++){
+		if (select && !active->isSelected(*it)){
+			active->setSelectedEdge(*it);
+			num_sel_edges++;
+		}
+		else if (!select && active->isSelected(*it)){
+			active->clearSelectedEdge(*it);
+			num_sel_edges--;
 		}
-		fptr2->getEdges(edges);
-		idx =0;
-		for (it = edges.begin(); it != edges.end(); it++){
-			if (*it == eptr){
-				getFaceLoopSelection(edges[(idx+2)%4], false, fptr2, select_face_loop);
-				// return;
-			}
-			idx++;
-		}//end for loop
 	}
 }
 
-//recurse through selected edge to get a list of 
-void MainWindow::getEdgeRingSelection(DLFLEdgePtr eptr, bool start, DLFLFacePtr face_loop_marker, bool select_face_loop) {
-	if ( (eptr == edge_ring_start_edge) && !start) 
-		return;
-
-	int idx = 0;
-	DLFLEdgePtrArray edges;
-	vector<DLFLEdgePtr>::iterator it;
-	DLFLFacePtr fptr1, fptr2;
-	if (!active->isSelected(eptr)){
-		active->setSelectedEdge(eptr);
-		num_sel_edges++;
-	}
-	//get the two faces corresponding to this edge ptr
-	eptr->getFacePointers(fptr1,fptr2);
-	//check if the two faces are quads
-	if (fptr1 && fptr1->numFaceVertexes() == 4 && !(fptr1 == face_loop_marker) ){
-		fptr1->getEdges(edges);
-		idx =0;
-		for (it = edges.begin(); it != edges.end(); it++){
-			if (*it == eptr){
-				getEdgeRingSelection(edges[(idx+2)%4],false,fptr1, select_face_loop);
-			}
-			idx++;
-		}//end for loop
-	}
-	if (fptr2 && fptr2->numFaceVertexes() == 4 && !(fptr2 == face_loop_marker) ){
-		fptr2->getEdges(edges);
-		idx =0;
-		for (it = edges.begin(); it != edges.end(); it++){
-			if (*it == eptr){
-				getEdgeRingSelection(edges[(idx+2)%4], false, fptr2, select_face_loop);
-				// return;
-			}
-			idx++;
-		}//end for loop
+//add the faces to the selection, or remove them from it
+void MainWindow::selectFaces(const DLFLFacePtrArray& fparray, bool select) {
+	vector<DLFLFacePtr>::const_iterator it;
+	for (it = fparray.begin(); it != fparray.end(); it++){
+		if (select && !active->isSelected(*it)){
+			active->setSelectedFace(*it);
+			num_sel_faces++;
+		}
+		else if (!select && active->isSelected(*it)){
+			active->clearSelectedFace(*it);
+			num_sel_faces--;
+		}
 	}
 }
 
@@ -67,7 +67,10 @@
 #endif
 
 #include "DLFLLighting.hh"
+#include "OperatorThread.hh"
 #include <DLFLObject.hh>
+#include <DLFLJournal.hh>
+#include <DLFLTraversal.hh>
 #include <DLFLConvexHull.hh>
 
 #include "include/WireframeRenderer.hh"
@@ -94,6 +97,19 @@
 typedef StringStream * StringStreamPtr;
 typedef list<StringStreamPtr> StringStreamPtrList;
 
+// Entry on the undo/redo lists. Either a snapshot of the whole object in binary DLFL
+// format or a journal of the changes made by a single operation
+struct UndoState {
+	StringStreamPtr obj;                    // Object and materials in DLFB format
+	DLFL::DLFLJournalPtr journal;           // Changes made by the operation
+
+	UndoState() : obj(NULL), journal(NULL) {}
+	~UndoState() { delete obj; delete journal; }
+};
+
+typedef UndoState * UndoStatePtr;
+typedef list<UndoStatePtr> UndoStatePtrList;
+
 class TopModPreferences;
 
 class BasicsMode;
@@ -420,8 +436,7 @@ protected :
 	static bool deselect_faces;
 	static bool deselect_faceverts;
 
-	static DLFLEdgePtr face_loop_start_edge; 						//!< face loop edge pointer
-	static DLFLEdgePtr edge_ring_start_edge; 						//!< edge ring edge pointer
+	DLFLTraversal mTraversal;														//!< scratch space for loop, ring and grow selections
 	static bool face_loop_start;												//!< face loop start
 
 	GLWidget *active;															     	//!< Active viewport to handle events
@@ -434,13 +449,19 @@ protected :
 	RemeshingScheme remeshingscheme;							//!< Current selected remeshing scheme
 	PointLight plight;														//!< Light used to compute lighting
 
-	StringStreamPtrList undoList;                 //!< List for Undo
-	StringStreamPtrList redoList;                 //!< List for Redo
-	StringStreamPtrList undoMtlList;                 //!< Mtl List for Undo
-	StringStreamPtrList redoMtlList;                 //!< Mtl List for Redo
+	UndoStatePtrList undoList;                    //!< List for Undo
+	UndoStatePtrList redoList;                    //!< List for Redo
 	int undolimit;                                //!< Limit for undo
 	bool useUndo;            											//!< Flag to indicate if undo will be used
 
+	//! Run an operator in a worker thread, showing its progress. The object is put on the
+	//! undo list first and restored if the operator is cancelled, in which case this returns false
+	bool runOperator(OperatorThread& op, const QString& label);
+
+#ifdef WITH_PYTHON
+	bool mScriptAutoSave;													//!< Autosave was on when the running script started
+#endif
+
 	void initialize(int x, int y, int w, int h, DLFLRendererPtr rp);	//!< Initialize the viewports, etc.
 
 	// brianb
@@ -506,10 +527,12 @@ public :
 		num_sel_faceverts = 0;
 	}
 	
-	void getCheckerboardSelection(DLFLFacePtr fptr);		//!< \todo  needs to be moved to DLFL namespace
-	void getEdgeLoopSelection(DLFLEdgePtr eptr);				//!< \todo  needs to be moved to DLFL namespace
-	void getFaceLoopSelection(DLFLEdgePtr eptr, bool start, DLFLFacePtr face_loop_marker, bool select_face_loop);	//!< \todo  needs to be moved to DLFL namespace
-	void getEdgeRingSelection(DLFLEdgePtr eptr, bool start, DLFLFacePtr face_loop_marker, bool select_face_loop);	//!< \todo  needs to be moved to DLFL namespace
+	void getCheckerboardSelection(DLFLFacePtr fptr);		//!< walks are done by DLFLTraversal
+	void getEdgeLoopSelection(DLFLEdgePtr eptr);
+	void getFaceLoopSelection(DLFLEdgePtr eptr, bool select_face_loop);
+	void getEdgeRingSelection(DLFLEdgePtr eptr, bool select_edge_ring);
+	void selectEdges(const DLFLEdgePtrArray& eparray, bool select);
+	void selectFaces(const DLFLFacePtrArray& fparray, bool select);
 
 	void createRenderers();															//!< allocate memory for the renderer pointers
 	void destroyRenderers();														//!< delete memory allcated for the renderer pointers
@@ -1148,6 +1171,12 @@ public slots:
 	void clearUndoList();      // Erase all elements on Undo list
 	void clearRedoList();      // Erase all elements on Redo list
 	void undoPush();         // Put current object onto undo list
+	void undoPushJournal();  // Record changes made by the next operation onto undo list
+	void snapshotUndoJournals(); // Replace journals on top of undo list with snapshots
+	void snapshotRedoJournals(); // Replace journals on top of redo list with snapshots
+	void dropUndoJournals();     // Remove journals from both lists when the object is replaced
+	void writeUndoState(UndoStatePtr state); // Store current object in a snapshot
+	void readUndoState(UndoStatePtr state);  // Replace current object with a snapshot
 	void undo();                           // Undo last operation
 	void redo();              // Redo previously undone operation
 
@@ -1184,6 +1213,10 @@ public slots:
 		active->recomputePatches();
 		active->recomputeNormals();
 	};
+	// a script is changing the object on its own thread, see DLFLScriptEditor
+	void beginScript();
+	void refreshScriptView();
+	void endScript();
 #endif
 
 	// void recomputeNormals();
@@ -38,6 +38,162 @@
 
 #include "MainWindow.hh"
 
+//-- Operators which can take long enough on a large object to need a worker thread --//
+
+class CatmullClarkOperator : public OperatorThread {
+public :
+	CatmullClarkOperator(DLFLObjectPtr obj) : OperatorThread(obj) { }
+protected :
+	void operate(DLFLObjectPtr obj) { DLFL::catmullClarkSubdivide(obj,this); }
+};
+
+class DooSabinOperator : public OperatorThread {
+public :
+	DooSabinOperator(DLFLObjectPtr obj, bool check) : OperatorThread(obj), mCheck(check) { }
+protected :
+	void operate(DLFLObjectPtr obj) { DLFL::dooSabinSubdivide(obj,mCheck,this); }
+	bool mCheck;
+};
+
+class SpongeOperator : public OperatorThread {
+public :
+	SpongeOperator(DLFLObjectPtr obj, double thickness, double threshold)
+		: OperatorThread(obj), mThickness(thickness), mThreshold(threshold) { }
+protected :
+	void operate(DLFLObjectPtr obj) { DLFL::createSponge(obj,mThickness,mThreshold,this); }
+	double mThickness, mThreshold;
+};
+
+class CrustOperator : public OperatorThread {
+public :
+	CrustOperator(DLFLObjectPtr obj, bool use_scaling, double scale_factor, double thickness)
+		: OperatorThread(obj), mUseScaling(use_scaling), mScaleFactor(scale_factor), mThickness(thickness) { }
+protected :
+	void operate(DLFLObjectPtr obj) {
+		if ( mUseScaling ) DLFL::createCrustWithScaling(obj,mScaleFactor,this);
+		else DLFL::createCrust(obj,mThickness,true,this);
+	}
+	bool mUseScaling;
+	double mScaleFactor, mThickness;
+};
+
+class CuttingOperator : public OperatorThread {
+public :
+	CuttingOperator(DLFLObjectPtr obj, MainWindow::SelectionMask mask, float offsetE, float offsetV, bool global)
+		: OperatorThread(obj), mMask(mask), mOffsetE(offsetE), mOffsetV(offsetV), mGlobal(global) { }
+protected :
+	void operate(DLFLObjectPtr obj) {
+		switch ( mMask ) {
+			case MainWindow::MaskEdges :
+			DLFL::cutSelectedEdges(obj,mOffsetE,mOffsetV,mGlobal,false,this);
+			break;
+			case MainWindow::MaskVertices :
+			DLFL::cutSelectedVertices(obj,mOffsetE,mOffsetV,mGlobal,false,this);
+			break;
+			case MainWindow::MaskFaces :
+			DLFL::cutSelectedFaces(obj,mOffsetE,mOffsetV,mGlobal,false,this);
+			break;
+			default :
+			break;
+		}
+	}
+	MainWindow::SelectionMask mMask;
+	float mOffsetE, mOffsetV;
+	bool mGlobal;
+};
+
+bool MainWindow::runOperator(OperatorThread& op, const QString& label)
+{
+	// Keep the object to restore if the operator is cancelled. This is the
+	// state put on the undo list, or a separate one if undo is off
+	UndoStatePtr rollback;
+	undoPush();
+	if ( useUndo ) rollback = undoList.back();
+	else {
+		rollback = new UndoState;
+		writeUndoState(rollback);
+	}
+
+	QProgressDialog progress(label, tr("Cancel"), 0, 0, this);
+	progress.setWindowModality(Qt::WindowModal);
+	progress.setAutoReset(false);
+	progress.setMinimumDuration(500);
+
+	// Nothing else may read the object until the operator is done
+	bool autosave = mAutoSaveTimer->isActive();
+	mAutoSaveTimer->stop();
+	active->setBusy(true);
+
+	QTime elapsed;
+	elapsed.start();
+	op.start();
+	while ( !op.wait(50) ) {
+		if ( progress.wasCanceled() && !op.wasCanceled() ) {
+			// The dialog hides when cancelled, but has to block the window
+			// until the operator gets to a point where it can stop
+			op.cancel();
+			progress.setLabelText(tr("Cancelling..."));
+			progress.setCancelButton(NULL);
+			progress.setRange(0,0);
+			progress.show();
+		} else if ( !op.wasCanceled() ) {
+			if ( !progress.isVisible() && elapsed.elapsed() > progress.minimumDuration() ) progress.show();
+			progress.setMaximum(op.getMaximum());
+			progress.setValue(op.getValue());
+		}
+		// Until the modal dialog is up user input would reach the window
+		if ( progress.isVisible() ) QApplication::processEvents();
+		else QApplication::processEvents(QEventLoop::ExcludeUserInputEvents);
+	}
+	progress.hide();
+
+	active->setBusy(false);
+	if ( autosave ) mAutoSaveTimer->start();
+
+	if ( op.wasCanceled() || op.failed() ) {
+		readUndoState(rollback);
+		if ( useUndo ) undoList.pop_back();
+		delete rollback;
+
+		active->recomputePatches();
+		active->recomputeNormals();
+		// Clear selection lists to avoid dangling pointers
+		MainWindow::clearSelected();
+		redraw();
+		if ( op.failed() )
+			QMessageBox::warning(this, tr("TopMod"), tr("%1 failed. The object has been restored.").arg(label));
+		return false;
+	}
+	if ( !useUndo ) delete rollback;
+	return true;
+}
+
+#ifdef WITH_PYTHON
+// A script runs on a thread of its own while the interface stays up, see
+// DLFLScriptEditor. Until it is done the viewport shows the last frame drawn,
+// and is only redrawn while the script waits for it between two of its lines
+void MainWindow::beginScript()
+{
+	mScriptAutoSave = mAutoSaveTimer->isActive();
+	mAutoSaveTimer->stop();
+	active->setBusy(true);
+}
+
+void MainWindow::refreshScriptView()
+{
+	active->setBusy(false);
+	recomputeAll();
+	redraw();
+	active->setBusy(true);
+}
+
+void MainWindow::endScript()
+{
+	active->setBusy(false);
+	if ( mScriptAutoSave ) mAutoSaveTimer->start();
+}
+#endif
+
 void MainWindow::load_texture() {
 	QString fileName = QFileDialog::getOpenFileName(this,
 		tr("Open File..."),
@@ -609,29 +765,11 @@ void MainWindow::performCutting() {
 	// DLFLVertexPtrArray vparray;
 	// DLFLEdgePtrArray fparray;
 
-	undoPush();
-	setModified(true);
 	// void performCutting( DLFLObjectPtr obj, int type,float offsetE,float offsetV,bool global,bool selected) {
 	// DLFL::performCutting(&object, MainWindow::mode,MainWindow::cutOffsetE_factor,MainWindow::cutOffsetV_factor,MainWindow::global_cut,MainWindow::selected_cut);
-	switch (selectionmask){
-		case MaskEdges:
-		// std::cout << "cut by edge!\n";
-		// active->getSelectedEdges(eparray);
-		DLFL::cutSelectedEdges(&object, MainWindow::cutOffsetE_factor,MainWindow::cutOffsetV_factor, MainWindow::global_cut);
-		break;
-		case MaskVertices:
-		// std::cout << "cut by vertex!\n";
-		// active->getSelectedVertices(vparray);
-		DLFL::cutSelectedVertices(&object, MainWindow::cutOffsetE_factor,MainWindow::cutOffsetV_factor, MainWindow::global_cut);
-		break;
-		case MaskFaces:
-		// std::cout << "cut by face!\n";
-		// active->getSelectedFaces(fparray);
-		DLFL::cutSelectedFaces(&object, MainWindow::cutOffsetE_factor,MainWindow::cutOffsetV_factor, MainWindow::global_cut);
-		break;
-		default:
-		break;
-	};
+	CuttingOperator op(&object, selectionmask, MainWindow::cutOffsetE_factor,MainWindow::cutOffsetV_factor, MainWindow::global_cut);
+	if ( !runOperator(op, tr("Cutting")) ) return;
+	setModified(true);
 	active->recomputePatches();
 	active->recomputeNormals();
 	MainWindow::clearSelected();
@@ -702,6 +840,7 @@ void MainWindow::paintSelectedFaces(){
 	for (int i=0; i < active->numSelectedFaces(); ++i)	{
 		active->getSelectedFace(i)->setMaterial(object.addMaterial(RGBColor(paint_bucket_color.redF(),paint_bucket_color.greenF(),paint_bucket_color.blueF())));
 	}
+	object.attributesChanged();
 	MainWindow::clearSelected();
 	active->recomputePatches();
 	active->recomputeNormals();
@@ -797,12 +936,13 @@ void MainWindow::subdivideAllEdges(void)              // Sub-divide all edges
 
 void MainWindow::subdivideSelectedEdges(void) // Subdivide all selected edges
 {
-	undoPush();
+	undoPushJournal();
 	// DLFLEdgePtrArray eparray;
 	// eparray.resize(active->numSelectedEdges());
 	for (int i=0; i < active->numSelectedEdges(); ++i)	{
 		subdivideEdge(&object,MainWindow::num_e_subdivs, active->getSelectedEdge(i));
 	}  
+	object.detachJournal();
 	// DLFL::subdivideEdges(&object,fparray,use_quads);
 	MainWindow::clearSelected();
 	active->recomputePatches();
@@ -897,9 +1037,9 @@ void MainWindow::modifiedMultiConnectCrust(void)
 
 void MainWindow::createSponge(void)
 {
-	undoPush();
-	DLFL::createSponge(&object,MainWindow::sponge_thickness,
+	SpongeOperator op(&object,MainWindow::sponge_thickness,
 		MainWindow::sponge_collapse_threshold);
+	if ( !runOperator(op, tr("Creating sponge")) ) return;
 	active->recomputePatches();
 	active->recomputeNormals();
 	MainWindow::clearSelected();
@@ -935,8 +1075,8 @@ void MainWindow::smoothMesh(void)                          // Smooth the mesh
 
 void MainWindow::subdivideCatmullClark(void)     // Catmull-Clark subdivision
 {
-	undoPush();
-	DLFL::catmullClarkSubdivide(&object);
+	CatmullClarkOperator op(&object);
+	if ( !runOperator(op, tr("Catmull-Clark subdivision")) ) return;
 	active->recomputePatches();
 	active->recomputeNormals();
 	MainWindow::clearSelected();
@@ -947,38 +1087,17 @@ void MainWindow::subdivideCatmullClark(void)     // Catmull-Clark subdivision
 
 void MainWindow::subdivideDooSabin(void)             // Doo-Sabin subdivision
 {
-	undoPush();
-	
-	// QProgressDialog *progress = new QProgressDialog("Performing Doo Sabin Remeshing...", "Cancel", 0, 1);
-	// progress->setMinimumDuration(2000);
-	// progress->setWindowModality(Qt::WindowModal);
-	
-	// DLFLObjectPtr t = object;
-	// active->setRenderingEnabled(false);
-	
-	// if (!DLFL::dooSabinSubdivide(&object, doo_sabin_check/* , progress*/) ){
-		// active->recomputePatches();
-		// active->recomputeNormals();
-		// undo();
-		// MainWindow::clearSelected();
-		// active->setRenderingEnabled(true);
-	// }
-	// else {
-		// object = t;
-		// delete t;
-		// active->setRenderingEnabled(true);
-		DLFL::dooSabinSubdivide(&object, doo_sabin_check/* , progress*/);
-		active->recomputePatches();
-		active->recomputeNormals();
-		MainWindow::clearSelected();
-		QString cmd( "subdivide(\"doo-sabin\",");
-		QString check("False");
-		if( doo_sabin_check )
-			check = QString("True");
-		cmd += check + QString(")");
-		emit echoCommand( cmd );
-	// }
-	
+	DooSabinOperator op(&object, doo_sabin_check);
+	if ( !runOperator(op, tr("Doo-Sabin subdivision")) ) return;
+	active->recomputePatches();
+	active->recomputeNormals();
+	MainWindow::clearSelected();
+	QString cmd( "subdivide(\"doo-sabin\",");
+	QString check("False");
+	if( doo_sabin_check )
+		check = QString("True");
+	cmd += check + QString(")");
+	emit echoCommand( cmd );
 }
 
 void MainWindow::subdivideHoneycomb(void)            // Honeycomb subdivision
@@ -1466,12 +1585,9 @@ void MainWindow::createDual(void)                       // Create dual object
 
 void MainWindow::createCrust(bool use_scaling)        // Create a crust
 {
-	undoPush();
+	CrustOperator op(&object,use_scaling,MainWindow::crust_scale_factor,MainWindow::crust_thickness);
+	if ( !runOperator(op, tr("Creating crust")) ) return;
 	setModified(true);
-	if ( use_scaling ) 
-		DLFL::createCrustWithScaling(&object,MainWindow::crust_scale_factor);
-	else 
-		DLFL::createCrust(&object,MainWindow::crust_thickness);
 	active->recomputePatches();
 	active->recomputeNormals();
 	MainWindow::clearSelected();
@@ -1487,12 +1603,9 @@ void MainWindow::createCrust2(bool use_scaling) {
 
 	QString facelist("[");
 
-	undoPush();
+	CrustOperator op(&object,use_scaling,MainWindow::crust_scale_factor,MainWindow::crust_thickness);
+	if ( !runOperator(op, tr("Creating crust")) ) return;
 	setModified(true);
-	if ( use_scaling ) 
-		DLFL::createCrustWithScaling(&object,MainWindow::crust_scale_factor);
-	else 
-		DLFL::createCrust(&object,MainWindow::crust_thickness);
 	active->recomputePatches();
 	active->recomputeNormals();
 	if ( active->numSelectedFaces() >= 1 ) {
@@ -1988,91 +2101,46 @@ void MainWindow::selectVerticesFromEdges(){
 
 
 void MainWindow::growSelection(){
-	DLFLEdgePtrArray septrarr;
-	DLFLVertexPtrArray svptrarr;
-	DLFLFaceVertexPtrArray sfvptrarr;
-	DLFLFacePtrArray sfptrarr;
+	DLFLVertexPtrArray svptrarr, vadded;
+	DLFLEdgePtrArray septrarr, eadded;
+	DLFLFacePtrArray sfptrarr, fadded;
 	vector<DLFLVertexPtr>::iterator vit;
 	vector<DLFLEdgePtr>::iterator eit;
 	vector<DLFLFacePtr>::iterator fit;
-	vector<DLFLFaceVertexPtr>::iterator fvit;
-	
-	DLFLVertexPtr vptr1,vptr2;
-	DLFLFacePtr fptr1,fptr2;
-	DLFLEdgePtrArray eptrarray;
-	vector<DLFLEdgePtr>::iterator eit2;
 	
 	switch (selectionmask){
 		case MaskVertices:
-		//loop through selected vertices, get corresponding edges
+		//select the vertices sharing an edge with a selected vertex
 		svptrarr = active->getSelectedVertices();
 		if ( svptrarr.size() > 0 && svptrarr[0] ) {
-			for(vit = svptrarr.begin(); vit != svptrarr.end(); vit++){
-				(*vit)->getEdges(septrarr);
-				//loop through edges, select all vertices connected to these edges
-				for(eit = septrarr.begin(); eit != septrarr.end(); eit++){
-					DLFLVertexPtr vp1, vp2;
-					//get the two vertices for each edge, select them if they aren't already selected
-					(*eit)->getVertexPointers(vp1,vp2);
-					if (!active->isSelected(vp1)){
-						active->setSelectedVertex(num_sel_verts,vp1);
-						num_sel_verts++;
-					}
-					if (!active->isSelected(vp2)){
-						active->setSelectedVertex(num_sel_verts,vp2);
-						num_sel_verts++;
-					}
-				}
+			mTraversal.growVertices(&object,svptrarr,vadded);
+			for(vit = vadded.begin(); vit != vadded.end(); vit++){
+				active->setSelectedVertex(num_sel_verts,*vit);
+				num_sel_verts++;
 			}
 		}			
 		redraw();
 		break;
 		case MaskEdges:
-		//loop through selected edges, get vertices, then get those edges
+		//select the edges sharing a vertex with a selected edge
 		septrarr = active->getSelectedEdges();
 		if ( septrarr.size() > 0 && septrarr[0]) {
-			for(eit = septrarr.begin(); eit != septrarr.end(); eit++){
-				//get the 2 vertices for the current edge
-				(*eit)->getVertexPointers(vptr1,vptr2);
-				//get the edges for vertex 1
-				vptr1->getEdges(eptrarray);
-				for (eit2 = eptrarray.begin(); eit2 != eptrarray.end(); eit2++){
-					if (!active->isSelected(*eit2)){
-						active->setSelectedEdge(num_sel_edges,*eit2);
-						num_sel_edges++;
-					}					
-				}
-				//get edges for vertex 2
-				vptr2->getEdges(eptrarray);
-				for (eit2 = eptrarray.begin(); eit2 != eptrarray.end(); eit2++){
-					if (!active->isSelected(*eit2)){
-						active->setSelectedEdge(num_sel_edges,*eit2);
-						num_sel_edges++;
-					}					
-				}
+			mTraversal.growEdges(&object,septrarr,eadded);
+			for(eit = eadded.begin(); eit != eadded.end(); eit++){
+				active->setSelectedEdge(num_sel_edges,*eit);
+				num_sel_edges++;
 			}
 		}			
 		redraw();
 		break;
 		case MaskFaces:
-		//loop through selected faces
+		//select the faces sharing an edge with a selected face
 		sfptrarr = active->getSelectedFaces();
 		if ( sfptrarr.size() > 0 && sfptrarr[0] ) {
-			for(fit = sfptrarr.begin(); fit != sfptrarr.end(); fit++){
-				//get the edges for the current face
-				(*fit)->getEdges(eptrarray);
-				for(eit = eptrarray.begin(); eit != eptrarray.end(); eit++){
-					//get the 2 faces for the current edge, select them if they aren't already selected
-					(*eit)->getFacePointers(fptr1,fptr2);
-					if (!active->isSelected(fptr1)){
-						active->setSelectedFace(num_sel_faces,fptr1);
-						num_sel_faces++;
-					}
-					if (!active->isSelected(fptr2)){
-						active->setSelectedFace(num_sel_faces,fptr2);
-						num_sel_faces++;
-					}
-				}
+			mTraversal.growFaces(&object,sfptrarr,fadded);
+			for(fit = fadded.begin(); fit != fadded.end(); fit++){
+				active->setSelectedFace(num_sel_faces,*fit);
+				num_sel_faces++;
 			}
 		}
 		redraw();
@@ -2088,104 +2156,40 @@ void MainWindow::growSelection(){
 }
 
 void MainWindow::shrinkSelection(){
-	DLFLEdgePtrArray septrarr;
-	DLFLVertexPtrArray svptrarr;
-	DLFLFaceVertexPtrArray sfvptrarr;
-	DLFLFacePtrArray sfptrarr;
+	DLFLVertexPtrArray svptrarr, vremoved;
+	DLFLEdgePtrArray septrarr, eremoved;
+	DLFLFacePtrArray sfptrarr, fremoved;
 	vector<DLFLVertexPtr>::iterator vit;
 	vector<DLFLEdgePtr>::iterator eit;
 	vector<DLFLFacePtr>::iterator fit;
-	vector<DLFLFaceVertexPtr>::iterator fvit;
-	int i = 0;
-	
-	DLFLVertexPtr vptr1,vptr2;
-	DLFLFacePtr fptr1,fptr2;
-	DLFLEdgePtrArray eptrarray;
-	vector<DLFLEdgePtr>::iterator eit2;
 	
 	switch (selectionmask){
 		case MaskVertices:
-		//loop through selected vertices, get corresponding edges
+		//deselect the selected vertices which share an edge with an unselected one
 		svptrarr = active->getSelectedVertices();
 		if ( svptrarr.size() > 0 && svptrarr[0] ) {
-			bool deselectvertices[svptrarr.size()];
-			for(vit = svptrarr.begin(); vit != svptrarr.end(); vit++,i++){
-				deselectvertices[i] = false;
-				(*vit)->getEdges(septrarr);
-				//loop through edges, select all vertices connected to these edges
-				for(eit = septrarr.begin(); eit != septrarr.end(); eit++){
-					DLFLVertexPtr vp1, vp2;
-					//get the two vertices for each edge, select them if they aren't already selected
-					(*eit)->getVertexPointers(vp1,vp2);
-					if (!active->isSelected(vp1) || !active->isSelected(vp2))
-						deselectvertices[i] = true;
-				}
-			}
-			//loop back through verts, now deselect the flagged ones
-			i = 0;
-			for(vit = svptrarr.begin(); vit != svptrarr.end(); vit++, i++){
-				//if it's flagged, deselect it
-				if (deselectvertices[i])
-					active->clearSelectedVertex(*vit);
-			}
+			mTraversal.shrinkVertices(&object,svptrarr,vremoved);
+			for(vit = vremoved.begin(); vit != vremoved.end(); vit++)
+				active->clearSelectedVertex(*vit);
 		}			
 		redraw();
 		break;
 		case MaskEdges:
-		//loop through selected edges, get vertices, then get those edges
+		//deselect the selected edges which share a vertex with an unselected one
 		septrarr = active->getSelectedEdges();
 		if ( septrarr.size() > 0 && septrarr[0]) {
-			bool deselectedges[septrarr.size()];
-			for(eit = septrarr.begin(); eit != septrarr.end(); eit++,i++){
-				//get the 2 vertices for the current edge
-				(*eit)->getVertexPointers(vptr1,vptr2);
-				//get the edges for vertex 1
-				vptr1->getEdges(eptrarray);
-				deselectedges[i] = false;
-				for (eit2 = eptrarray.begin(); eit2 != eptrarray.end(); eit2++){
-					if (!active->isSelected(*eit2))
-						deselectedges[i] = true;
-				}
-				//get edges for vertex 2
-				vptr2->getEdges(eptrarray);
-				for (eit2 = eptrarray.begin(); eit2 != eptrarray.end(); eit2++){
-					if (!active->isSelected(*eit2))
-						deselectedges[i] = true;
-				}
-			}
-			//loop back through edges, now deselect the flagged ones
-			i = 0;
-			for(eit = septrarr.begin(); eit != septrarr.end(); eit++,i++){
-				//if it's flagged, deselect it
-				if (deselectedges[i])
-					active->clearSelectedEdge(*eit);
-			}
+			mTraversal.shrinkEdges(&object,septrarr,eremoved);
+			for(eit = eremoved.begin(); eit != eremoved.end(); eit++)
+				active->clearSelectedEdge(*eit);
 		}			
 		redraw();		break;
 		case MaskFaces:
-		//loop through selected faces
+		//deselect the selected faces which share an edge with an unselected one
 		sfptrarr = active->getSelectedFaces();
 		if ( sfptrarr.size() > 0 && sfptrarr[0] ) {
-			bool deselectfaces[sfptrarr.size()];
-			for(fit = sfptrarr.begin(); fit != sfptrarr.end(); fit++, i++){
-				//get the edges for the current face
-				(*fit)->getEdges(eptrarray);
-				//by default don't deselect this face
-				deselectfaces[i] = false;
-				for(eit = eptrarray.begin(); eit != eptrarray.end(); eit++){
-					//get the 2 faces for the current edge, check if both of them are selected, flag the current face
-					(*eit)->getFacePointers(fptr1,fptr2);
-					if (!active->isSelected(fptr1) || !active->isSelected(fptr2))
-						deselectfaces[i] = true;
-				}
-			}
-			//loop back through faces, now deselect the flagged ones
-			i = 0;
-			for(fit = sfptrarr.begin(); fit != sfptrarr.end(); fit++,i++){
-				//if it's flagged, deselect it
-				if (deselectfaces[i])
-					active->clearSelectedFace(*fit);
-			}
+			mTraversal.shrinkFaces(&object,sfptrarr,fremoved);
+			for(fit = fremoved.begin(); fit != fremoved.end(); fit++)
+				active->clearSelectedFace(*fit);
 		}
 		redraw();
 		break;
@@ -0,0 +1,71 @@
+/*
+*
+* ***** BEGIN GPL LICENSE BLOCK *****
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software  Foundation,
+* Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*
+* The Original Code is Copyright (C) 2005 by xxxxxxxxxxxxxx
+* All rights reserved.
+*
+* The Original Code is: all of this file.
+*
+* Contributor(s): none yet.
+*
+* ***** END GPL LICENSE BLOCK *****
+*/
+
+/**
+ * \file OperatorThread.hh
+ */
+
+#ifndef _OPERATOR_THREAD_HH_
+#define _OPERATOR_THREAD_HH_
+
+#include <QThread>
+#include <DLFLObject.hh>
+#include <DLFLProgress.hh>
+
+// Runs an operator on an object in a worker thread, so a long operation doesn't
+// freeze the user interface. The thread is the DLFLProgress the operator reports
+// to : the interface reads how far it is and cancels it through that.
+// Subclasses call the operator in operate(). Nothing else may use the object
+// until the thread has finished. See MainWindow::runOperator
+class OperatorThread : public QThread, public DLFL::DLFLProgress {
+public :
+
+	OperatorThread(DLFL::DLFLObjectPtr obj) : mObject(obj), mFailed(false) { }
+
+	// The operator threw an exception, so the object is in an unknown state
+	bool failed() const { return mFailed; }
+
+protected :
+
+	virtual void operate(DLFL::DLFLObjectPtr obj) = 0;
+
+	void run() {
+		try {
+			operate(mObject);
+		} catch ( ... ) {
+			mFailed = true;
+		}
+	}
+
+private :
+
+	DLFL::DLFLObjectPtr mObject;
+	volatile bool mFailed;
+};
+
+#endif /* #ifndef _OPERATOR_THREAD_HH_ */
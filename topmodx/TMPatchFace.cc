@@ -56,7 +56,7 @@ void TMPatchFace::resizePatches(int psize) {
 }
      
 // Create the patches using face information
-void TMPatchFace::createPatches(TMPatchMap &patchMap) {
+void TMPatchFace::createPatches(void) {
   if ( dlflface == NULL ) return;
 
   // patcharray will be resized here
@@ -186,17 +186,13 @@ void TMPatchFace::createPatches(TMPatchMap &patchMap) {
     cn[2][2] = normalized(6*cn[3][3]+cn[0][3]+cn[3][0]);
               
     patcharray[i].calculatePatchPoints(cp,cn);
-		setPatchPtr(patchMap, &(patcharray[i]), corners[i] );
   }
 
   // Make adjustment to face point for quadrilaterals
   if ( size == 4 ) {
     TMPatchPtr pptr1, pptr2;
-    pptr1 = getPatchPtr(patchMap,corners[0]);
-    pptr2 = getPatchPtr(patchMap,corners[2]);
-
-		if( pptr1 == NULL || pptr2 == NULL )
-			return;
+    pptr1 = &(patcharray[0]);
+    pptr2 = &(patcharray[2]);
 
     Vector3d p00,p01,p10,p11,ip;
     p00 = pptr1->getControlPoint(3,2); p01 = pptr2->getControlPoint(3,2);
@@ -204,7 +200,7 @@ void TMPatchFace::createPatches(TMPatchMap &patchMap) {
     ip = intersectCoplanarLines(p00,p01,p10,p11);
 
     for (int i=0; i < size; ++i) {
-      pptr1 = getPatchPtr(patchMap,corners[i]);
+      pptr1 = &(patcharray[i]);
       pptr1->setControlPoint(3,3,ip);
       pptr1->updateGLPointArray();
     }
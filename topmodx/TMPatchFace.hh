@@ -79,9 +79,17 @@ public :
     dlflface = fp;
     resizePatchArray();
   }
+
+  DLFLFacePtr getDLFLFace(void) const { return dlflface; }
+
+  // Number of patches, one for each corner of the DLFLFace
+  uint numPatches(void) const { return patcharray.size(); }
+
+  // Patch for the corner at the given position, starting from the front of the DLFLFace
+  TMPatchPtr patch(uint i) { return &(patcharray[i]); }
      
   // Create the patches using face information
-  void createPatches(TMPatchMap &patchMap);
+  void createPatches(void);
 
   // Adjust the edge points for each patch in the face
   void adjustEdgePoints(TMPatchMap &patchMap);
@@ -33,88 +33,145 @@
 
 #include "TMPatchObject.hh"
 
-void TMPatchObject::updateForPatches( DLFLObjectPtr obj ) {
-  DLFLFacePtrList face_list = obj->getFaceList( );
-  DLFLEdgePtrList edge_list = obj->getEdgeList( );
-  DLFLVertexPtrList vertex_list = obj->getVertexList( );
-
-  // Update information stored at each face, vertex, edge and corner for patch rendering
-
-  // Compute doo-sabin coordinates for each face and store them in the auxcoord field of the corner
-  // Update the auxcoord field of the face
-  Vector3dArray coords;
-  DLFLFacePtrList::iterator ffirst=face_list.begin(), flast=face_list.end();
-  DLFLFacePtr fp;
-  DLFLFaceVertexPtrArray corners;
-  int valence;
-       
-  while ( ffirst != flast ) {
-    fp = *ffirst; ++ffirst;
-    fp->getCornersAndCoords(corners,coords);
-    valence = coords.size();
-
-    if ( valence > 0 ) {
-      // Compute Doo-Sabin coordinates - Level 1
-      DLFL::computeDooSabinCoords(coords);
-      for (int i=0; i < valence; ++i) 
-				corners[i]->setAuxCoords(coords[i]);
+// Add the edges and vertices of the faces to the sets
+static void getEdgesAndVertices( const DLFLFacePtrArray& faces, DLFLEdgeSelection& edges, DLFLVertexSelection& verts ) {
+  DLFLFaceVertexPtr head, current;
+  for (uint i=0; i < faces.size(); ++i) {
+    head = current = faces[i]->front();
+    if ( head == NULL ) continue;
+    do {
+      edges.insert(current->getEdgePtr()); verts.insert(current->vertex);
+      current = current->next();
+    } while ( current != head );
+  }
+}
 
-      // Compute Doo-Sabin coordinates - Level 2
-      DLFL::computeDooSabinCoords(coords);
-      for (int i=0; i < valence; ++i) 
-				corners[i]->setDS2Coord2(coords[i]);
-
-      // Compute the patch point and patch normal
-      Vector3d pp, pn;
-      DLFL::computeCentroidAndNormal(coords,pp,pn);
-      fp->setAuxCoords(pp); fp->setAuxNormal(pn);
-    }
+// Add the faces around the vertices to the set
+static void getFaces( const DLFLVertexSelection& verts, DLFLFaceSelection& faces ) {
+  DLFLFacePtrArray vfaces;
+  DLFLVertexSelection::const_iterator first, last = verts.end();
+  for ( first = verts.begin(); first != last; ++first ) {
+    (*first)->getFaces(vfaces);
+    for (uint i=0; i < vfaces.size(); ++i) faces.insert(vfaces[i]);
   }
+}
+
+void TMPatchObject::updateForPatches( DLFLObjectPtr obj ) {
+  DLFLFacePtrArray faces(obj->beginFace(),obj->endFace());
+  DLFLEdgePtrArray edges(obj->beginEdge(),obj->endEdge());
+  DLFLVertexPtrArray verts(obj->beginVertex(),obj->endVertex());
+  updateForPatches(faces,edges,verts);
+}
+
+void TMPatchObject::updateForPatches( const DLFLFacePtrArray& faces, const DLFLEdgePtrArray& edges, const DLFLVertexPtrArray& verts ) {
+  // Update information stored at each face, vertex, edge and corner for patch rendering.
+  // Each loop writes only to the element it visits and to its own corners, and reads
+  // what the previous loop wrote, so the elements of each loop are done in parallel
+  int numfaces = faces.size(), numedges = edges.size(), numverts = verts.size();
+
+#pragma omp parallel
+  {
+    Vector3dArray coords, p;
+    DLFLFaceVertexPtrArray corners, fvp;
+    Vector3d pp, pn;
+    int valence;
 
-  // Compute patch point and normal for all edges
-  DLFLEdgePtrList::iterator efirst=edge_list.begin(), elast=edge_list.end();
-  DLFLEdgePtr ep;
-  while ( efirst != elast ) {
-    ep = *efirst; ++efirst;
+    // Compute doo-sabin coordinates for each face and store them in the auxcoord field of the corner
+    // Update the auxcoord field of the face
+#pragma omp for schedule(static)
+    for (int f=0; f < numfaces; ++f) {
+      DLFLFacePtr fp = faces[f];
+      fp->getCornersAndCoords(corners,coords);
+      valence = coords.size();
 
-    Vector3dArray p;
-    ep->getEFCornersAuxCoords(p);
+      if ( valence > 0 ) {
+        // Compute Doo-Sabin coordinates - Level 1
+        DLFL::computeDooSabinCoords(coords);
+        for (int i=0; i < valence; ++i) 
+          corners[i]->setAuxCoords(coords[i]);
+
+        // Compute Doo-Sabin coordinates - Level 2
+        DLFL::computeDooSabinCoords(coords);
+        for (int i=0; i < valence; ++i) 
+          corners[i]->setDS2Coord2(coords[i]);
+
+        // Compute the patch point and patch normal
+        DLFL::computeCentroidAndNormal(coords,pp,pn);
+        fp->setAuxCoords(pp); fp->setAuxNormal(pn);
+      }
+    }
+
+    // Compute patch point and normal for all edges.
+    // Every corner gets level-2 coordinates 1 and 3 from exactly one edge each
+#pragma omp for schedule(static)
+    for (int e=0; e < numedges; ++e) {
+      DLFLEdgePtr ep = edges[e];
+      ep->getEFCornersAuxCoords(p);
             
-    // Compute Doo-Sabin coordinates - Level 2
-    DLFL::computeDooSabinCoords(p);
+      // Compute Doo-Sabin coordinates - Level 2
+      DLFL::computeDooSabinCoords(p);
 
-    Vector3d pp,pn;
-    computeCentroidAndNormal(p,pp,pn);
-    ep->setAuxCoords(pp); ep->setAuxNormal(pn);
+      computeCentroidAndNormal(p,pp,pn);
+      ep->setAuxCoords(pp); ep->setAuxNormal(pn);
 
-    DLFLFaceVertexPtrArray fvp;
-    ep->getEFCorners(fvp);
-    fvp[0]->setDS2Coord3(p[0]); fvp[1]->setDS2Coord1(p[1]);
-    fvp[2]->setDS2Coord3(p[2]); fvp[3]->setDS2Coord1(p[3]);
-  }
+      ep->getEFCorners(fvp);
+      fvp[0]->setDS2Coord3(p[0]); fvp[1]->setDS2Coord1(p[1]);
+      fvp[2]->setDS2Coord3(p[2]); fvp[3]->setDS2Coord1(p[3]);
+    }
 
-  // Compute patch point and normal for all vertices
-  DLFLVertexPtrList::iterator vfirst=vertex_list.begin(), vlast=vertex_list.end();
-  DLFLVertexPtr vp;
-  while ( vfirst != vlast ) {
-    vp = *vfirst; ++vfirst;
-    Vector3dArray p;
-    vp->getOrderedCornerAuxCoords(p);
+    // Compute patch point and normal for all vertices
+#pragma omp for schedule(static)
+    for (int v=0; v < numverts; ++v) {
+      DLFLVertexPtr vp = verts[v];
+      vp->getOrderedCornerAuxCoords(p);
 
-    // Compute Doo-Sabin coordinates - Level 2
-    DLFL::computeDooSabinCoords(p);
+      // Compute Doo-Sabin coordinates - Level 2
+      DLFL::computeDooSabinCoords(p);
 
-    Vector3d pp,pn;
-    DLFL::computeCentroidAndNormal(p,pp,pn);
-    vp->setAuxCoords(pp); vp->setAuxNormal(-pn); // Reverse the normal since the rotation order around the vertex is clockwise
+      DLFL::computeCentroidAndNormal(p,pp,pn);
+      vp->setAuxCoords(pp); vp->setAuxNormal(-pn); // Reverse the normal since the rotation order around the vertex is clockwise
             
-    DLFLFaceVertexPtrArray fvp;
-    vp->getOrderedCorners(fvp);
-    for (int i=0; i < fvp.size(); ++i) 
-      fvp[i]->setDS2Coord0(p[i]);
+      vp->getOrderedCorners(fvp);
+      for (int i=0; i < fvp.size(); ++i) 
+        fvp[i]->setDS2Coord0(p[i]);
+    }
   }
 }
 
+// Update only the patches affected by changes to the given faces.
+// The Doo-Sabin points of a face depend only on its own vertices, and those of an
+// edge or vertex only on the faces around it. A patch uses the points around the
+// vertex of its corner, so the patches to rebuild are those of every face around
+// a vertex of the changed faces
+void TMPatchObject::updatePatches( DLFLObjectPtr obj, const DLFLFacePtrArray& changed ) {
+  // Patches which were built for another object, or not built at all, are rebuilt entirely
+  if ( obj != mObj || face_map.empty() ) {
+    updatePatches(obj);
+    return;
+  }
+
+  DLFLEdgeSelection edges;
+  DLFLVertexSelection verts;
+  getEdgesAndVertices(changed,edges,verts);
+  updateForPatches(changed,edges.array(),verts.array());
+
+  DLFLFaceSelection faces;
+  getFaces(verts,faces);
+  edges.clear(); verts.clear();
+  getEdgesAndVertices(faces.array(),edges,verts);
+
+  DLFLFacePtrArray allfaces(obj->beginFace(),obj->endFace());
+  assignPatchFaces(allfaces);
+  createPatches(faces.array(),edges.array(),verts.array());
+
+  // Joining the patches also moves control points of the patches around them
+  faces.clear();
+  getFaces(verts,faces);
+  updated_list.clear(); updated_list.reserve(faces.size());
+  for (uint i=0; i < faces.size(); ++i)
+    updated_list.push_back(face_map[faces[i]]);
+}
+
 void TMPatchObject::for_each(void (TMPatchFace::*func)(void)) {
   for( it = patch_list.begin(); it != patch_list.end(); it++ ) {
     TMPatchFacePtr pfp = *it;
@@ -131,76 +188,133 @@ void TMPatchObject::destroyPatches() {
 		delete pfp;
 	}
 	patch_list.clear();
+	face_map.clear(); corner_patches.clear(); updated_list.clear();
+}
+
+// Give every face of the object a patch face, in face list order. Faces which had
+// one keep it. New faces get the patch faces of deleted faces, so their storage
+// isn't allocated again, and new ones only when there are none left.
+// The corners are numbered to find their patches in corner_patches
+void TMPatchObject::assignPatchFaces( const DLFLFacePtrArray& faces ) {
+  TMPatchFaceMap old_map;
+  TMPatchFaceMap::iterator pos;
+  TMPatchFacePtrArray patches(faces.size(),(TMPatchFacePtr)NULL);
+  TMPatchFacePtr pfp = NULL;
+
+  old_map.swap(face_map);
+  for (uint i=0; i < faces.size(); ++i) {
+    pos = old_map.find(faces[i]);
+    if ( pos != old_map.end() ) {
+      patches[i] = pos->second; pos->second = NULL;
+    }
+  }
+
+  pos = old_map.begin();
+  for (uint i=0; i < faces.size(); ++i) {
+    if ( patches[i] ) continue;
+    while ( pos != old_map.end() && pos->second == NULL ) ++pos;
+    if ( pos != old_map.end() ) {
+      patches[i] = pos->second; pos->second = NULL;
+    } else patches[i] = new TMPatchFace(patchsize);
+  }
+  for ( ; pos != old_map.end(); ++pos ) delete pos->second;
+
+  patch_list.assign(patches.begin(),patches.end());
+  face_map.resize(faces.size());
+  corner_patches.clear();
+
+  DLFLFaceVertexPtr head, current;
+  uint index = 0;
+  for (uint i=0; i < faces.size(); ++i) {
+    pfp = patches[i];
+    face_map[faces[i]] = pfp;
+    pfp->resizePatches(patchsize);
+    pfp->setDLFLFace(faces[i]);
+    head = current = faces[i]->front();
+    if ( head == NULL ) continue;
+    uint corner = 0;
+    do {
+      current->setIndex(index++);
+      corner_patches.push_back(pfp->patch(corner++));
+      current = current->next();
+    } while ( current != head );
+  }
 }
 
 // Build the list of patch faces
 void TMPatchObject::createPatches( DLFLObjectPtr obj ) {
-  destroyPatches();
-	destroyPatchMap( patchMap );
-  DLFLFacePtrList face_list = obj->getFaceList( );
-	DLFLFacePtrList::iterator ffirst = face_list.begin(), flast = face_list.end();
-	DLFLFacePtr fp = NULL;
-	TMPatchFacePtr pfp = NULL;
+  mObj = obj;
+  DLFLFacePtrArray faces(obj->beginFace(),obj->endFace());
+  DLFLEdgePtrArray edges(obj->beginEdge(),obj->endEdge());
+  DLFLVertexPtrArray verts(obj->beginVertex(),obj->endVertex());
+  assignPatchFaces(faces);
+  createPatches(faces,edges,verts);
+  updated_list.assign(patch_list.begin(),patch_list.end());
+}
 
-	while ( ffirst != flast ) {
-		fp = (*ffirst); ++ffirst;
-		pfp = new TMPatchFace(patchsize);
-		pfp->setDLFLFace(fp); 
-		pfp->createPatches(patchMap);
-		patch_list.push_back(pfp);
-	}
+void TMPatchObject::createPatches( const DLFLFacePtrArray& faces, const DLFLEdgePtrArray& edges, const DLFLVertexPtrArray& verts ) {
+  int numfaces = faces.size(), numedges = edges.size(), numverts = verts.size();
+  TMPatchFacePtrArray patches(numfaces);
+  for (int f=0; f < numfaces; ++f)
+    patches[f] = face_map[faces[f]];
 
-	// Adjust the edge points for all patches
-	DLFLEdgePtrList edge_list = obj->getEdgeList();
-	DLFLEdgePtrList::iterator efirst = edge_list.begin(), elast = edge_list.end();
-	DLFLEdgePtr ep = NULL;
-	DLFLFaceVertexPtr fvp1,fvp2;
-	TMPatchPtr pp1, pp2;
-	Vector3d p00,p01,p10,p11,ip;
-	while ( efirst != elast ) {
-		ep = (*efirst); ++efirst;
-		ep->getCorners(fvp1,fvp2);
-		pp1 = getPatchPtr(patchMap,fvp1); pp2 = getPatchPtr(patchMap,fvp2);
-
-		if( pp1 == NULL || pp2 == NULL )
-			return;
-
-		p00 = pp1->getControlPoint(2,0); 
-		p01 = pp2->getControlPoint(2,0);
-		p10 = pp1->getControlPoint(3,1); 
-		p11 = pp2->getControlPoint(3,1);
-		ip = intersectCoplanarLines(p00,p01,p10,p11);
-
-		pp1->setControlPoint(3,0,ip); pp2->setControlPoint(3,0,ip);
-		pp1->updateGLPointArray(); pp2->updateGLPointArray();
-
-		pp1 = getPatchPtr(patchMap,fvp1->next()); pp2 = getPatchPtr(patchMap,fvp2->next());
-		pp1->setControlPoint(0,3,ip); pp2->setControlPoint(0,3,ip);
-		pp1->updateGLPointArray(); pp2->updateGLPointArray();
-	}
+  // The patches of a face depend only on the Doo-Sabin points. Joining them
+  // moves the edge points (3,0) and (0,3) across each edge and the vertex point (0,0)
+  // of 4-valence vertices, and reads only points which aren't moved, so each loop is
+  // done in parallel. The point arrays for OpenGL are updated once everything is moved
+#pragma omp parallel
+  {
+    DLFLFaceVertexPtr fvp1,fvp2;
+    DLFLFaceVertexPtrArray vcorners;
+    TMPatchPtr pp1, pp2;
+    Vector3d p00,p01,p10,p11,ip;
 
-	// Adjust the vertex points for 4-valence vertices
-	DLFLVertexPtrList vertex_list = obj->getVertexList( );
-	DLFLVertexPtrList::iterator vfirst = vertex_list.begin(), vlast = vertex_list.end();
-	DLFLVertexPtr vp = NULL;
-	while ( vfirst != vlast ) {
-		vp = (*vfirst); ++vfirst;
-		if ( vp->valence() == 4 ) {
-			DLFLFaceVertexPtrArray vcorners;
-			vp->getOrderedCorners(vcorners);
-			pp1 = getPatchPtr(patchMap,vcorners[0]); pp2 = getPatchPtr(patchMap,vcorners[2]);
-
-			p00 = pp1->getControlPoint(1,0); p01 = pp2->getControlPoint(1,0);
-			p10 = pp1->getControlPoint(0,1); p11 = pp2->getControlPoint(0,1);
-			ip = intersectCoplanarLines(p00,p01,p10,p11);
+#pragma omp for schedule(dynamic,64)
+    for (int f=0; f < numfaces; ++f)
+      patches[f]->createPatches();
+
+    // Adjust the edge points for all patches
+#pragma omp for schedule(static)
+    for (int e=0; e < numedges; ++e) {
+      edges[e]->getCorners(fvp1,fvp2);
+      pp1 = corner_patches[fvp1->getIndex()]; pp2 = corner_patches[fvp2->getIndex()];
+
+      p00 = pp1->getControlPoint(2,0); 
+      p01 = pp2->getControlPoint(2,0);
+      p10 = pp1->getControlPoint(3,1); 
+      p11 = pp2->getControlPoint(3,1);
+      ip = intersectCoplanarLines(p00,p01,p10,p11);
+
+      pp1->setControlPoint(3,0,ip); pp2->setControlPoint(3,0,ip);
+
+      pp1 = corner_patches[fvp1->next()->getIndex()]; pp2 = corner_patches[fvp2->next()->getIndex()];
+      pp1->setControlPoint(0,3,ip); pp2->setControlPoint(0,3,ip);
+    }
+
+    // Adjust the vertex points for 4-valence vertices
+#pragma omp for schedule(static)
+    for (int v=0; v < numverts; ++v) {
+      if ( verts[v]->valence() != 4 ) continue;
+      verts[v]->getOrderedCorners(vcorners);
+      if ( vcorners.size() != 4 ) continue;
+      pp1 = corner_patches[vcorners[0]->getIndex()]; pp2 = corner_patches[vcorners[2]->getIndex()];
+
+      p00 = pp1->getControlPoint(1,0); p01 = pp2->getControlPoint(1,0);
+      p10 = pp1->getControlPoint(0,1); p11 = pp2->getControlPoint(0,1);
+      ip = intersectCoplanarLines(p00,p01,p10,p11);
 				
-			for( int i = 0; i < 4; ++i ) {
-				pp1 = getPatchPtr(patchMap,vcorners[i]);
-				pp1->setControlPoint(0,0,ip);
-				pp1->updateGLPointArray();
-			}
-		}
-	}
+      for( int i = 0; i < 4; ++i )
+        corner_patches[vcorners[i]->getIndex()]->setControlPoint(0,0,ip);
+    }
+
+    // Every patch moved above belongs to a corner of one of the vertices
+#pragma omp for schedule(static)
+    for (int v=0; v < numverts; ++v) {
+      verts[v]->getCorners(vcorners);
+      for (uint i=0; i < vcorners.size(); ++i)
+        corner_patches[vcorners[i]->getIndex()]->updateGLPointArray();
+    }
+  }
                  
 	/*
 		TMPatchFacePtrList::iterator pfirst = patch_list.begin(), plast = patch_list.end();
@@ -30,10 +30,14 @@
 #define _TM_PATCH_OBJECT_HH_
 
 #include "TMPatchFace.hh"
+#include <DLFLSelectionSet.hh>
 
 class TMPatchObject;
 typedef TMPatchObject* TMPatchObjectPtr;
 
+// Patch face built for each DLFLFace
+typedef __gnu_cxx::hash_map<DLFLFacePtr, TMPatchFacePtr, PointerHash> TMPatchFaceMap;
+
 class TMPatchObject {
 protected :
 
@@ -45,13 +49,16 @@ protected :
 public :
 
   // Default constructor
-  TMPatchObject( uint id ) : uid(id), patch_list(), patchsize(4) { }
+  TMPatchObject( uint id ) : uid(id), patch_list(), patchsize(4), mObj(NULL) { }
 
   uint id( ) { return uid; };
   int size( ) { return patchsize; };
   const TMPatchFacePtrList& list( ) { return patch_list; };
   void for_each( void (TMPatchFace::*func)(void));
 
+  // Patch faces whose control points changed in the last update
+  const TMPatchFacePtrArray& updatedList( ) { return updated_list; };
+
 	/* stuart - bezier export */
 	void objPatchWrite( ostream& o );
 
@@ -66,18 +73,27 @@ private :
        
 public :     
   // Destructor
-  ~TMPatchObject() { destroyPatches(); destroyPatchMap(patchMap); }
+  ~TMPatchObject() { destroyPatches(); }
 
 protected :
   DLFLObjectPtr mObj; // the last obj created from
 
-	TMPatchMap patchMap;
+  TMPatchFaceMap face_map;         // Patch face for each face of mObj
+  TMPatchPtrArray corner_patches;  // Patch for each corner of mObj, by corner index
+  TMPatchFacePtrArray updated_list; // Patch faces changed by the last update
 
   // Free the memory allocated for the patches
   void destroyPatches();
   // Build the list of patch faces
   void createPatches( DLFLObjectPtr obj );
 
+  // Give every face of the object a patch face, in face list order
+  void assignPatchFaces( const DLFLFacePtrArray& faces );
+  // Rebuild the patches of the faces and join them across the edges and around the vertices
+  void createPatches( const DLFLFacePtrArray& faces, const DLFLEdgePtrArray& edges, const DLFLVertexPtrArray& verts );
+  // Compute the Doo-Sabin points used by the patches for the given elements
+  void updateForPatches( const DLFLFacePtrArray& faces, const DLFLEdgePtrArray& edges, const DLFLVertexPtrArray& verts );
+
 public :
 
   // Set the patch size
@@ -93,6 +109,9 @@ public :
     createPatches(obj);
   }
 
+  // Update only the patches affected by changes to the given faces
+  void updatePatches( DLFLObjectPtr obj, const DLFLFacePtrArray& changed );
+
   // Render the patches
   void renderPatches(void) {
     glPushMatrix();
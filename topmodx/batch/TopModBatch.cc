@@ -0,0 +1,302 @@
+/*
+*
+* ***** BEGIN GPL LICENSE BLOCK *****
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software  Foundation,
+* Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*
+* The Original Code is Copyright (C) 2005 by xxxxxxxxxxxxxx
+* All rights reserved.
+*
+* The Original Code is: all of this file.
+*
+* Contributor(s): none yet.
+*
+* ***** END GPL LICENSE BLOCK *****
+*/
+
+/**
+ * \file TopModBatch.cc
+ */
+
+// Command line tool which applies DLFL operators and Python scripts to a model,
+// for pipelines which don't need the GUI. It links only the DLFL libraries and,
+// with Python support, the dlfl Python module, which is built in. Each run
+// handles one model, so many models are done by running it in parallel.
+//
+//   topmod-batch [-j threads] [-s script.py] [-o operator[:arg,arg..]].. input output
+//
+// Scripts and operators are applied in the order given. A script sees the input
+// object as the current object of the dlfl module, as in the script editor, and
+// whatever object is current when it returns is passed on.
+
+#ifdef WITH_PYTHON
+#include <Python.h>
+#endif
+
+#include <DLFLCore.hh>
+#include <DLFLCast.hh>
+#include <DLFLConvexHull.hh>
+#include <DLFLCrust.hh>
+#include <DLFLDual.hh>
+#include <DLFLMeshSmooth.hh>
+#include <DLFLMultiConnect.hh>
+#include <DLFLSubdiv.hh>
+
+#include <iostream>
+
+using namespace DLFL;
+
+#ifdef WITH_PYTHON
+PyMODINIT_FUNC initdlfl(void);
+
+// The C API of the dlfl module, see DLFLModule.cc
+static void **PyDLFL_API;
+#define PyDLFL_PassObject \
+  (*(void (*)(DLFLObject* obj)) PyDLFL_API[1])
+#define PyDLFL_CurrentObject \
+  (*(DLFLObject* (*)(void)) PyDLFL_API[2])
+#endif
+
+//-- Named operators --//
+
+// Parameter i of an operator, or the default if it wasn't given
+static double param( const DoubleArray& params, int i, double def ) {
+  return ( i < (int)params.size() ) ? params[i] : def;
+}
+
+static void opLoop( DLFLObjectPtr obj, const DoubleArray& ) { loopSubdivide(obj); }
+static void opChecker( DLFLObjectPtr obj, const DoubleArray& p ) { checkerBoardRemeshing(obj,param(p,0,0.33)); }
+static void opSimplest( DLFLObjectPtr obj, const DoubleArray& ) { simplestSubdivide(obj); }
+static void opVertexCut( DLFLObjectPtr obj, const DoubleArray& p ) { vertexCuttingSubdivide(obj,param(p,0,0.25)); }
+static void opPentagon( DLFLObjectPtr obj, const DoubleArray& p ) { pentagonalSubdivide(obj,param(p,0,0.0)); }
+static void opPentagonPreserve( DLFLObjectPtr obj, const DoubleArray& p ) { pentagonalSubdivide2(obj,param(p,0,0.75)); }
+static void opHoneycomb( DLFLObjectPtr obj, const DoubleArray& ) { honeycombSubdivide(obj); }
+static void opDooSabin( DLFLObjectPtr obj, const DoubleArray& p ) { dooSabinSubdivide(obj,param(p,0,1.0) != 0.0); }
+static void opCornerCut( DLFLObjectPtr obj, const DoubleArray& p ) { cornerCuttingSubdivide(obj,param(p,0,0.0)); }
+static void opRoot4( DLFLObjectPtr obj, const DoubleArray& p ) { root4Subdivide(obj,param(p,0,0.0),param(p,1,0.0)); }
+static void opCatmullClark( DLFLObjectPtr obj, const DoubleArray& ) { catmullClarkSubdivide(obj); }
+static void opStar( DLFLObjectPtr obj, const DoubleArray& p ) { starSubdivide(obj,param(p,0,0.0)); }
+static void opSqrt3( DLFLObjectPtr obj, const DoubleArray& ) { sqrt3Subdivide(obj); }
+static void opFractal( DLFLObjectPtr obj, const DoubleArray& p ) { fractalSubdivide(obj,param(p,0,1.0)); }
+static void opStellate( DLFLObjectPtr obj, const DoubleArray& ) { stellateSubdivide(obj); }
+static void opAllFaces( DLFLObjectPtr obj, const DoubleArray& p ) { subdivideAllFaces(obj,param(p,0,1.0) != 0.0); }
+static void opDual( DLFLObjectPtr obj, const DoubleArray& p ) { createDual(obj,param(p,0,0.0) != 0.0); }
+static void opCrust( DLFLObjectPtr obj, const DoubleArray& p ) { createCrust(obj,param(p,0,0.5)); }
+static void opCrustScaled( DLFLObjectPtr obj, const DoubleArray& p ) { createCrustWithScaling(obj,param(p,0,0.9)); }
+static void opSponge( DLFLObjectPtr obj, const DoubleArray& p ) { createSponge(obj,param(p,0,0.67),param(p,1,0.0)); }
+static void opSmooth( DLFLObjectPtr obj, const DoubleArray& ) { meshsmooth(obj); }
+static void opPlanarize( DLFLObjectPtr obj, const DoubleArray& ) { planarize(obj); }
+static void opSpheralize( DLFLObjectPtr obj, const DoubleArray& ) { spheralize(obj); }
+
+static void opRoot3( DLFLObjectPtr obj, const DoubleArray& ) {
+  createDual(obj,true); honeycombSubdivide(obj); createDual(obj,true);
+}
+
+struct BatchOperator {
+  const char *name;
+  const char *params;                   // Parameters and their defaults, for the usage message
+  void (*apply)( DLFLObjectPtr obj, const DoubleArray& params );
+};
+
+// Subdivision schemes have the names used by subdivide() in the dlfl module
+static const BatchOperator operators[] = {
+  { "loop",              "",                   opLoop },
+  { "checker",           "thickness=0.33",     opChecker },
+  { "simplest",          "",                   opSimplest },
+  { "vertex-cut",        "offset=0.25",        opVertexCut },
+  { "pentagon",          "offset=0",           opPentagon },
+  { "pentagon-preserve", "scale=0.75",         opPentagonPreserve },
+  { "honeycomb",         "",                   opHoneycomb },
+  { "doo-sabin",         "check=1",            opDooSabin },
+  { "corner-cut",        "alpha=0",            opCornerCut },
+  { "root4",             "weight=0,twist=0",   opRoot4 },
+  { "catmull-clark",     "",                   opCatmullClark },
+  { "star",              "offset=0",           opStar },
+  { "sqrt3",             "",                   opSqrt3 },
+  { "fractal",           "offset=1",           opFractal },
+  { "stellate",          "",                   opStellate },
+  { "root3",             "",                   opRoot3 },
+  { "allfaces",          "quads=1",            opAllFaces },
+  { "dual",              "accurate=0",         opDual },
+  { "crust",             "thickness=0.5",      opCrust },
+  { "crust-scaled",      "scale=0.9",          opCrustScaled },
+  { "sponge",            "thickness=0.67,collapse=0", opSponge },
+  { "smooth",            "",                   opSmooth },
+  { "planarize",         "",                   opPlanarize },
+  { "spheralize",        "",                   opSpheralize },
+  { NULL, NULL, NULL }
+};
+
+static const BatchOperator * findOperator( const string& name ) {
+  for (int i=0; operators[i].name != NULL; ++i)
+    if ( name == operators[i].name ) return &operators[i];
+  return NULL;
+}
+
+// A step of the job : a script, or an operator with its parameters
+struct BatchStep {
+  string script;
+  const BatchOperator *op;
+  DoubleArray params;
+};
+
+// Parse "name:a,b,.." into an operator step. Returns false if it isn't one
+static bool parseOperator( const string& spec, BatchStep& step ) {
+  string::size_type colon = spec.find(':');
+  step.op = findOperator(spec.substr(0,colon));
+  if ( step.op == NULL ) return false;
+  step.params.clear();
+  if ( colon == string::npos ) return true;
+
+  string rest = spec.substr(colon+1);
+  while ( !rest.empty() ) {
+    string::size_type comma = rest.find(',');
+    string value = rest.substr(0,comma);
+    char *end;
+    double v = strtod(value.c_str(),&end);
+    if ( value.empty() || *end != '\0' ) return false;
+    step.params.push_back(v);
+    rest = ( comma == string::npos ) ? string() : rest.substr(comma+1);
+  }
+  return true;
+}
+
+static void usage( const char *prog ) {
+  cerr << "Usage : " << prog << " [options] input output" << endl
+       << "  -s script.py   run a Python script on the object" << endl
+       << "  -o op[:a,b..]  apply a named operator with optional parameters" << endl
+       << "  -j threads     threads used by the parallel operators, 0 for one per processor" << endl
+       << "Scripts and operators are applied in the order given. Operators :" << endl;
+  for (int i=0; operators[i].name != NULL; ++i) {
+    cerr << "  " << operators[i].name;
+    if ( operators[i].params[0] ) cerr << " : " << operators[i].params;
+    cerr << endl;
+  }
+}
+
+#ifdef WITH_PYTHON
+// Start Python with the dlfl module built in, and import it into __main__
+static bool initPython( const char *prog ) {
+  PyImport_AppendInittab((char*)"dlfl",initdlfl);
+  Py_SetProgramName((char*)prog);
+  Py_Initialize();
+
+  PyObject *dlfl_module = PyImport_ImportModule("dlfl");
+  if ( dlfl_module == NULL ) {
+    PyErr_Print();
+    return false;
+  }
+  PyObject *c_api_object = PyDict_GetItemString(PyModule_GetDict(dlfl_module),"_C_API");
+  if ( c_api_object == NULL || !PyCObject_Check(c_api_object) ) return false;
+  PyDLFL_API = (void **)PyCObject_AsVoidPtr(c_api_object);
+  Py_DECREF(dlfl_module);
+
+  return PyRun_SimpleString("from dlfl import *") == 0;
+}
+
+// Run a script with obj as the current object. Returns the object which is
+// current afterwards, or NULL if the script failed
+static DLFLObjectPtr runScript( const string& script, DLFLObjectPtr obj ) {
+  FILE *fp = fopen(script.c_str(),"r");
+  if ( fp == NULL ) {
+    cerr << "Couldn't open script " << script << endl;
+    return NULL;
+  }
+  char *argv[] = { (char*)script.c_str() };
+  PySys_SetArgv(1,argv);
+  PyDLFL_PassObject(obj);
+  if ( PyRun_SimpleFileEx(fp,script.c_str(),1) != 0 ) {
+    cerr << "Script " << script << " failed" << endl;
+    return NULL;
+  }
+  DLFLObjectPtr current = PyDLFL_CurrentObject();
+  if ( current == NULL )
+    cerr << "Script " << script << " left no current object" << endl;
+  return current;
+}
+#endif
+
+int main( int argc, char **argv ) {
+  vector<BatchStep> steps;
+  vector<char*> files;
+  bool scripts = false;
+
+  for (int i=1; i < argc; ++i) {
+    string arg(argv[i]);
+    if ( ( arg == "-s" || arg == "-o" || arg == "-j" ) && i+1 < argc ) {
+      string value(argv[++i]);
+      BatchStep step;
+      step.op = NULL;
+      if ( arg == "-j" ) {
+        int n = atoi(value.c_str());
+        setSubdivisionThreads(n); setConvexHullThreads(n);
+        continue;
+      } else if ( arg == "-s" ) {
+        step.script = value; scripts = true;
+      } else if ( !parseOperator(value,step) ) {
+        cerr << "Unknown operator or bad parameters : " << value << endl;
+        usage(argv[0]);
+        return 1;
+      }
+      steps.push_back(step);
+    } else if ( arg[0] == '-' ) {
+      usage(argv[0]);
+      return 1;
+    } else {
+      files.push_back(argv[i]);
+    }
+  }
+  if ( files.size() != 2 ) {
+    usage(argv[0]);
+    return 1;
+  }
+
+#ifdef WITH_PYTHON
+  if ( scripts && !initPython(argv[0]) ) {
+    cerr << "Couldn't load the dlfl Python module" << endl;
+    return 1;
+  }
+#else
+  if ( scripts ) {
+    cerr << "Scripts need a build with Python support" << endl;
+    return 1;
+  }
+#endif
+
+  DLFLObjectPtr obj = readObjectFile(files[0]);
+  if ( obj == NULL ) {
+    cerr << "Couldn't read " << files[0] << endl;
+    return 1;
+  }
+
+  for (int i=0; i < (int)steps.size(); ++i) {
+    const BatchStep& step = steps[i];
+    if ( step.op ) {
+      step.op->apply(obj,step.params);
+      continue;
+    }
+#ifdef WITH_PYTHON
+    obj = runScript(step.script,obj);
+    if ( obj == NULL ) return 1;
+#endif
+  }
+
+  obj->computeNormals();
+  if ( !writeObjectFile(obj,files[1]) ) {
+    cerr << "Couldn't write " << files[1] << endl;
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,48 @@
+# Command line tool applying DLFL operators and Python scripts without the GUI.
+# Build the libraries in ../include first
+TEMPLATE = app
+CONFIG -= qt app_bundle
+CONFIG += console release warn_on
+TARGET = topmod-batch
+DESTDIR = ..
+
+# exclude the python module with CONFIG -= WITH_PYTHON
+CONFIG += WITH_PYTHON
+
+INCLUDEPATH += ../include ../include/vecmat ../include/dlflcore ../include/dlflaux
+QMAKE_LFLAGS += -L../lib
+LIBS += -ldlflaux -ldlflcore -lvecmat
+
+SOURCES += TopModBatch.cc
+
+CONFIG(WITH_PYTHON){
+	message("PYTHON support will be included")
+	DEFINES *= WITH_PYTHON
+	# The dlfl module is built into the tool instead of loaded from dlfl.so
+	SOURCES += ../include/pydlfl/DLFLModule.cc
+}
+
+macx {
+	CONFIG += x86 ppc
+	CONFIG(WITH_PYTHON){
+		INCLUDEPATH += /Library/Frameworks/Python.framework/Versions/2.5/include/python2.5 
+		QMAKE_LFLAGS += -L/Library/Frameworks/Python.framework 
+		LIBS += -framework Python
+	}
+} else:unix {
+	QMAKE_CXXFLAGS += -fopenmp
+	QMAKE_LFLAGS += -fopenmp
+	DEFINES *= LINUX
+	CONFIG(WITH_PYTHON){
+		INCLUDEPATH += /usr/include/python2.5
+		LIBS += -lpython2.5 -L/usr/lib/python2.5/config
+	}
+} else:win32 {
+	QMAKE_CXXFLAGS += -fopenmp
+	QMAKE_LFLAGS += -fopenmp
+	CONFIG(WITH_PYTHON){
+		INCLUDEPATH += C:/Python25/include
+		QMAKE_LFLAGS += -LC:/Python25/libs
+		LIBS += -lpython25
+	}
+}
@@ -100,6 +100,19 @@ void Camera::SetCamera(){
 	gluLookAt(EYE[0],EYE[1],EYE[2],CENTER[0],CENTER[1],CENTER[2],UP[0],UP[1],UP[2]);
 }
 
+/*!
+* \brief the matrix gluLookAt builds in SetCamera, so picking can be done without GL
+*/
+void Camera::GetViewMatrix(double *m){
+	Vector3d f = normalized(CENTER-EYE);
+	Vector3d s = normalized(f%UP);
+	Vector3d u = s%f;
+	m[0] = s[0]; m[4] = s[1]; m[8] = s[2];  m[12] = -(s*EYE);
+	m[1] = u[0]; m[5] = u[1]; m[9] = u[2];  m[13] = -(u*EYE);
+	m[2] =-f[0]; m[6] =-f[1]; m[10]=-f[2];  m[14] = f*EYE;
+	m[3] = 0.0;  m[7] = 0.0;  m[11]= 0.0;   m[15] = 1.0;
+}
+
 
 
 /* ***************** ORTHO CAM ************************/
@@ -168,6 +181,18 @@ void OrthoCamera::SetProjection(int WinX, int WinY) {
 	SetCamera();
 }
 
+/*!
+* \brief the glOrtho matrix of SetProjection
+*/
+void OrthoCamera::GetProjectionMatrix(int WinX, int WinY, double *m) {
+	float aspect = WinX/(float)WinY;
+	for (int i = 0; i < 16; i++) m[i] = 0.0;
+	m[0] = 1.0/(zoom*aspect);
+	m[5] = 1.0/zoom;
+	m[10] = -2.0/20.0;
+	m[15] = 1.0;
+}
+
 
 
 void OrthoCamera::HandleMouseMotion(int x, int y, int WinX, int WinY) {
@@ -256,6 +281,20 @@ void PerspCamera::SetProjection(int WinX, int WinY) {
 	SetCamera();
 }
 
+/*!
+* \brief the gluPerspective matrix of SetProjection
+*/
+void PerspCamera::GetProjectionMatrix(int WinX, int WinY, double *m) {
+	double aspect = WinX/(float)WinY;
+	double f = 1.0/tan(FOV*M_PI/360.0);
+	for (int i = 0; i < 16; i++) m[i] = 0.0;
+	m[0] = f/aspect;
+	m[5] = f;
+	m[10] = (farplane+nearplane)/(nearplane-farplane);
+	m[11] = -1.0;
+	m[14] = 2.0*farplane*nearplane/(nearplane-farplane);
+}
+
 
 void PerspCamera::HandleMouseMotion(int x, int y,int WinX, int WinY) {
   if(ALT_DOWN==1){
@@ -84,9 +84,11 @@ public:
 	void Reset();
 	void HandleMouseEvent(Qt::MouseButton button, QEvent::Type state, int x, int y);
 	void SetCamera();
+	void GetViewMatrix(double *m);                                           //!< \brief matrix set by SetCamera, column major
 	
 	virtual void DrawGrid(int size, int spacing)=0;
 	virtual void SetProjection(int WinX, int WinY)=0;
+	virtual void GetProjectionMatrix(int WinX, int WinY, double *m)=0;     //!< \brief matrix set by SetProjection without the pick matrix, column major
 	virtual void HandleMouseMotion(int x, int y, int WinX, int WinY)=0;
 	virtual void HandleMouseWheel(int delta, int WinX, int WinY)=0;
 	virtual void enterSelectionMode(double x, double y, double w, double h, GLint * vp)=0;
@@ -131,6 +133,7 @@ public:
 	
 	virtual void DrawGrid(int size=500, int spacing=1);
 	virtual void SetProjection(int WinX, int WinY);
+	virtual void GetProjectionMatrix(int WinX, int WinY, double *m);
 	virtual void HandleMouseMotion(int x, int y, int WinX, int WinY);
 	virtual void HandleMouseWheel(int delta, int WinX, int WinY);
 	virtual void enterSelectionMode(double x, double y, double w, double h, GLint * vp);
@@ -152,6 +155,7 @@ public:
 	
 	virtual void DrawGrid(int size=10, int spacing=1);
 	virtual void SetProjection(int WinX, int WinY);
+	virtual void GetProjectionMatrix(int WinX, int WinY, double *m);
 	virtual void HandleMouseMotion(int x, int y, int WinX, int WinY);
 	virtual void HandleMouseWheel(int delta, int WinX, int WinY);
 	virtual void enterSelectionMode(double x, double y, double w, double h, GLint * vp);
@@ -39,47 +39,29 @@
 namespace DLFL {
 
   void spheralize( DLFLObjectPtr obj ) {
-    DLFLVertexPtrList::iterator vl_first, vl_last;
-    int num_vertices=0; 
+    const DLFLSnapshot& mesh = obj->snapshot();
+    int num_vertices = mesh.numVertices();
     Vector3d center;
-    DLFLVertexPtr vertexptr;
-    Vector3d buffer;
 
-    vl_first = obj->beginVertex();
-    vl_last  = obj->endVertex();
-
-    while ( vl_first != vl_last ) {
-      vertexptr = (*vl_first); ++vl_first;
-
-      center += vertexptr->coords; 
-      num_vertices++; 
-    }
+    for (int v=0; v < num_vertices; ++v) center += mesh.positions[v];
     center /= num_vertices;
 
-    vl_first = obj->beginVertex();
-    vl_last  = obj->endVertex();
-
-    while ( vl_first != vl_last ) {
-      vertexptr = (*vl_first); ++vl_first;
-
-      Vector3d new_pos = vertexptr->coords; // This is the old position
-
-      buffer = new_pos-center;
+#pragma omp parallel for schedule(static)
+    for (int v=0; v < num_vertices; ++v) {
+      Vector3d buffer = mesh.positions[v]-center;
       normalize(buffer); 
-      vertexptr->coords = buffer; /*+center;*/
+      mesh.vertices[v]->coords = buffer; /*+center;*/
     }
   }
 
   void planarize( DLFLObjectPtr obj ) {
-    DLFLFacePtrList::iterator fl_first, fl_last;
-    DLFLFacePtr faceptr;
-  
-    fl_first = obj->beginFace();
-    fl_last = obj->endFace();
+    const DLFLSnapshot& mesh = obj->snapshot();
+    int num_faces = mesh.numFaces(), num_verts = mesh.numVertices();
 
     /* Loop through all faces */
-    while ( fl_first != fl_last ) {
-      faceptr = (*fl_first); ++fl_first;
+#pragma omp parallel for schedule(static)
+    for (int f=0; f < num_faces; ++f) {
+      DLFLFacePtr faceptr = mesh.faces[f];
 
       /*
 	Find the average normal for the face and the centroid
@@ -95,38 +77,17 @@ namespace DLFL {
       */
     }
 
-    DLFLVertexPtrList::iterator vl_first, vl_last;
-    DLFLVertexPtr vertexptr;
-    DLFLFaceVertexPtrArray fvparray;
-    Vector3dArray p_array, n_array; // Arrays of point and normals for each face adjacent to a vertex
-    int num_faces;
-  
-    vl_first = obj->beginVertex();
-    vl_last = obj->endVertex();
-
-    /* Loop through all vertices */
-    while ( vl_first != vl_last ) {
-      vertexptr = (*vl_first); ++vl_first;
-
-      /*
-	Get all the corners for this vertex
-      */
-      fvparray.clear(); // The local array must be cleared before calling getFaceVertices
-      vertexptr->getFaceVertices(fvparray);
-      num_faces = fvparray.size();
-       
+    /* Loop through all vertices. Each one only depends on the faces around it */
+#pragma omp parallel for schedule(static)
+    for (int v=0; v < num_verts; ++v) {
       /*
-	Go through the array of face-vertices and find the normal and centroid
+	Go through the corners of this vertex and find the normal and centroid
 	for each face
       */
-      p_array.clear(); n_array.clear(); // The local arrays must be cleared for each Vertex
-
-      // If we resize the array before filling it, we can avoid unnecessary memory allocation
-      // thus speeding up the process a little bit.
-      //p_array.resize(num_faces,Vector3d(0)); n_array.resize(num_faces,Vector3d(0));
-      p_array.resize(num_faces,Vector3d()); n_array.resize(num_faces,Vector3d());
+      int num_faces = mesh.valence(v);
+      Vector3dArray p_array(num_faces), n_array(num_faces); // Point and normal for each face adjacent to the vertex
       for (int i=0; i <num_faces; ++i) {
-	DLFLFacePtr fp = fvparray[i]->getFacePtr();
+	DLFLFacePtr fp = mesh.faces[mesh.corner_face[mesh.vertex_corners[mesh.vertex_start[v]+i]]];
 
 	// Get the normal and centroid for this face (which we calculated above)
 	// and store them in our local arrays
@@ -136,7 +97,7 @@ namespace DLFL {
 	//cout << "After p = " << p_array[i] << " n = " << n_array[i] << endl << endl; 	    
       }
 
-      Vector3d new_pos = vertexptr->coords; // This is the old position
+      Vector3d new_pos = mesh.positions[v]; // This is the old position
 
       Vector3d buffer1,buffer2; 
       float t, deltat; int m; 
@@ -190,7 +151,7 @@ namespace DLFL {
 	Use the 2 arrays (n_array and p_array) to compute the new position for this vertex
       */
        
-      vertexptr->coords = new_pos;
+      mesh.vertices[v]->coords = new_pos;
     }
   }
 
@@ -37,12 +37,284 @@
 #include "DLFLSubdiv.hh"
 #include <DLFLCore.hh>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace DLFL {
 
-  long DLFLConvexHull::remove = 1;               // Edge needs to be removed
-  long DLFLConvexHull::border = 2;                  // Edge is a border edge
-  long DLFLConvexHull::visible = 1;        // Face is visible from new point
-  long DLFLConvexHull::invisible = 2;    // Face is invisible from new point
+  // Requested thread count, 0 for one per processor
+  static int chullThreads = 0;
+
+  void setConvexHullThreads( int n ) {
+    chullThreads = ( n < 0 ) ? 0 : n;
+  }
+
+  int convexHullThreads( ) {
+#ifdef _OPENMP
+    return ( chullThreads > 0 ) ? chullThreads : omp_get_max_threads();
+#else
+    return 1;
+#endif
+  }
+
+  // Below this many points per thread the hull is built by a single thread
+  static const int chullPointsPerThread = 50000;
+
+  // Triangle of the hull under construction. Edge i goes from v[i] to v[(i+1)%3]
+  // and adj[i] is the triangle on the other side of it. The outside list holds
+  // the points not yet added which can see this triangle (its conflict list)
+  struct HullTriangle {
+    int v[3];
+    int adj[3];
+    Vector3d normal;             // (v1-v0) x (v2-v0), not normalized
+    double length;               // Length of normal
+    IntArray outside;
+    bool removed;
+    int visited;
+  };
+
+  // Incremental hull with conflict lists. Every point outside the hull is kept
+  // in the list of one triangle it can see. The triangle's farthest point is
+  // added next : the triangles it sees are found by walking from that triangle,
+  // replaced by a cone of triangles to the point, and only their points are
+  // assigned again, to the new triangles. Each point is therefore tested against
+  // a few triangles instead of the whole hull
+  class HullBuilder {
+  public :
+
+    HullBuilder( const Vector3dArray& p )
+      : points(p), start(p.size(),-1), inside(0), stamp(0) { }
+
+    // Build the hull. Returns false if all the points are coplanar
+    bool build( );
+
+    // Number of points which ended up inside the hull
+    int numInside( ) const { return inside; }
+
+    // Indices of the points on the hull, in increasing order
+    void getVertices( IntArray& verts ) const;
+
+    // The triangles of the hull, with adj giving positions in the returned array
+    void getTriangles( vector<HullTriangle>& hull ) const;
+
+  private :
+
+    const Vector3dArray& points;
+    vector<HullTriangle> tris;
+    IntArray start;              // Cone triangle starting at each horizon vertex
+    int inside;
+    int stamp;
+
+    // Same test as DLFLConvexHull::volumeSign(face,p) < 0 for a face with these 3 vertices
+    bool sees( const HullTriangle& t, int p ) const {
+      return t.normal * (points[p] - points[t.v[0]]) > 6.0*ZERO;
+    }
+
+    double distance( const HullTriangle& t, int p ) const {
+      return t.normal * (points[p] - points[t.v[0]]) / t.length;
+    }
+
+    int addTriangle( int a, int b, int c ) {
+      HullTriangle t;
+      t.v[0] = a; t.v[1] = b; t.v[2] = c;
+      t.adj[0] = t.adj[1] = t.adj[2] = -1;
+      t.normal = (points[b]-points[a]) % (points[c]-points[a]);
+      t.length = norm(t.normal);
+      t.removed = false; t.visited = 0;
+      tris.push_back(t);
+      return tris.size()-1;
+    }
+
+    // Edge of triangle t which goes from a to b
+    int edge( int t, int a, int b ) const {
+      for (int i=0; i < 3; ++i)
+        if ( tris[t].v[i] == a && tris[t].v[(i+1)%3] == b ) return i;
+      return -1;
+    }
+
+    // Put point p in the list of the first of the triangles which it can see
+    void assign( int p, const IntArray& candidates ) {
+      for (int i=0; i < candidates.size(); ++i)
+        if ( sees(tris[candidates[i]],p) ) {
+          tris[candidates[i]].outside.push_back(p);
+          return;
+        }
+      ++inside;
+    }
+
+    bool createSimplex( IntArray& simplex );
+    void addPoint( int t, IntArray& stack );
+  };
+
+  bool HullBuilder::createSimplex( IntArray& simplex ) {
+    // Start from the 2 points furthest apart among the extremes along each axis,
+    // the point furthest from the line through them and the point furthest from
+    // the plane through those 3
+    int numpoints = points.size();
+    if ( numpoints < 4 ) return false;
+    int extremes[6] = { 0, 0, 0, 0, 0, 0 };
+    for (int i=1; i < numpoints; ++i)
+      for (int k=0; k < 3; ++k) {
+        if ( points[i][k] < points[extremes[2*k]][k] ) extremes[2*k] = i;
+        if ( points[i][k] > points[extremes[2*k+1]][k] ) extremes[2*k+1] = i;
+      }
+
+    int i0 = 0, i1 = 0, i2 = 0, i3 = 0;
+    double d, maxd = 0.0;
+    for (int j=0; j < 6; ++j)
+      for (int k=j+1; k < 6; ++k) {
+        d = normsqr(points[extremes[j]]-points[extremes[k]]);
+        if ( d > maxd ) { maxd = d; i0 = extremes[j]; i1 = extremes[k]; }
+      }
+    if ( !isNonZero(maxd) ) return false;
+
+    maxd = 0.0;
+    Vector3d dir = points[i1]-points[i0];
+    for (int i=0; i < numpoints; ++i) {
+      d = normsqr(dir % (points[i]-points[i0]));
+      if ( d > maxd ) { maxd = d; i2 = i; }
+    }
+    if ( !isNonZero(maxd) ) return false;
+
+    maxd = 0.0;
+    Vector3d normal = dir % (points[i2]-points[i0]);
+    for (int i=0; i < numpoints; ++i) {
+      d = Abs(normal * (points[i]-points[i0]));
+      if ( d > maxd ) { maxd = d; i3 = i; }
+    }
+    if ( maxd <= 6.0*ZERO ) return false;
+
+    // The base triangle faces away from the 4th point
+    if ( normal * (points[i3]-points[i0]) > 0.0 ) swap(i1,i2);
+    addTriangle(i0,i1,i2);
+    addTriangle(i1,i0,i3);
+    addTriangle(i2,i1,i3);
+    addTriangle(i0,i2,i3);
+    for (int t=0; t < 4; ++t)
+      for (int i=0; i < 3; ++i)
+        for (int u=0; u < 4; ++u)
+          if ( u != t && edge(u,tris[t].v[(i+1)%3],tris[t].v[i]) >= 0 ) tris[t].adj[i] = u;
+
+    simplex.clear();
+    simplex.push_back(i0); simplex.push_back(i1); simplex.push_back(i2); simplex.push_back(i3);
+    return true;
+  }
+
+  bool HullBuilder::build( ) {
+    IntArray simplex;
+    if ( !createSimplex(simplex) ) return false;
+
+    IntArray candidates, stack;
+    for (int t=0; t < 4; ++t) candidates.push_back(t);
+    vector<bool> used(points.size(),false);
+    for (int i=0; i < 4; ++i) used[simplex[i]] = true;
+    for (int p=0; p < points.size(); ++p)
+      if ( !used[p] ) assign(p,candidates);
+
+    for (int t=0; t < 4; ++t)
+      if ( !tris[t].outside.empty() ) stack.push_back(t);
+    while ( !stack.empty() ) {
+      int t = stack.back(); stack.pop_back();
+      if ( !tris[t].removed && !tris[t].outside.empty() ) addPoint(t,stack);
+    }
+    return true;
+  }
+
+  void HullBuilder::addPoint( int t, IntArray& stack ) {
+    // Take the point furthest from the triangle out of its list. Of equally
+    // far points, such as duplicates, the first one in the input is used
+    IntArray& outside = tris[t].outside;
+    int farthest = 0;
+    double d, maxd = distance(tris[t],outside[0]);
+    for (int i=1; i < outside.size(); ++i) {
+      d = distance(tris[t],outside[i]);
+      if ( d > maxd || ( d == maxd && outside[i] < outside[farthest] ) ) { maxd = d; farthest = i; }
+    }
+    int p = outside[farthest];
+    outside[farthest] = outside.back(); outside.pop_back();
+
+    // Walk over the triangles p can see, starting from t. The edges between
+    // those and the rest form the horizon
+    IntArray visible, horizon;
+    ++stamp;
+    visible.push_back(t); tris[t].visited = stamp;
+    for (int k=0; k < visible.size(); ++k) {
+      HullTriangle& vt = tris[visible[k]];
+      for (int i=0; i < 3; ++i) {
+        int u = vt.adj[i];
+        if ( tris[u].visited == stamp ) continue;
+        if ( sees(tris[u],p) ) {
+          tris[u].visited = stamp; visible.push_back(u);
+        } else horizon.push_back(3*visible[k]+i);
+      }
+    }
+
+    // Rounding can make the visible triangles a region whose border isn't a
+    // single loop. The point is left out in that case, since it is at most
+    // rounding error away from the hull
+    bool simple = true;
+    for (int h=0; h < horizon.size(); ++h) {
+      int a = tris[horizon[h]/3].v[horizon[h]%3];
+      if ( start[a] >= 0 ) simple = false;
+      start[a] = h;
+    }
+    for (int h=0; h < horizon.size(); ++h)
+      start[tris[horizon[h]/3].v[horizon[h]%3]] = -1;
+    if ( !simple ) {
+      ++inside;
+      return;
+    }
+
+    // Cone of triangles from each horizon edge to p
+    IntArray cone; cone.reserve(horizon.size());
+    for (int h=0; h < horizon.size(); ++h) {
+      int vt = horizon[h]/3, i = horizon[h]%3;
+      int a = tris[vt].v[i], b = tris[vt].v[(i+1)%3], u = tris[vt].adj[i];
+      int n = addTriangle(a,b,p);
+      tris[n].adj[0] = u;
+      tris[u].adj[edge(u,b,a)] = n;
+      start[a] = n;
+      cone.push_back(n);
+    }
+    for (int h=0; h < cone.size(); ++h) {
+      int n = cone[h];
+      int m = start[tris[n].v[1]];
+      tris[n].adj[1] = m; tris[m].adj[2] = n;
+    }
+    for (int h=0; h < cone.size(); ++h) start[tris[cone[h]].v[0]] = -1;
+
+    // Only points which could see a removed triangle can see the new ones
+    for (int k=0; k < visible.size(); ++k) {
+      HullTriangle& vt = tris[visible[k]];
+      vt.removed = true;
+      for (int i=0; i < vt.outside.size(); ++i) assign(vt.outside[i],cone);
+      IntArray().swap(vt.outside);
+    }
+    for (int h=0; h < cone.size(); ++h)
+      if ( !tris[cone[h]].outside.empty() ) stack.push_back(cone[h]);
+  }
+
+  void HullBuilder::getVertices( IntArray& verts ) const {
+    vector<bool> onhull(points.size(),false);
+    for (int t=0; t < tris.size(); ++t)
+      if ( !tris[t].removed )
+        onhull[tris[t].v[0]] = onhull[tris[t].v[1]] = onhull[tris[t].v[2]] = true;
+    verts.clear();
+    for (int i=0; i < onhull.size(); ++i)
+      if ( onhull[i] ) verts.push_back(i);
+  }
+
+  void HullBuilder::getTriangles( vector<HullTriangle>& hull ) const {
+    IntArray position(tris.size(),-1);
+    hull.clear();
+    for (int t=0; t < tris.size(); ++t)
+      if ( !tris[t].removed ) {
+        position[t] = hull.size(); hull.push_back(tris[t]);
+      }
+    for (int t=0; t < hull.size(); ++t)
+      for (int i=0; i < 3; ++i) hull[t].adj[i] = position[hull[t].adj[i]];
+  }
 
   // Are the 3 given points colinear?
   bool DLFLConvexHull::colinear(const Vector3d& p1, const Vector3d& p2, const Vector3d& p3) {
@@ -134,111 +406,105 @@ namespace DLFL {
     return true;
   }
 
-  bool DLFLConvexHull::addOne(InputVertex& iv) {
-    // Add given vertex to hull
-    // Assumes that iv has not been processed yet
-
-    Vector3d p = iv.point;
-    bool foundvisible = false;
-  
-    // Mark the faces that are visible from p (iv)
-    DLFLFacePtrList::iterator ffirst, flast;
-    DLFLFacePtr fp;
-  
-    ffirst = face_list.begin(); flast = face_list.end();
-    while ( ffirst != flast ) {
-      fp = (*ffirst); ++ffirst;
-      if ( DLFLConvexHull::volumeSign(fp,p) < 0 ) {
-	fp->flags = DLFLConvexHull::visible;
-	foundvisible = true;
-      } else
-	fp->flags = DLFLConvexHull::invisible;
-    }
-
-    // If no faces are visible from p then p is inside the hull
-    if ( foundvisible == false ) {
-      iv.onhull = false;
-      return false;
+  bool DLFLConvexHull::constructHull( ) {
+    int numverts = vertices.size();
+    Vector3dArray points(numverts);
+    for (int i=0; i < numverts; ++i) {
+      points[i] = vertices[i].point;
+      vertices[i].processed = true; vertices[i].onhull = false;
     }
 
-    // Mark edges in the interior of visible region for deletion
-    // Create a new face based on each border edge
-    // A border edge is one where only one of the adjacent faces is visible
-    DLFLEdgePtrList::iterator efirst, elast;
-    DLFLEdgePtr ep;
-    DLFLFacePtr fp1,fp2;
-    DLFLEdgePtrList remove_list; // List of edges to be removed
-    DLFLEdgePtrList border_list; // List of border edges
-
-    efirst = edge_list.begin(); elast = edge_list.end();
-    while ( efirst != elast ) {
-      ep = (*efirst); ++efirst;
-      ep->getFacePointers(fp1,fp2);
-      if ( fp1->flags == DLFLConvexHull::visible && fp2->flags == DLFLConvexHull::visible ) {
-	// Interior edge : add edge to remove_list
-	remove_list.push_back(ep);
-      } else if ( fp1->flags == DLFLConvexHull::visible || fp2->flags == DLFLConvexHull::visible ) {
-	// Border edge : add edge to border_list
-	border_list.push_back(ep);
+    // Large point sets are split into a part for each thread. A point can
+    // only be on the hull of all the points if it is on the hull of its part,
+    // so the final hull is built from the points on the hulls of the parts
+    IntArray candidates;
+    int nparts = min(convexHullThreads(),numverts/chullPointsPerThread);
+    if ( nparts > 1 ) {
+      vector<IntArray> partverts(nparts);
+#pragma omp parallel for num_threads(nparts) schedule(static,1)
+      for (int k=0; k < nparts; ++k) {
+        int first = numverts*k/nparts, last = numverts*(k+1)/nparts;
+        Vector3dArray part(points.begin()+first,points.begin()+last);
+        HullBuilder builder(part);
+        if ( builder.build() ) builder.getVertices(partverts[k]);
+        else for (int i=0; i < last-first; ++i) partverts[k].push_back(i);
+        for (int i=0; i < partverts[k].size(); ++i) partverts[k][i] += first;
       }
+      for (int k=0; k < nparts; ++k)
+        candidates.insert(candidates.end(),partverts[k].begin(),partverts[k].end());
+    } else {
+      candidates.resize(numverts);
+      for (int i=0; i < numverts; ++i) candidates[i] = i;
     }
 
-    // Go through remove_list and remove all edges
-    while ( !remove_list.empty() ) {
-      ep = remove_list.front(); remove_list.pop_front();
-      deleteEdge(this,ep,true);
-    }
-
-    // Find the face bounded by the border edges - call it the conebase
-    // This can be done by taking any border edge and finding the face
-    // adjacent to it which is not invisible.
-    DLFLFacePtr conebase = NULL;
-
-    ep = border_list.front();
-    ep->getFacePointers(fp1,fp2);
-
-    if ( fp1->flags == DLFLConvexHull::invisible ) conebase = fp2;
-    else if ( fp2->flags == DLFLConvexHull::invisible ) conebase = fp1;
-    else {
-      // This should not happen. Problem somewhere
-      cout << "Oops! Something went wrong somewhere!" << endl;
+    Vector3dArray hullpoints(candidates.size());
+    for (int i=0; i < candidates.size(); ++i) hullpoints[i] = points[candidates[i]];
+    HullBuilder builder(hullpoints);
+    if ( builder.build() == false ) {
+      // All points are within rounding error of a plane or line.
+      // Make the initial double-triangle, as far as it can be made
+      reset();
+      doubleTriangle();
+      cout << "Could not form initial polytope" << endl;
       return false;
     }
 
-    // Subdivide the conebase face using triangles. This will create a new point
-    // at the centroid, which can then simply be moved to the apex of the cone
-    subdivideFace(this,conebase,false);
-
-    // The centroid will be the last DLFLVertex in the vertex_list
-    DLFLVertexPtr apex = vertex_list.back();
-
-    // Adjust coordinates of the apex to be the new point we are adding to the hull
-    apex->coords = p;
-    apex->CHullIndex = iv.index;
-
-    return true;
-  }
-  
+    // Create the DLFL elements directly from the triangles. Vertices are
+    // created in the order of the input points
+    IntArray hullverts;
+    vector<HullTriangle> tris;
+    builder.getVertices(hullverts);
+    builder.getTriangles(tris);
+
+    DLFLVertexPtrArray newverts(hullpoints.size(),(DLFLVertexPtr)NULL);
+    DLFLVertexPtr vp;
+    for (int i=0; i < hullverts.size(); ++i) {
+      int iv = candidates[hullverts[i]];
+      vp = new DLFLVertex(points[iv]);
+      vp->CHullIndex = vertices[iv].index; // Esan
+      vertices[iv].onhull = true;
+      newverts[hullverts[i]] = vp;
+      addVertexPtr(vp);
+    }
 
-  bool DLFLConvexHull::constructHull( ) {
-    // Create Initial double-triangle
-    if ( doubleTriangle() == false ) {
-      cout << "Could not form initial polytope" << endl;
-      return false;
+    DLFLFacePtrArray newfaces(tris.size());
+    DLFLFaceVertexPtrArray corners(3*tris.size());
+    DLFLFacePtr fp;
+    for (int t=0; t < tris.size(); ++t) {
+      fp = new DLFLFace;
+      for (int i=0; i < 3; ++i) {
+        corners[3*t+i] = new DLFLFaceVertex;
+        corners[3*t+i]->vertex = newverts[tris[t].v[i]];
+        fp->addVertexPtr(corners[3*t+i]);
+      }
+      newfaces[t] = fp;
     }
 
-    // Go through list of InputVertices and add ones which have not been processed yet
-    InputVertex iv;
-    bool retval = true; // Tells us if any vertex is inside convex hull
-    for (int i=0; i < vertices.size(); ++i) {
-      iv = vertices[i];
-      if ( !iv.processed ) {
-	iv.index = vertices[i].index; // Esan
-	iv.processed = true;
-	retval = addOne(iv);
+    // The edge from v[i] to v[i+1] of a triangle starts at its i'th corner,
+    // and at the corner of v[i+1] in the adjacent triangle
+    DLFLEdgePtr ep;
+    for (int t=0; t < tris.size(); ++t)
+      for (int i=0; i < 3; ++i) {
+        int u = tris[t].adj[i];
+        if ( u < t ) continue;
+        int j = 0;
+        while ( tris[u].v[j] != tris[t].v[(i+1)%3] ) ++j;
+        ep = new DLFLEdge;
+        ep->setFaceVertexPointers(corners[3*t+i],corners[3*u+j],false);
+        ep->updateFaceVertices();
+        addEdgePtr(ep);
       }
+
+    for (int t=0; t < newfaces.size(); ++t) {
+      fp = newfaces[t];
+      fp->setMaterial(firstMaterial());
+      fp->updateFacePointers();
+      fp->addFaceVerticesToVertices();
+      addFacePtr(fp);
     }
-    return retval;
+
+    // Tells us if any vertex is inside convex hull
+    return ( hullverts.size() == numverts );
   }
 
   // Create a convex hull from given list of vertices
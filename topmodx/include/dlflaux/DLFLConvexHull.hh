@@ -37,15 +37,15 @@
 
 namespace DLFL {
 
+  // Number of threads used to build convex hulls of large point sets. 0 means one
+  // per processor. The points are split between the threads, and the hull of the
+  // points on the hulls of the parts is the same as the hull of all the points
+  void setConvexHullThreads( int n );
+  int convexHullThreads( );
+
   class DLFLConvexHull : public DLFLObject {
   protected :
 
-    // Bit flags for use during hull construction
-    static long remove;                   // Edge needs to be removed
-    static long border;                      // Edge is a border edge
-    static long visible;            // Face is visible from new point
-    static long invisible;        // Face is invisible from new point
-
     // Structure for storing the input vertices
     struct InputVertex {
     public :
@@ -130,9 +130,6 @@ namespace DLFL {
 
     // Create the initial polytope
     bool doubleTriangle( );
-     
-    // Add a vertex from the list to the convex hull
-    bool addOne(InputVertex& iv);
 
     // Construct the hull from given array of points
     // Returns false is any of the given points is not on the convex hull
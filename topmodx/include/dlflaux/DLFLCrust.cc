@@ -55,7 +55,7 @@ namespace DLFL {
     for normal averaging.
   */
 
-  void createCrust(const DLFLObjectPtr obj, double thickness, bool uniform) {
+  void createCrust(const DLFLObjectPtr obj, double thickness, bool uniform, DLFLProgressPtr progress) {
     if ( !isNonZero(thickness) ) return;
 
     // Clear the arrays used to store crust modeling information
@@ -65,17 +65,12 @@ namespace DLFL {
     crust_num_old_faces = obj->num_faces();
     crustfp1.resize(crust_num_old_faces,NULL);
     crustfp2.resize(crust_num_old_faces,NULL);
-  
-    StringStream dlflstream; // Stream used to duplicate the object
-    StringStream mtlstream; // Stream used to duplicate the object
-
-    // Write the object in DLFL format with the faces reversed
-    obj->writeDLFL(dlflstream,mtlstream, true);
 
     int num_old_verts = obj->num_vertices();
 
-    // Read back from the stream and append to existing object
-    obj->readDLFL(dlflstream,mtlstream, false);
+    // Append a copy of the object with the faces reversed
+    obj->append(*obj,true);
+    if ( progress ) progress->setMaximum(2*crust_num_old_faces+num_old_verts);
 
     // Fill the arrays storing information for crust modeling
     // Since we are traversing the faces, also compute and store
@@ -85,12 +80,14 @@ namespace DLFL {
     int num_faces = 0;
     fl_first = obj->beginFace(); fl_last = obj->endFace();
     while ( num_faces < crust_num_old_faces ) {
+      if ( progress && !progress->step() ) return;
       fp = *fl_first;
       crustfp1[num_faces] = fp; fp->makeUnique(); fp->storeNormals();
       ++fl_first; ++num_faces;
     }
     num_faces = 0; 
     while ( fl_first != fl_last ) {
+      if ( progress && !progress->step() ) return;
       fp = *fl_first;
       crustfp2[num_faces] = fp; fp->makeUnique(); fp->storeNormals();
       ++fl_first; ++num_faces;
@@ -108,6 +105,7 @@ namespace DLFL {
     if ( thickness < 0.0 ) {
       vl_first = obj->beginVertex();
       while ( num_verts < num_old_verts ) {
+				if ( progress && !progress->step() ) return;
 				vp = (*vl_first); ++vl_first; ++num_verts;
 
 				// If uniform thickness is required, adjust thickness appropriately
@@ -132,6 +130,7 @@ namespace DLFL {
       vl_first = obj->beginVertex(); vl_last = obj->endVertex();
       advance(vl_first,num_old_verts);
       while ( vl_first != vl_last ) {
+				if ( progress && !progress->step() ) return;
 				vp = (*vl_first); ++vl_first;
 				// If uniform thickness is required, adjust thickness appropriately
 				if ( uniform ) {
@@ -162,7 +161,7 @@ namespace DLFL {
     w.r.t centroid of object.
   */
 
-  void createCrustWithScaling(DLFLObjectPtr obj, double scale_factor) {
+  void createCrustWithScaling(DLFLObjectPtr obj, double scale_factor, DLFLProgressPtr progress) {
     if ( !isNonZero(scale_factor) ) return;
   
     // Clear the arrays used to store crust modeling information
@@ -172,12 +171,6 @@ namespace DLFL {
     crust_num_old_faces = obj->num_faces();
     crustfp1.resize(crust_num_old_faces,NULL);
     crustfp2.resize(crust_num_old_faces,NULL);
-  
-    StringStream dlflstream; // Stream used to duplicate the object
-    StringStream mtlstream; // Stream used to duplicate the object
-
-    // Write the object in DLFL format with the faces reversed
-    obj->writeDLFL(dlflstream, mtlstream, true);
 
     int num_old_verts = 0;
     Vector3d objcen;
@@ -191,8 +184,9 @@ namespace DLFL {
     }
     objcen /= num_old_verts;
 
-    // Read back from the stream and append to existing object
-    obj->readDLFL(dlflstream, mtlstream, false);
+    // Append a copy of the object with the faces reversed
+    obj->append(*obj,true);
+    if ( progress ) progress->setMaximum(2*crust_num_old_faces+num_old_verts);
 
     // Fill the arrays storing information for crust modeling
     DLFLFacePtrList::iterator fl_first, fl_last;
@@ -200,12 +194,14 @@ namespace DLFL {
     int num_faces = 0;
     fl_first = obj->beginFace(); fl_last = obj->endFace();
     while ( num_faces < crust_num_old_faces ) {
+      if ( progress && !progress->step() ) return;
       fp = *fl_first;
       crustfp1[num_faces] = fp; fp->makeUnique();
       ++fl_first; ++num_faces;
     }
     num_faces = 0; 
     while ( fl_first != fl_last ) {
+      if ( progress && !progress->step() ) return;
       fp = *fl_first;
       crustfp2[num_faces] = fp; fp->makeUnique();
       ++fl_first; ++num_faces;
@@ -226,6 +222,7 @@ namespace DLFL {
       scale_factor = -1.0/scale_factor;
       vl_first = obj->beginVertex();
       while ( num_verts < num_old_verts ) {
+				if ( progress && !progress->step() ) return;
 				vp = (*vl_first); ++vl_first; ++num_verts;
 				newpos = (vp->coords - objcen)*scale_factor + objcen;
 				vp->coords = newpos;
@@ -235,6 +232,7 @@ namespace DLFL {
       vl_first = obj->beginVertex(); vl_last = obj->endVertex();
       advance(vl_first,num_old_verts);
       while ( vl_first != vl_last ) {
+				if ( progress && !progress->step() ) return;
 				vp = (*vl_first); ++vl_first;
 				newpos = (vp->coords - objcen)*scale_factor + objcen;
 				vp->coords = newpos;
@@ -312,17 +310,11 @@ namespace DLFL {
     crust_num_old_faces = obj->num_faces();
     crustfp1.resize(crust_num_old_faces,NULL);
     crustfp2.resize(crust_num_old_faces,NULL);
-  
-    StringStream dlflstream; // Stream used to duplicate the object
-    StringStream mtlstream; // Stream used to duplicate the object
-
-    // Write the object in DLFL format with the faces reversed
-    obj->writeDLFL(dlflstream,mtlstream, true);
 
     int num_old_verts = obj->num_vertices();
 
-    // Read back from the stream and append to existing object
-    obj->readDLFL(dlflstream, mtlstream, false);
+    // Append a copy of the object with the faces reversed
+    obj->append(*obj,true);
 
     // Fill the arrays storing information for crust modeling
     // Since we are traversing the faces, also compute and store
@@ -498,17 +490,11 @@ namespace DLFL {
     crust_num_old_faces = obj->num_faces();
     crustfp1.resize(crust_num_old_faces,NULL);
     crustfp2.resize(crust_num_old_faces,NULL);
-  
-    StringStream dlflstream; // Stream used to duplicate the object
-    StringStream mtlstream; // Stream used to duplicate the object
-
-    // Write the object in DLFL format with the faces reversed
-    obj->writeDLFL(dlflstream,mtlstream, true);
 
     int num_old_verts = obj->num_vertices();
 
-    // Read back from the stream and append to existing object
-    obj->readDLFL(dlflstream,mtlstream, false);
+    // Append a copy of the object with the faces reversed
+    obj->append(*obj,true);
 
     // Fill the arrays storing information for crust modeling
     // Since we are traversing the faces, also compute and store
@@ -670,13 +656,9 @@ namespace DLFL {
 
     bool match,jointCreated,vertListSizeMatch,allFacesMatched;
     float dist1, dist, tolerence = 0.0001;
-    StringStream dlflstream;
-    StringStream mtlstream;
 
-    obj->writeDLFL(dlflstream,mtlstream,false);
-
-    // Read back from the stream and append to existing object
-    obj->readDLFL(dlflstream,mtlstream, true);
+    // Number the elements consecutively, edge IDs are used as indices below
+    obj->makeUnique();
 
     num_original_edges = obj->num_edges();
     edge_connect_normals.reserve(2*num_original_edges);
@@ -1116,12 +1098,17 @@ namespace DLFL {
 
 	void selectFacesByArea(DLFLObjectPtr obj, DLFLFacePtr fptr, DLFLFacePtrArray &fparray, float delta ){
 		fparray.clear();
-		DLFLFacePtrList::iterator fl_first=obj->beginFace(), fl_last = obj->endFace();
 		float area = fptr->getArea();
-		while ( fl_first != fl_last )	{
-			if ( (*fl_first)->getArea() <= (area+delta) && (*fl_first)->getArea() >= (area-delta) ) fparray.push_back(*fl_first);
-			fl_first++;
-		}
+
+		// Compute each area once, in parallel, then collect the matching faces in list order
+		const DLFLSnapshot& mesh = obj->snapshot();
+		int num_faces = mesh.numFaces();
+		vector<float> areas(num_faces);
+#pragma omp parallel for schedule(static)
+		for (int i=0; i < num_faces; ++i) areas[i] = mesh.faces[i]->getArea();
+
+		for (int i=0; i < num_faces; ++i)
+			if ( areas[i] <= (area+delta) && areas[i] >= (area-delta) ) fparray.push_back(mesh.faces[i]);
 	}
 
 	void selectFacesByColor(DLFLObjectPtr obj, DLFLFacePtr fptr, DLFLFacePtrArray &fparray, float delta ){
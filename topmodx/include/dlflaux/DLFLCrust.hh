@@ -30,6 +30,7 @@
 #define _DLFLCRUST_H_
 
 #include <DLFLObject.hh>
+#include <DLFLProgress.hh>
 
 namespace DLFL {
 
@@ -51,8 +52,9 @@ namespace DLFL {
     Boolean flag indicates if crust should be of uniform thickness
     which means thickness at vertices will be adjusted to account
     for normal averaging.
+    The crust can be stopped through progress, leaving the object half done.
   */
-  void createCrust(const DLFLObjectPtr obj, double thickness, bool uniform = true);
+  void createCrust(const DLFLObjectPtr obj, double thickness, bool uniform = true, DLFLProgressPtr progress = NULL);
 
   /*
     Create a crust for this object.
@@ -60,7 +62,7 @@ namespace DLFL {
     duplicating the existing surface and scaling the inner or outer surface
     w.r.t centroid of object.
   */
-  void createCrustWithScaling(DLFLObjectPtr obj, double scale_factor = 0.9 );
+  void createCrustWithScaling(DLFLObjectPtr obj, double scale_factor = 0.9, DLFLProgressPtr progress = NULL );
   void cmMakeHole(DLFLObjectPtr obj, DLFLFacePtr fp, bool cleanup = true );
   void createCrustForWireframe(DLFLObjectPtr obj, double thickness = 0.1 );
   void createCrustForWireframe2(DLFLObjectPtr obj, double scale_factor = 0.1 );
@@ -69,77 +69,103 @@ namespace DLFL {
       // Cleanup valence-2 vertices
       cleanupWingedVertices(obj);
     } else {
-      // Go through list of faces and create centroids
-      // Also make sure face ids are consecutive
-
+      // Build the dual directly. Each face gives a vertex at its centroid,
+      // each corner a corner and each edge an edge, so the dual elements are
+      // found by numbering the faces and corners of the object
+      int numfaces = obj->num_faces();
+      DLFLVertexPtrArray dualverts; dualverts.reserve(numfaces);
+      DLFLFaceVertexPtrArray dualcorners;
+
+      // Faces are numbered so they can be used as indices
       DLFLFacePtrList::iterator fl_first, fl_last;
       DLFLFacePtr fp;
-
-      Vector3d cen;
-      StringStream rw,mw;
-			obj->writeMTL(mw);
-
-      // Traverse all faces, find centroid and output to stream
-      // Also call makeUnique to ensure face ids are consecutive
+      DLFLFaceVertexPtr head, current;
       fl_first = obj->beginFace(); fl_last = obj->endFace();
       while( fl_first != fl_last ) {
-				fp = (*fl_first); ++fl_first;
-				fp->makeUnique();
-				cen = fp->geomCentroid();	   
-				rw << "v " << cen[0] << " " << cen[1] << " " << cen[2] << endl;
+        fp = (*fl_first); ++fl_first;
+        fp->setIndex(dualverts.size());
+        dualverts.push_back(new DLFLVertex(fp->geomCentroid()));
+        head = current = fp->front();
+        if ( head )
+          do {
+            current->setIndex(dualcorners.size());
+            dualcorners.push_back(NULL);
+            current = current->next();
+          } while ( current != head );
       }
 
-      // Get ID of first face to determine offset for index into vertex list
-      int fistart = (obj->firstFace())->getID();
-
-      // Now traverse for all vertices, get all faces attached to it
-      // and create dual faces accordingly and output to filestream
+      // Create the dual face of each vertex by traversing the corners at
+      // the vertex in rotation order. Rotation order around the vertex is
+      // opposite to that of the faces, so corners are added in reverse.
+      // A non-manifold vertex has more than one cycle of corners and gives
+      // a face for each. The dual face gets the material of the faces around
+      // the vertex if they all have the same one, the default one otherwise
+      DLFLFacePtrArray dualfaces;
+      DLFLMaterialPtrArray dualmatls;
       DLFLVertexPtrList::iterator vl_first, vl_last;
-      DLFLVertexPtr vp;
-      DLFLFaceVertexPtrArray fvparray;
-
+      DLFLFaceVertexPtrArray fvparray, cycle;
+      DLFLFaceVertexPtr fvp, startfvp, curfvp;
+      DLFLMaterialPtr matl;
       vl_first = obj->beginVertex(); vl_last = obj->endVertex();
       while ( vl_first != vl_last ) {
-	vp = (*vl_first); ++vl_first;
-	// Get the face vertices pointing to this vertex in an array
-	vp->getFaceVertices(fvparray);
-	if ( fvparray.size() > 0 ) {
-	  // Start from one face vertex (first) and traverse
-	  // the face vertices pointing to this vertex according to the
-	  // rotation order. This wont always be the same as the order
-	  // in the list of face vertices in the vertex.
-	  DLFLFaceVertexPtr startfvp = fvparray[0];
-	  DLFLFaceVertexPtr curfvp = startfvp;
-
-	  int index=0;
-	  fvparray[index++] = curfvp;
+        (*vl_first)->getFaceVertices(fvparray); ++vl_first;
+        for (int i=0; i < fvparray.size(); ++i) {
+          if ( dualcorners[fvparray[i]->getIndex()] ) continue;
+          cycle.clear();
+          startfvp = curfvp = fvparray[i];
+          do {
+            cycle.push_back(curfvp);
+            curfvp = curfvp->vnext();
+          } while ( curfvp != startfvp );
+
+          fp = new DLFLFace;
+          matl = cycle[0]->getFacePtr()->material();
+          for (int j=cycle.size()-1; j >= 0; --j) {
+            fvp = new DLFLFaceVertex;
+            fvp->vertex = dualverts[cycle[j]->getFacePtr()->getIndex()];
+            dualcorners[cycle[j]->getIndex()] = fvp;
+            fp->addVertexPtr(fvp);
+            if ( cycle[j]->getFacePtr()->material() != matl ) matl = NULL;
+          }
+          dualfaces.push_back(fp);
+          dualmatls.push_back(matl);
+        }
+      }
 
-	  // Use vnext and not next, since we want rotation around vertex
-	  // Use the same array to store the face vertices in the correct
-	  // rotation order, since the size will be the same
-	  curfvp = curfvp->vnext();
-	  while ( curfvp != startfvp) {
-	    fvparray[index++] = curfvp;
-	    curfvp = curfvp->vnext();
-	  }
+      // The dual of an edge separates the faces of the edge's vertices.
+      // Going around a vertex, the corner following the edge's corner in one
+      // face is the one after the edge's other corner, so the dual edge
+      // starts at the duals of the corners following the edge's corners
+      DLFLEdgePtrArray dualedges; dualedges.reserve(obj->num_edges());
+      DLFLEdgePtrList::iterator el_first, el_last;
+      DLFLFaceVertexPtr fvp1, fvp2;
+      DLFLEdgePtr ep;
+      el_first = obj->beginEdge(); el_last = obj->endEdge();
+      while ( el_first != el_last ) {
+        (*el_first)->getCorners(fvp1,fvp2); ++el_first;
+        ep = new DLFLEdge;
+        ep->setFaceVertexPointers(dualcorners[fvp1->next()->getIndex()],
+                                  dualcorners[fvp2->next()->getIndex()],false);
+        dualedges.push_back(ep);
+      }
 
-	  // Create the dual face corresponding to this vertex by
-	  // going through the array created above, finding the corresponding face
-	  // and using the ID to index into the list of vertices output earlier.
-	  // Note that traversal here is in reverse because rotation order around
-	  // vertex is opposite to that of the faces
-	  rw << "f"; 
-	  while( index > 0 ) {
-	    rw << " ";
-	    rw << fvparray[--index]->getFaceID()-fistart+1;
-	  }
-	}
-	fvparray.clear();
-	rw << endl;
+      // Replace the object with its dual
+      obj->clearElements();
+      for (int i=0; i < dualverts.size(); ++i)
+        obj->addVertexPtr(dualverts[i]);
+      for (int i=0; i < dualedges.size(); ++i) {
+        dualedges[i]->updateFaceVertices();
+        obj->addEdgePtr(dualedges[i]);
+      }
+      for (int i=0; i < dualfaces.size(); ++i) {
+        fp = dualfaces[i];
+        fp->setMaterial(( dualmatls[i] ) ? dualmatls[i] : obj->firstMaterial());
+        fp->updateFacePointers();
+        fp->addFaceVerticesToVertices();
+        obj->addFacePtr(fp);
       }
-      rw << endl << endl;
-      rw << flush;
-      obj->readObject(rw,mw);
+      // Normals as readObject would compute them
+      obj->computeNormals();
     }
   }
 
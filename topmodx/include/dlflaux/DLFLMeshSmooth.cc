@@ -41,14 +41,13 @@
 namespace DLFL {
 
   void meshsmooth( DLFLObjectPtr obj ) {
-    DLFLFacePtrList::iterator fl_first, fl_last;
-    DLFLFacePtr faceptr;
-  
-    fl_first = obj->beginFace(); fl_last = obj->endFace();
+    const DLFLSnapshot& mesh = obj->snapshot();
+    int num_faces = mesh.numFaces(), num_verts = mesh.numVertices();
 
     /* Loop through all faces */
-    while ( fl_first != fl_last ) {
-      faceptr = (*fl_first); ++fl_first;
+#pragma omp parallel for schedule(static)
+    for (int f=0; f < num_faces; ++f) {
+      DLFLFacePtr faceptr = mesh.faces[f];
 
       /*
 	Find the average normal for the face and the centroid
@@ -64,55 +63,28 @@ namespace DLFL {
       */
     }
 
+    /* Loop through all vertices. Each one only depends on the faces around it */
+#pragma omp parallel for schedule(static)
+    for (int v=0; v < num_verts; ++v) {
+      int n = mesh.valence(v);
+      if ( n == 0 ) continue;
 
-    DLFLVertexPtrList::iterator vl_first, vl_last;
-    DLFLVertexPtr vertexptr;
-    DLFLFaceVertexPtrArray fvparray;
-    Vector3dArray p_array, n_array; // Arrays of point and normals for each face adjacent to a vertex
-    int num_faces;
-    Vector3d average, averagenormal; 
-  
-    vl_first = obj->beginVertex(); vl_last = obj->endVertex();
-
-    /* Loop through all vertices */
-    while ( vl_first != vl_last ) {
-      vertexptr = (*vl_first); ++vl_first;
-
-      /*
-	Get all the corners for this vertex
-      */
-      fvparray.clear(); // The local array must be cleared before calling getFaceVertices
-      vertexptr->getFaceVertices(fvparray);
-      num_faces = fvparray.size();
-       
       /*
-	Go through the array of face-vertices and find the normal and centroid
-	for each face
+	Go through the corners of this vertex and average the normal and
+	centroid of their faces (which we calculated above)
       */
-      p_array.clear(); n_array.clear(); // The local arrays must be cleared for each Vertex
-
-      // If we resize the array before filling it, we can avoid unnecessary memory allocation
-      // thus speeding up the process a little bit.
-      //p_array.resize(num_faces,Vector3d(0)); n_array.resize(num_faces,Vector3d(0));
-      p_array.resize(num_faces,Vector3d()); n_array.resize(num_faces,Vector3d());
-      for (int i=0; i <num_faces; ++i) {
-	DLFLFacePtr fp = fvparray[i]->getFacePtr();
-
-	// Get the normal and centroid for this face (which we calculated above)
-	// and store them in our local arrays
-	n_array[i] = fp->normal;
-	p_array[i] = fp->centroid;
-	average+=p_array[i];
-	averagenormal+=n_array[i];
-	    
+      Vector3d average, averagenormal;
+      for (int j=mesh.vertex_start[v]; j < mesh.vertex_start[v+1]; ++j) {
+	DLFLFacePtr fp = mesh.faces[mesh.corner_face[mesh.vertex_corners[j]]];
+	average+=fp->centroid;
+	averagenormal+=fp->normal;
       }
-      average/=num_faces; normalize(averagenormal);
-      Vector3d new_pos = vertexptr->coords; // This is the old position
+      average/=n; normalize(averagenormal);
+      Vector3d new_pos = mesh.positions[v]; // This is the old position
 
       new_pos+=(average-new_pos)-((average-new_pos)*averagenormal)*averagenormal;
                
-      vertexptr->coords = new_pos;
-      average-=average; 
+      mesh.vertices[v]->coords = new_pos;
     }
   }
 
@@ -886,37 +886,37 @@ void modifiedMultiConnectCrust(DLFLObjectPtr obj, double scale_factor) {
 	}
 }
 
-void createSponge( DLFLObjectPtr obj, double thickness, double collapse_threshold_factor) {
+void createSponge( DLFLObjectPtr obj, double thickness, double collapse_threshold_factor, DLFLProgressPtr progress) {
 		// New multi-connect with crust.
 	bool fractional_thickness = false;
-		// Make sure all Edge IDs and Face IDs are consecutive
-	obj->makeEdgesUnique();
-	obj->makeFacesUnique();
+		// Number the edges and faces so they can be used as indices in the temporary lists
+	obj->indexEdges();
+	obj->indexFaces();
 
 	DLFLEdgePtrArray eplist1, eplist2; // List of edges to be connected (for inner shell)
 	DLFLFacePtrArray fplist1, fplist2; // List of faces to be connected (between outer and inner shell)
 	int num_faces, num_edges;//, num_verts;
-	int eistart, edgeindex, fistart;//, faceindex;
+	int edgeindex;//, faceindex;
 	int num_old_verts = obj->num_vertices();
 	int num_old_faces = obj->num_faces();
 	int num_old_edges = obj->num_edges();
 	int count;
 
+		// The collapse checks aren't counted, they take little time compared to the rest
+	if ( progress ) progress->setMaximum(2*num_old_faces+2*num_old_edges+num_old_verts);
+
 		// Reserve and create num_old_edges entries in the 2 temporary edge lists
 	eplist1.resize(num_old_edges,NULL); eplist2.resize(num_old_edges,NULL);
 
 		// Reserve and create num_old_faces entries in the 2 temporary face lists
 	fplist1.resize(num_old_faces,NULL); fplist2.resize(num_old_faces,NULL);
 
-		// Find starting edge ID to use as offset.
-	eistart = (obj->firstEdge())->getID();
-	fistart = (obj->firstFace())->getID();
-
 	DLFLFacePtrList::iterator fl_first, fl_last;
 	DLFLFacePtr fp, newfp1, newfp2;
 	fl_first = obj->beginFace(); fl_last = obj->endFace();
 	num_faces = 0;
 	while ( fl_first != fl_last && num_faces < num_old_faces ) {
+		if ( progress && !progress->step() ) return;
 		fp = (*fl_first); ++fl_first; ++num_faces;
 
 			// Create face for inner shell
@@ -935,7 +935,7 @@ void createSponge( DLFLObjectPtr obj, double thickness, double collapse_threshol
 		newfp2->setType(FTNew);
 
 			// Store edges which are to be connected in the temporary array
-			// using the adjusted edge ID of corresponding edge in original mesh.
+			// using the index of the corresponding edge in original mesh.
 			// newfp2 (the OUTER face) will be used for edge connections
 		DLFLEdgePtrArray eparray1, eparray2;
 		DLFLEdgePtr ep1, ep2;
@@ -946,17 +946,17 @@ void createSponge( DLFLObjectPtr obj, double thickness, double collapse_threshol
 		for (int i=0; i < (int)eparray1.size(); ++i) {
 			ep1 = eparray1[i]; ep2 = eparray2[i];
 
-			edgeindex = ep1->getID() - eistart;
+			edgeindex = ep1->getIndex();
 			if ( eplist1[edgeindex] == NULL ) eplist1[edgeindex] = ep2;
 			else                              eplist2[edgeindex] = ep2;
 		}
 
 			// Store faces which are to be connected in the temporary array
-			// using the adjusted face ID of the face in the original mesh.
+			// using the index of the face in the original mesh.
 			// newfp1 (the INNER face) will be used for face connections
 			// fplist1 will be used, since the other matching faces will only
 			// be created later on and there is no possibility of conflict
-		fplist1[fp->getID() - fistart] = newfp1;
+		fplist1[fp->getIndex()] = newfp1;
 
 			// Create the face for the outer shell
 			// We use extrude now so we can easily insert the support edges later
@@ -964,7 +964,7 @@ void createSponge( DLFLObjectPtr obj, double thickness, double collapse_threshol
 
 			// newfp2 is used for make the face connection with the inner shell
 			// Store newfp2 in fplist2
-		fplist2[fp->getID() - fistart] = newfp2;
+		fplist2[fp->getIndex()] = newfp2;
 	}
 
 
@@ -976,11 +976,13 @@ void createSponge( DLFLObjectPtr obj, double thickness, double collapse_threshol
 	el_first = obj->beginEdge(); el_last = obj->endEdge();
 	if ( fractional_thickness ) {
 		while ( count < num_old_edges ) {
+			if ( progress && !progress->step() ) return;
 			ep = (*el_first); ++el_first; ++count;
 			trisectEdge(obj,ep,thickness*ep->length(),false,true);
 		}
 	} else {
 		while ( count < num_old_edges ) {
+			if ( progress && !progress->step() ) return;
 			ep = (*el_first); ++el_first; ++count;
 			trisectEdge(obj,ep,thickness,false,true);
 		}
@@ -1000,6 +1002,7 @@ void createSponge( DLFLObjectPtr obj, double thickness, double collapse_threshol
 	count = 0;
 	vfirst = obj->beginVertex(); vlast = obj->endVertex();
 	while ( count < num_old_verts ) {
+		if ( progress && !progress->step() ) return;
 		vp = (*vfirst); ++vfirst; ++count;
 		vp->getFaceVertices(fvparray);
 		for (int i=0; i < (int)fvparray.size(); ++i) {
@@ -1023,6 +1026,7 @@ void createSponge( DLFLObjectPtr obj, double thickness, double collapse_threshol
 		// The correct half-edge is determined by the type tag which was set previously
 	DLFLFacePtr fp1, fp2, tfp1, tfp2;
 	for (int i=0; i < num_old_edges; ++i) {
+		if ( progress && !progress->step() ) return;
 		if ( eplist1[i] != NULL && eplist2[i] != NULL ) {
 	// Find the faces adjacent to the edges which are of type FTNew
 	// These will be the inner faces
@@ -1105,6 +1109,7 @@ void createSponge( DLFLObjectPtr obj, double thickness, double collapse_threshol
 		// Make the face connections between the outer shell and the inner shell
 	DLFLFaceVertexPtr fvp1, fvp2;
 	for (int i=0; i < num_old_faces; ++i) {
+		if ( progress && !progress->step() ) return;
 		fp1 = fplist1[i]; fp2 = fplist2[i];
 		if ( fp1 != NULL && fp2 != NULL ) {
 			fvp1 = fp1->firstVertex(); fvp2 = fp2->firstVertex();
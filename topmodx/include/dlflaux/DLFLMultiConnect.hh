@@ -30,6 +30,7 @@
 #define _DLFLMULTI_CONNECT_H_
 
 #include <DLFLObject.hh>
+#include <DLFLProgress.hh>
 
 namespace DLFL {
 
@@ -215,7 +216,8 @@ namespace DLFL {
   void multiConnectMidpoints( DLFLObjectPtr obj );
   void multiConnectCrust( DLFLObjectPtr obj, double scale_factor=0.5 );
   void modifiedMultiConnectCrust(DLFLObjectPtr obj, double scale_factor=0.5 );
-  void createSponge( DLFLObjectPtr obj, double thickness, double collapse_threshold_factor=0.0 );
+  // Can be stopped through progress, leaving the object half done
+  void createSponge( DLFLObjectPtr obj, double thickness, double collapse_threshold_factor=0.0, DLFLProgressPtr progress=NULL );
 
   bool less_than(const HalfEdgePair& hep1, const HalfEdgePair& hep2);
   bool greater_than(const HalfEdgePair& hep1, const HalfEdgePair& hep2);
@@ -600,7 +600,7 @@ namespace DLFL {
 			delete [] sedges;
 	}//end performCutting Function
 
-	void cutSelectedFaces( DLFLObjectPtr obj, float offsetE,float offsetV, bool global,bool selected) {
+	void cutSelectedFaces( DLFLObjectPtr obj, float offsetE,float offsetV, bool global,bool selected, DLFLProgressPtr progress) {
 
 				// bool global = false;
 
@@ -691,7 +691,9 @@ namespace DLFL {
 					sverts[cutcount] = svp;
 				}
 
+				if ( progress ) progress->setMaximum(cutcount);
 				for(int i = 0; i<cutcount;i++){
+					if ( progress && !progress->step() ) break;
 					if (global)
 						peelByPlane(obj,norms[i],locs[i]);	
 					else	localCut(obj, sverts[i],norms[i],locs[i]);
@@ -703,7 +705,7 @@ namespace DLFL {
 				delete [] sedges;
 	}//end cutselectedFaces Function
 
-	void cutSelectedEdges( DLFLObjectPtr obj, float offsetE,float offsetV, bool global,bool selected) {
+	void cutSelectedEdges( DLFLObjectPtr obj, float offsetE,float offsetV, bool global,bool selected, DLFLProgressPtr progress) {
 
 		// bool global = false;
 		vector<DLFLVertexPtr>::iterator vit;
@@ -783,7 +785,9 @@ namespace DLFL {
 		}
 
 
+		if ( progress ) progress->setMaximum(cutcount);
 		for(int i = 0; i<cutcount;i++){
+			if ( progress && !progress->step() ) break;
 		if (global)
 		peelByPlane(obj,norms[i],locs[i]);	
 		else	localCut(obj, sverts[i],norms[i],locs[i]);
@@ -795,7 +799,7 @@ namespace DLFL {
 		delete [] sedges;
 	}//end performCutting Function
 
-	void cutSelectedVertices( DLFLObjectPtr obj, float offsetE,float offsetV, bool global,bool selected) {
+	void cutSelectedVertices( DLFLObjectPtr obj, float offsetE,float offsetV, bool global,bool selected, DLFLProgressPtr progress) {
 
 		// bool global = false;
 		vector<DLFLVertexPtr>::iterator vit;
@@ -858,7 +862,9 @@ namespace DLFL {
 			sverts[cutcount] = (*vit);
 		}
 
+		if ( progress ) progress->setMaximum(cutcount);
 		for(int i = 0; i<cutcount;i++){
+			if ( progress && !progress->step() ) break;
 			if (global)
 				peelByPlane(obj,norms[i],locs[i]);	
 			else	
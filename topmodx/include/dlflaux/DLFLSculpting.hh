@@ -27,6 +27,7 @@
 */
 
 #include <DLFLObject.hh>
+#include <DLFLProgress.hh>
 #include <DLFLCore.hh>
 #include <DLFLCoreExt.hh>
 #include "DLFLConvexHull.hh"
@@ -56,9 +57,10 @@ namespace DLFL {
 	void localCut(DLFLObjectPtr obj, DLFLVertexPtr vp,Vector3d normal,Vector3d P0);
 		
   void performCutting( DLFLObjectPtr obj, int type,float offsetE,float offsetV,bool global,bool selected) ;
-	void cutSelectedFaces( DLFLObjectPtr obj, float offsetE,float offsetV,bool global=false,bool selected=false);
-	void cutSelectedEdges( DLFLObjectPtr obj, float offsetE,float offsetV,bool global=false,bool selected=false);
-	void cutSelectedVertices( DLFLObjectPtr obj, float offsetE,float offsetV,bool global=false,bool selected=false);
+	// The cuts can be stopped through progress, leaving the object half done
+	void cutSelectedFaces( DLFLObjectPtr obj, float offsetE,float offsetV,bool global=false,bool selected=false, DLFLProgressPtr progress=NULL);
+	void cutSelectedEdges( DLFLObjectPtr obj, float offsetE,float offsetV,bool global=false,bool selected=false, DLFLProgressPtr progress=NULL);
+	void cutSelectedVertices( DLFLObjectPtr obj, float offsetE,float offsetV,bool global=false,bool selected=false, DLFLProgressPtr progress=NULL);
 	
 	int isMarked(DLFLVertexPtr vp);
 	void autoMarkEdges(DLFLObjectPtr obj);
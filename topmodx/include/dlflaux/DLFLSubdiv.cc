@@ -38,8 +38,27 @@
 #include "DLFLExtrude.hh"
 #include "DLFLConnect.hh"
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace DLFL {
 
+  // Requested thread count, 0 for one per processor
+  static int subdivThreads = 0;
+
+  void setSubdivisionThreads( int n ) {
+    subdivThreads = ( n < 0 ) ? 0 : n;
+  }
+
+  int subdivisionThreads( ) {
+#ifdef _OPENMP
+    return ( subdivThreads > 0 ) ? subdivThreads : omp_get_max_threads();
+#else
+    return 1;
+#endif
+  }
+
   void loopSubdivide( DLFLObjectPtr obj ) {
     // Perform Loop subdivision
 
@@ -497,22 +516,19 @@ namespace DLFL {
     DLFLFaceVertexPtr fvp1, fvp2, head1, head2;
     DLFLEdgePtr ep;
     DLFLVertexPtr vp;
-    int edgeindex,eistart;
+    int edgeindex;
   
     num_old_verts = obj->num_vertices();
     num_old_faces = obj->num_faces();
     num_old_edges = obj->num_edges();
 
-    // Apply make-unique on the obj->num_edges to make sure all Edge IDs are consecutive
-    obj->makeEdgesUnique();
+    // Number the edges so they can be used as indices in the temporary lists
+    obj->indexEdges();
   
     // Reserve and create num_old_edges entries in the 2 temporary lists
     fvplist1.resize(num_old_edges,NULL); 
     fvplist2.resize(num_old_edges,NULL);
 
-    // Find starting edge ID to use as offset.
-    eistart = (obj->firstEdge())->getID();
-
     // For each old face create new faces and update the 2 temporary lists using the edge IDs
     // as index in the lists
     fl_first = obj->beginFace(); fl_last = obj->endFace();
@@ -565,13 +581,13 @@ namespace DLFL {
             
       fvp1 = head1 = fp->front(); fvp2 = head2 = ifp->front();
 
-      ep = fvp1->getEdgePtr(); edgeindex = ep->getID() - eistart;
+      ep = fvp1->getEdgePtr(); edgeindex = ep->getIndex();
       if ( fvplist1[edgeindex] == NULL ) fvplist1[edgeindex] = fvp2;
       else fvplist2[edgeindex] = fvp2;
       fvp1 = fvp1->next(); fvp2 = fvp2->prev();
 
       while ( fvp1 != head1 && fvp2 != head2 ) {
-				ep = fvp1->getEdgePtr(); edgeindex = ep->getID() - eistart;
+				ep = fvp1->getEdgePtr(); edgeindex = ep->getIndex();
 				if ( fvplist1[edgeindex] == NULL ) fvplist1[edgeindex] = fvp2;
 				else fvplist2[edgeindex] = fvp2;
 				fvp1 = fvp1->next(); fvp2 = fvp2->prev();
@@ -612,7 +628,28 @@ namespace DLFL {
     }
   }
 
-  bool dooSabinSubdivide(DLFLObjectPtr obj,bool check/*, QProgressDialog *progress*/) {		
+  // Corners of the inner face Doo-Sabin creates for the given face
+  static void dooSabinFacePoints(DLFLFacePtr fp, Vector3dArray& new_vertex_coords) {
+    Vector3dArray vertex_coords;
+    Vector3d p;
+    fp->getVertexCoords(vertex_coords);
+
+    int num_verts = vertex_coords.size();
+    new_vertex_coords.reserve(num_verts);
+
+    double coef;
+    for (int i=0; i < num_verts; ++i) {
+      p.reset();
+      for (int j=0; j < num_verts; ++j) {
+				if ( i == j ) coef = 0.25 + 5.0/(4.0*num_verts);
+				else coef = ( 3.0 + 2.0*cos(2.0*(i-j)*M_PI/num_verts) ) / (4.0*num_verts);
+				p += coef*vertex_coords[j];
+      }
+      new_vertex_coords.push_back(p);
+    }
+  }
+
+  bool dooSabinSubdivide(DLFLObjectPtr obj, bool check, DLFLProgressPtr progress) {
     // Regular Doo-Sabin subdivision scheme
 
     // Go through list of faces and create new inner faces for each face
@@ -624,62 +661,44 @@ namespace DLFL {
     DLFLFaceVertexPtr fvp1, fvp2, head1, head2;
     DLFLEdgePtr ep, iep;
     DLFLVertexPtr vp;
-    Vector3dArray vertex_coords, new_vertex_coords;
-    Vector3d p;
+    Vector3dArray new_vertex_coords;
     int num_old_faces, num_old_edges, num_old_verts;
     int num_faces, num_edges, num_verts;
-    int eistart, edgeindex;
-  	// int progressvalue = 0; // progress bar test dave
+    int edgeindex;
 	
     num_old_verts = obj->num_vertices();
     num_old_faces = obj->num_faces();
     num_old_edges = obj->num_edges();
 
-		//testing qprogressbar - need to figure out a way to do this without putting qt
-		//into the dlfl libraries
-		// if (progress) {
-		// 	progress->setMaximum(num_old_faces*2+num_old_edges*2+num_old_verts);
-		// 	progress->setValue(progressvalue);
-		// }
+    if ( progress ) progress->setMaximum(num_old_faces*2+num_old_edges*2+num_old_verts);
 
-    // Apply make-unique on the obj->num_edges to make sure all Edge IDs are consecutive
-    obj->makeEdgesUnique();
+    // Number the edges so they can be used as indices in the temporary lists
+    obj->indexEdges();
   
     // Reserve and create num_old_edges entries in the 2 temporary lists
     eplist1.resize(num_old_edges,NULL); eplist2.resize(num_old_edges,NULL);
-  
-    // Find starting edge ID to use as offset.
-    eistart = (obj->firstEdge())->getID();
+
+    // With more than one thread the coordinates of all inner faces are computed
+    // up front. The faces are still created in order below
+    vector<Vector3dArray> inner_coords;
+    if ( subdivisionThreads() > 1 ) {
+      DLFLFacePtrArray old_faces(obj->beginFace(),obj->endFace());
+      inner_coords.resize(num_old_faces);
+#pragma omp parallel for num_threads(subdivisionThreads()) schedule(static)
+      for (int i=0; i < num_old_faces; ++i)
+				dooSabinFacePoints(old_faces[i],inner_coords[i]);
+    }
 
     fl_first = obj->beginFace(); fl_last = obj->endFace(); num_faces = 0;
     while ( fl_first != fl_last && num_faces < num_old_faces ) {
-			// //update progress bar status - dave
-			// if (progress){
-			// 	progress->setValue(progressvalue++);
-			// 	// QApplication::processEvents();
-			// 	if (progress->wasCanceled())
-			// 		return false;
-			// }
+      if ( progress && !progress->step() ) return false;
       fp = (*fl_first);
 
-      fp->getVertexCoords(vertex_coords);
-
-      num_verts = vertex_coords.size();
-      new_vertex_coords.reserve(num_verts);
-            
       // Compute new coordinates for the new polygon
-      double coef;
-      for (int i=0; i < num_verts; ++i) {
-				p.reset();
-				for (int j=0; j < num_verts; ++j) {
-					if ( i == j ) coef = 0.25 + 5.0/(4.0*num_verts);
-					else coef = ( 3.0 + 2.0*cos(2.0*(i-j)*M_PI/num_verts) ) / (4.0*num_verts);
-					p += coef*vertex_coords[j];
-				}
-				new_vertex_coords.push_back(p);
-      }
+      if ( inner_coords.empty() ) dooSabinFacePoints(fp,new_vertex_coords);
+      else new_vertex_coords.swap(inner_coords[num_faces]);
       obj->createFace(new_vertex_coords);
-      new_vertex_coords.clear(); vertex_coords.clear();
+      new_vertex_coords.clear();
 
       // Get the second newly inserted face, the one facing inwards
       ifp = obj->lastFace();
@@ -696,7 +715,7 @@ namespace DLFL {
       fvp1 = head1 = fp->front(); fvp2 = head2 = ifp->back();
 
       ep = fvp1->getEdgePtr(); iep = fvp2->getEdgePtr();
-      edgeindex = ep->getID() - eistart;
+      edgeindex = ep->getIndex();
       if ( eplist1[edgeindex] == NULL ) 
 				eplist1[edgeindex] = iep;
       else                              
@@ -705,7 +724,7 @@ namespace DLFL {
 			
       while ( fvp1 != head1 && fvp2 != head2 ) {
 				ep = fvp1->getEdgePtr(); iep = fvp2->getEdgePtr();
-				edgeindex = ep->getID() - eistart;
+				edgeindex = ep->getIndex();
 				if ( eplist1[edgeindex] == NULL ) 
 					eplist1[edgeindex] = iep;
 				else                              
@@ -720,13 +739,7 @@ namespace DLFL {
     num_faces = 0; 
     fl_first = obj->beginFace(); fl_last = obj->endFace();
     while ( fl_first != fl_last && num_faces < num_old_faces ) {
-			//progress bar stuff - dave
-			// if (progress){
-			// 	progress->setValue(progressvalue++);
-			// 	// QApplication::processEvents();
-			// 	if (progress->wasCanceled())
-			// 		return false;
-			// }
+      if ( progress && !progress->step() ) return false;
       fp = (*fl_first); ++fl_first; ++num_faces;
       obj->removeFace(fp); delete fp;
     }
@@ -734,14 +747,7 @@ namespace DLFL {
     num_edges = 0; 
     el_first = obj->beginEdge(); el_last = obj->endEdge();
     while ( el_first != el_last && num_edges < num_old_edges ) {
-			//progress bar shit - dave
-			// if (progress){
-			// 	progress->setValue(progressvalue++);
-			// 	// QApplication::processEvents();
-			// 	if (progress->wasCanceled())
-			// 		return false;
-			// }
-			
+      if ( progress && !progress->step() ) return false;
       ep = (*el_first); ++el_first; ++num_edges;
       obj->removeEdge(ep); delete ep;
     }
@@ -749,14 +755,7 @@ namespace DLFL {
     num_verts = 0; 
     vl_first = obj->beginVertex(); vl_last = obj->endVertex();
     while ( vl_first != vl_last && num_verts < num_old_verts ) {
-			//progress bar stuff - dave
-			// if (progress){
-			// 	progress->setValue(progressvalue++);
-			// 	// QApplication::processEvents();
-			// 	if (progress->wasCanceled())
-			// 		return false;
-			// }
-
+      if ( progress && !progress->step() ) return false;
       vp = (*vl_first); ++vl_first; ++num_verts;
       obj->removeVertex(vp); delete vp;
     }
@@ -764,14 +763,7 @@ namespace DLFL {
     // Go through eplist1,fplist1 and eplist2,fplist2 and connect corresponding half-edges
     DLFLFacePtr fp1, fp2, tfp1, tfp2;
     for (int i=0; i < num_old_edges; ++i) {
-			//progress bar stuff - dave
-			// if (progress){
-			// 	progress->setValue(progressvalue++);
-			// 	// QApplication::processEvents();
-			// 	if (progress->wasCanceled())
-			// 		return false;
-			// }
-
+      if ( progress && !progress->step() ) return false;
       if ( eplist1[i] != NULL && eplist2[i] != NULL ) {
 				// Find the faces adjacent to the edges which are of type FTNew
 				// These will be the inner faces
@@ -790,10 +782,7 @@ namespace DLFL {
 				cout << "NULL pointers found! i = " << i << " "
 						 << eplist1[i] << " -- " << eplist2[i] << endl;
     }
-		// //progress bar stuff - dave
-		// if (progress)
-		// 	progress->setValue(num_old_faces*2+num_old_edges*2+num_old_verts);
-		return true;
+    return true;
   }
 
   void cornerCuttingSubdivide(DLFLObjectPtr obj, float alpha) {
@@ -813,20 +802,17 @@ namespace DLFL {
     Vector3d p;
     int num_old_faces, num_old_edges, num_old_verts;
     int num_faces, num_edges, num_verts;
-    int eistart, edgeindex;
+    int edgeindex;
   
     num_old_verts = obj->num_vertices();
     num_old_faces = obj->num_faces();
     num_old_edges = obj->num_edges();
 
-    // Apply make-unique on the obj->num_edges to make sure all Edge IDs are consecutive
-    obj->makeEdgesUnique();
+    // Number the edges so they can be used as indices in the temporary lists
+    obj->indexEdges();
   
     // Reserve and create num_old_edges entries in the 2 temporary lists
     eplist1.resize(num_old_edges,NULL); eplist2.resize(num_old_edges,NULL);
-  
-    // Find starting edge ID to use as offset.
-    eistart = (obj->firstEdge())->getID();
 
     fl_first = obj->beginFace(); fl_last = obj->endFace();
     num_faces = 0;
@@ -869,7 +855,7 @@ namespace DLFL {
       fvp1 = head1 = fp->front(); fvp2 = head2 = ifp->back();
 
       ep = fvp1->getEdgePtr(); iep = fvp2->getEdgePtr();
-      edgeindex = ep->getID() - eistart;
+      edgeindex = ep->getIndex();
       if ( eplist1[edgeindex] == NULL ) 
 				eplist1[edgeindex] = iep;
       else                              
@@ -878,7 +864,7 @@ namespace DLFL {
 
       while ( fvp1 != head1 && fvp2 != head2 ) {
 				ep = fvp1->getEdgePtr(); iep = fvp2->getEdgePtr();
-				edgeindex = ep->getID() - eistart;
+				edgeindex = ep->getIndex();
 				if ( eplist1[edgeindex] == NULL ) 
 					eplist1[edgeindex] = iep;
 				else                              
@@ -949,22 +935,17 @@ namespace DLFL {
     float n1n2,x,t;
     int num_old_faces, num_old_edges, num_old_verts;
     int num_faces, num_edges, num_verts;
-    int eistart, edgeindex;
+    int edgeindex;
   
     num_old_verts = obj->num_vertices();
     num_old_faces = obj->num_faces();
     num_old_edges = obj->num_edges();
 
-    // Apply make-unique on the obj->num_edges to make sure all Edge IDs are consecutive
-    DLFLEdgePtrList::iterator efirst=obj->beginEdge(), elast=obj->endEdge();
-
-    obj->makeEdgesUnique();
+    // Number the edges so they can be used as indices in the temporary lists
+    obj->indexEdges();
   
     // Reserve and create num_old_edges entries in the 2 temporary lists
     eplist1.resize(num_old_edges,NULL); eplist2.resize(num_old_edges,NULL);
-  
-    // Find starting edge ID to use as offset.
-    eistart = (obj->firstEdge())->getID();
 
     fl_first = obj->beginFace(); fl_last = obj->endFace();
     num_faces = 0;
@@ -1044,7 +1025,7 @@ namespace DLFL {
       fvp1 = head1 = fp->front(); fvp2 = head2 = ifp->back();
        
       ep = fvp1->getEdgePtr(); iep = fvp2->getEdgePtr();
-      edgeindex = ep->getID() - eistart;
+      edgeindex = ep->getIndex();
       if ( eplist1[edgeindex] == NULL ) 
 				eplist1[edgeindex] = iep;
       else
@@ -1053,7 +1034,7 @@ namespace DLFL {
 
       while ( fvp1 != head1 && fvp2 != head2 ) {
 				ep = fvp1->getEdgePtr(); iep = fvp2->getEdgePtr();
-				edgeindex = ep->getID() - eistart;
+				edgeindex = ep->getIndex();
 				if ( eplist1[edgeindex] == NULL ) 
 					eplist1[edgeindex] = iep;
 				else
@@ -1124,22 +1105,17 @@ namespace DLFL {
     float n1n2,x,t;
     int num_old_faces, num_old_edges, num_old_verts;
     int num_faces, num_edges, num_verts;
-    int eistart, edgeindex;
+    int edgeindex;
   
     num_old_verts = obj->num_vertices();
     num_old_faces = obj->num_faces();
     num_old_edges = obj->num_edges();
 
-    // Apply make-unique on the obj->num_edges to make sure all Edge IDs are consecutive
-    DLFLEdgePtrList::iterator efirst=obj->beginEdge(), elast=obj->endEdge();
-
-    obj->makeEdgesUnique();
+    // Number the edges so they can be used as indices in the temporary lists
+    obj->indexEdges();
   
     // Reserve and create num_old_edges entries in the 2 temporary lists
     eplist1.resize(num_old_edges,NULL); eplist2.resize(num_old_edges,NULL);
-  
-    // Find starting edge ID to use as offset.
-    eistart = (obj->firstEdge())->getID();
 
     fl_first = obj->beginFace(); fl_last = obj->endFace();
     num_faces = 0;
@@ -1210,7 +1186,7 @@ namespace DLFL {
       fvp1 = head1 = fp->front(); fvp2 = head2 = ifp->back();
        
       ep = fvp1->getEdgePtr(); iep = fvp2->getEdgePtr();
-      edgeindex = ep->getID() - eistart;
+      edgeindex = ep->getIndex();
       if ( eplist1[edgeindex] == NULL ) 
 				eplist1[edgeindex] = iep;
       else
@@ -1219,7 +1195,7 @@ namespace DLFL {
 
       while ( fvp1 != head1 && fvp2 != head2 ) {
 				ep = fvp1->getEdgePtr(); iep = fvp2->getEdgePtr();
-				edgeindex = ep->getID() - eistart;
+				edgeindex = ep->getIndex();
 				if ( eplist1[edgeindex] == NULL ) 
 					eplist1[edgeindex] = iep;
 				else
@@ -1397,7 +1373,88 @@ namespace DLFL {
   }
 
   
-  void catmullClarkSubdivide( DLFLObjectPtr obj ) {
+  // Parallel version of the first half of catmullClarkSubdivide. Leaves the face
+  // and edge points in the aux coords and moves the old vertices, like the serial
+  // loops. Vertex points are gathered from the incident faces and edges in the
+  // order the serial loops add them up, so the results are identical
+  static void catmullClarkPoints( DLFLObjectPtr obj ) {
+    DLFLVertexPtrArray verts(obj->beginVertex(),obj->endVertex());
+    DLFLEdgePtrArray edges(obj->beginEdge(),obj->endEdge());
+    DLFLFacePtrArray faces(obj->beginFace(),obj->endFace());
+    int num_verts = verts.size(), num_edges = edges.size(), num_faces = faces.size();
+    int nthreads = subdivisionThreads();
+    DLFLFaceVertexPtr current, head;
+    DLFLFaceVertexPtr efvp1, efvp2;
+
+    // The faces are numbered for the topology changes that follow
+    for (int i=0; i < num_verts; ++i) verts[i]->setIndex(i);
+    for (int i=0; i < num_faces; ++i) faces[i]->setIndex(i);
+
+    // Faces and edges around each vertex, in list order
+    vector<int> vfstart(num_verts+1,0), vestart(num_verts+1,0);
+    vector<int> vfaces, vedges;
+    for (int i=0; i < num_faces; ++i) {
+      current = head = faces[i]->front();
+      do {
+				++vfstart[current->vertex->getIndex()+1]; current = current->next();
+      } while ( current != head );
+    }
+    for (int i=0; i < num_edges; ++i) {
+      edges[i]->getFaceVertexPointers(efvp1,efvp2);
+      ++vestart[efvp1->vertex->getIndex()+1]; ++vestart[efvp2->vertex->getIndex()+1];
+    }
+    for (int i=0; i < num_verts; ++i) {
+      vfstart[i+1] += vfstart[i]; vestart[i+1] += vestart[i];
+    }
+    vfaces.resize(vfstart[num_verts]); vedges.resize(vestart[num_verts]);
+    vector<int> vfnext(vfstart.begin(),vfstart.end()-1), venext(vestart.begin(),vestart.end()-1);
+    for (int i=0; i < num_faces; ++i) {
+      current = head = faces[i]->front();
+      do {
+				vfaces[vfnext[current->vertex->getIndex()]++] = i; current = current->next();
+      } while ( current != head );
+    }
+    for (int i=0; i < num_edges; ++i) {
+      edges[i]->getFaceVertexPointers(efvp1,efvp2);
+      vedges[venext[efvp1->vertex->getIndex()]++] = i;
+      vedges[venext[efvp2->vertex->getIndex()]++] = i;
+    }
+
+    // Face points
+#pragma omp parallel for num_threads(nthreads) schedule(static)
+    for (int i=0; i < num_faces; ++i)
+      faces[i]->setAuxCoords(faces[i]->geomCentroid());
+
+    // Edge points. The midpoints are kept for the vertex points
+    Vector3dArray midpoints(num_edges);
+#pragma omp parallel for num_threads(nthreads) schedule(static)
+    for (int i=0; i < num_edges; ++i) {
+      DLFLEdgePtr ep = edges[i];
+      DLFLFacePtr efp1, efp2;
+      ep->getFacePointers(efp1,efp2);
+      Vector3d mp = ep->getMidPoint(true);
+      Vector3d afp = ( efp1->getAuxCoords() + efp2->getAuxCoords() ) / 2.0;
+      ep->setAuxCoords((mp + afp)/2.0);
+      midpoints[i] = mp;
+    }
+
+    // Vertex points
+#pragma omp parallel for num_threads(nthreads) schedule(static)
+    for (int i=0; i < num_verts; ++i) {
+      DLFLVertexPtr vp = verts[i];
+      int n = vp->valence();
+      Vector3d ave_fep;
+      for (int j=vfstart[i]; j < vfstart[i+1]; ++j)
+				ave_fep += faces[vfaces[j]]->getAuxCoords();
+      for (int j=vestart[i]; j < vestart[i+1]; ++j)
+				ave_fep += 2.0*midpoints[vedges[j]];
+      ave_fep /= double(n);
+      vp->coords = ( ave_fep + (vp->coords)*(n-3.0) ) /double(n);
+      vp->resetAuxCoords();
+    }
+  }
+
+  void catmullClarkSubdivide( DLFLObjectPtr obj, DLFLProgressPtr progress ) {
     // Catmull-Clark subdivision surfaces implementation
 
     // Commonly used variables
@@ -1412,82 +1469,91 @@ namespace DLFL {
     int num_old_faces, num_old_edges;
   
 
-    // Reset aux coords in each vertex
-    vl_first = obj->beginVertex(); vl_last = obj->endVertex();
-    while ( vl_first != vl_last ) {
-      vp = (*vl_first); ++vl_first;
-      vp->resetAuxCoords();
-    }
+    Vector3d edgept;
+
+    if ( subdivisionThreads() > 1 ) {
+      catmullClarkPoints(obj);
+      num_faces = obj->num_faces();
+    } else {
+      // Reset aux coords in each vertex
+      vl_first = obj->beginVertex(); vl_last = obj->endVertex();
+      while ( vl_first != vl_last ) {
+        vp = (*vl_first); ++vl_first;
+        vp->resetAuxCoords();
+      }
   
-    // Compute the coordinates of the new points and store them in the aux-coords
-    // fields of each class
+      // Compute the coordinates of the new points and store them in the aux-coords
+      // fields of each class
   
-    // Go through each face and compute the centroid and store it in the aux-coords field
-    // Do the makeUnique also to make sure Face IDs are consecutive
-    // Send the contribution to all vertexes belonging to this face
-    Vector3d cen;
-    num_faces = 0;
-    fl_first = obj->beginFace(); fl_last = obj->endFace();
-    while ( fl_first != fl_last ) {
-      fp = (*fl_first); ++fl_first; ++num_faces;
-      cen = fp->geomCentroid();
-      fp->setAuxCoords(cen); fp->makeUnique();
-
-      // Send contribution of this face to all vertices in this face
-      DLFLFaceVertexPtr current, head;
-      current = head = fp->front();
-      current->vertex->addToAuxCoords(cen); current = current->next();
-      while ( current != head ) {
-				current->vertex->addToAuxCoords(cen); current = current->next();
+      // Go through each face and compute the centroid and store it in the aux-coords field
+      // Number the faces for the point-spheres below
+      // Send the contribution to all vertexes belonging to this face
+      Vector3d cen;
+      num_faces = 0;
+      fl_first = obj->beginFace(); fl_last = obj->endFace();
+      while ( fl_first != fl_last ) {
+        fp = (*fl_first); ++fl_first;
+        cen = fp->geomCentroid();
+        fp->setAuxCoords(cen); fp->setIndex(num_faces++);
+
+        // Send contribution of this face to all vertices in this face
+        DLFLFaceVertexPtr current, head;
+        current = head = fp->front();
+        current->vertex->addToAuxCoords(cen); current = current->next();
+        while ( current != head ) {
+  				current->vertex->addToAuxCoords(cen); current = current->next();
+        }
       }
-    }
 
-    // Go through each edge and compute the new edge point coordinates
-    // Send contribution of each edge to the vertexes at the ends
-    Vector3d mp,afp,edgept;
-    num_edges = 0;
-    el_first = obj->beginEdge(); el_last = obj->endEdge();
-    while ( el_first != el_last ) {
-      ep = (*el_first); ++el_first; ++num_edges;
-      ep->getFacePointers(efp1,efp2);
-      mp = ep->getMidPoint(true); afp = ( efp1->getAuxCoords() + efp2->getAuxCoords() ) / 2.0;
-      edgept = (mp + afp)/2.0;
-      ep->setAuxCoords(edgept);
+      // Go through each edge and compute the new edge point coordinates
+      // Send contribution of each edge to the vertexes at the ends
+      Vector3d mp,afp;
+      num_edges = 0;
+      el_first = obj->beginEdge(); el_last = obj->endEdge();
+      while ( el_first != el_last ) {
+        ep = (*el_first); ++el_first; ++num_edges;
+        ep->getFacePointers(efp1,efp2);
+        mp = ep->getMidPoint(true); afp = ( efp1->getAuxCoords() + efp2->getAuxCoords() ) / 2.0;
+        edgept = (mp + afp)/2.0;
+        ep->setAuxCoords(edgept);
+
+        // Send contribution of this edge to its 2 corners
+        DLFLFaceVertexPtr efvp1, efvp2;
+        ep->getFaceVertexPointers(efvp1,efvp2);
+        efvp1->vertex->addToAuxCoords(2.0*mp); efvp2->vertex->addToAuxCoords(2.0*mp);
+      }
 
-      // Send contribution of this edge to its 2 corners
-      DLFLFaceVertexPtr efvp1, efvp2;
-      ep->getFaceVertexPointers(efvp1,efvp2);
-      efvp1->vertex->addToAuxCoords(2.0*mp); efvp2->vertex->addToAuxCoords(2.0*mp);
+      // Go through each vertex and compute the new vertex point coordinates
+      // and change the coordinate to be the new one
+      Vector3d vertexpt, ave_fep; // Contribution from faces and edges
+      int n;
+      vl_first = obj->beginVertex(); vl_last = obj->endVertex();
+      while ( vl_first != vl_last ) {
+        vp = (*vl_first); ++vl_first;
+        n = vp->valence();
+        ave_fep = vp->getAuxCoords(); vp->resetAuxCoords();
+        ave_fep /= double(n);
+        vertexpt = ( ave_fep + (vp->coords)*(n-3.0) ) /double(n);
+        vp->coords = vertexpt;
+      }
     }
 
-    // Go through each vertex and compute the new vertex point coordinates
-    // and change the coordinate to be the new one
-    Vector3d vertexpt, ave_fep; // Contribution from faces and edges
-    int n;
-    vl_first = obj->beginVertex(); vl_last = obj->endVertex();
-    while ( vl_first != vl_last ) {
-      vp = (*vl_first); ++vl_first;
-      n = vp->valence();
-      ave_fep = vp->getAuxCoords(); vp->resetAuxCoords();
-      ave_fep /= double(n);
-      vertexpt = ( ave_fep + (vp->coords)*(n-3.0) ) /double(n);
-      vp->coords = vertexpt;
-    }
-  
     // Now create point-spheres for each Face. Store a pointer to the FaceVertex in
-    // a temporary array indexed using the Face ID. For this makeUnique has to be
-    // applied to the face list to make the Face IDs consecutive.
+    // a temporary array indexed using the face index set above.
     DLFLVertexPtrArray psarray; // Array of point spheres (vertices)
-    int fistart, faceindex;
+    int faceindex;
 
     psarray.reserve(num_faces); psarray.resize(num_faces,NULL);
     fl_first = obj->beginFace(); fl_last = obj->endFace();
-    fistart = (*fl_first)->getID();
+
+    // The new points are in place. Progress counts the changes to the topology
+    if ( progress ) progress->setMaximum(num_faces+3*obj->num_edges());
 
     num_old_faces = num_faces; num_faces = 0;
     while ( fl_first != fl_last && num_faces < num_old_faces ) {
+      if ( progress && !progress->step() ) return;
       fp = (*fl_first); ++fl_first; ++num_faces;
-      faceindex = fp->getID() - fistart;
+      faceindex = fp->getIndex();
       fvp = obj->createPointSphere(fp->getAuxCoords(),fp->material());
       // Assign color and texture coords as centroid of old face
       fvp->color = fp->colorCentroid(); fvp->texcoord = fp->textureCentroid();
@@ -1510,6 +1576,7 @@ namespace DLFL {
     el_first = obj->beginEdge(); el_last = obj->endEdge();
     fvparray.reserve(2);
     while ( el_first != el_last && num_edges < num_old_edges ) {
+      if ( progress && !progress->step() ) return;
       ep = (*el_first); ++el_first; ++num_edges;
 
       edgept = ep->getAuxCoords(); ep->resetAuxCoords();
@@ -1519,7 +1586,7 @@ namespace DLFL {
 
       for (int i=0; i < fvparray.size(); ++i) {
 				fvp = fvparray[i];
-				faceindex = (fvp->getFacePtr())->getID() - fistart;
+				faceindex = (fvp->getFacePtr())->getIndex();
 				fvplist[connindex] = fvp; vplist[connindex] = psarray[faceindex];
 				++connindex;
       }
@@ -1533,6 +1600,7 @@ namespace DLFL {
     // Make all connections
     DLFLFaceVertexPtr fvp1, fvp2;
     for (int j=0; j < numconn; ++j) {
+      if ( progress && !progress->step() ) return;
       fvp1 = fvplist[j];
        
       // Find the face-vertex referring to vp which is in the same face as fvp1
@@ -1902,26 +1970,19 @@ namespace DLFL {
     Vector3dArray new_vertex_coords;
     int num_old_faces, num_old_edges, num_old_verts;
     int num_faces, num_edges, num_verts;
-    int eistart, edgeindex;
+    int edgeindex;
 
     num_old_verts = obj->num_vertices();
     num_old_faces = obj->num_faces();
     num_old_edges = obj->num_edges();
 
-    // Apply make-unique on the obj->num_edges to make sure all Edge IDs are consecutive
-    DLFLEdgePtrList::iterator efirst=obj->beginEdge(), elast=obj->endEdge();
-    while ( efirst != elast ) {
-      (*efirst)->makeUnique();
-      ++efirst;
-    }
+    // Number the edges so they can be used as indices in the temporary lists
+    obj->indexEdges();
   
     // Reserve and create num_old_edges entries in the 2 temporary lists
     eplist1.reserve(num_old_edges); eplist2.reserve(num_old_edges);
     eplist1.resize(num_old_edges,NULL); eplist2.resize(num_old_edges,NULL);
 
-    // Find starting edge ID to use as offset.
-    eistart = (obj->firstEdge())->getID();
-
     fl_first = obj->beginFace(); fl_last = obj->endFace(); num_faces = 0;
     while ( fl_first != fl_last && num_faces < num_old_faces ) {
       fp = (*fl_first); ++fl_first; ++num_faces;
@@ -1960,7 +2021,7 @@ namespace DLFL {
 				fvp1 = head1 = fp->front(); fvp2 = head2 = ifp->back();
             
 				ep = fvp1->getEdgePtr(); iep = fvp2->getEdgePtr();
-				edgeindex = ep->getID() - eistart;
+				edgeindex = ep->getIndex();
 				if ( eplist1[edgeindex] == NULL )
 					eplist1[edgeindex] = iep;
 				else
@@ -1970,7 +2031,7 @@ namespace DLFL {
 				fvp1 = fvp1->next(); fvp2 = fvp2->prev();
 				while ( fvp1 != head1 && fvp2 != head2 ) {
 					ep = fvp1->getEdgePtr(); iep = fvp2->getEdgePtr();
-					edgeindex = ep->getID() - eistart;
+					edgeindex = ep->getIndex();
 					if ( eplist1[edgeindex] == NULL )
 						eplist1[edgeindex] = iep;
 					else
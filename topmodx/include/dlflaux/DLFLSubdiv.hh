@@ -30,11 +30,16 @@
 #define _DLFLSUBDIV_H_
 
 #include <DLFLObject.hh>
-// #include <QApplication>
-// #include <QProgressDialog>
+#include <DLFLProgress.hh>
 
 namespace DLFL {
 
+  // Number of threads used by Catmull-Clark and Doo-Sabin subdivision. 0 means one
+  // per processor. With 1 the original serial code runs, which gives the reference
+  // the threaded code is compared against : both produce identical coordinates
+  void setSubdivisionThreads( int n );
+  int subdivisionThreads( );
+
   void loopSubdivide( DLFLObjectPtr obj );
   void checkerBoardRemeshing(DLFLObjectPtr obj, double thickness=0.33);
   void simplestSubdivide( DLFLObjectPtr obj );
@@ -42,14 +47,16 @@ namespace DLFL {
   void pentagonalSubdivide2(DLFLObjectPtr obj, double scale_factor=0.75);
   void pentagonalSubdivide(DLFLObjectPtr obj, double offset=0);
   void honeycombSubdivide(DLFLObjectPtr obj);
-  bool dooSabinSubdivide(DLFLObjectPtr obj, bool check=true /*,QProgressDialog *progress = 0*/);
+  // Long running schemes report to and can be stopped through progress, if given.
+  // A stopped subdivision leaves the object half done, so the caller restores it
+  bool dooSabinSubdivide(DLFLObjectPtr obj, bool check=true, DLFLProgressPtr progress=NULL);
   void dooSabinSubdivideBC(DLFLObjectPtr obj, bool check=true);
   void dooSabinSubdivideBCNew(DLFLObjectPtr obj, double sf, double length);
   void cornerCuttingSubdivide(DLFLObjectPtr obj, float alpha);
   void modifiedCornerCuttingSubdivide(DLFLObjectPtr obj, double thickness);
   void modifiedCornerCuttingSubdivide2(DLFLObjectPtr obj, double thickness);
   void root4Subdivide(DLFLObjectPtr obj, double a=0.0, double twist=0.0);  
-  void catmullClarkSubdivide( DLFLObjectPtr obj );
+  void catmullClarkSubdivide( DLFLObjectPtr obj, DLFLProgressPtr progress=NULL );
   void starSubdivide(DLFLObjectPtr obj, double offset = 0.0);
   void sqrt3Subdivide( DLFLObjectPtr obj );
   void fractalSubdivide(DLFLObjectPtr obj, double offset = 1.0);
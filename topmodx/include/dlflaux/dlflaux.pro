@@ -7,6 +7,11 @@ TARGET = dlflaux
 INCLUDEPATH += .. ../vecmat ../dlflcore
 DESTDIR = ../../lib
 
+# Catmull-Clark and Doo-Sabin subdivision run in parallel with OpenMP
+!macx {
+ QMAKE_CXXFLAGS += -fopenmp
+}
+
 macx {
  # compile release + universal binary
  #QMAKE_LFLAGS += -F../../lib
@@ -78,6 +78,7 @@ namespace DLFL {
   class DLFLFace;
   class DLFLObject;
   class DLFLMaterial;
+  class DLFLJournal;
   //class TMPatch;
   //class TMPatchFace;
 
@@ -87,6 +88,7 @@ namespace DLFL {
   typedef DLFLFace * DLFLFacePtr;
   typedef DLFLObject * DLFLObjectPtr;
   typedef DLFLMaterial * DLFLMaterialPtr;
+  typedef DLFLJournal * DLFLJournalPtr;
   //typedef TMPatch * TMPatchPtr;
   //typedef TMPatchFace * TMPatchFacePtr;
 
@@ -192,6 +194,27 @@ namespace DLFL {
 
   //-- Common utility functions --//
 
+  /*
+    ID counters shared by all objects of a class. Both functions are atomic, so
+    elements can be created from several threads, e.g. while operators run on
+    different objects at the same time.
+  */
+
+  // Hand out the next ID
+  inline uint newIDFrom(uint& counter) {
+    return __sync_fetch_and_add(&counter,1);
+  }
+
+  // Make sure the counter is past the given ID, e.g. after reading a file
+  inline void raiseIDCounter(uint& counter, uint id) {
+    uint last = counter;
+    while ( id > last ) {
+      uint seen = __sync_val_compare_and_swap(&counter,last,id);
+      if ( seen == last ) break;
+      last = seen;
+    }
+  }
+
   /*
     Remove node specified by index from vector specified by array
     It is assumed that order of elements within the array is not important.
@@ -206,6 +229,46 @@ namespace DLFL {
     array.pop_back();
   }
 
+  /*
+    Position of an element in a list which holds it, so the element can be
+    removed from the list in constant time instead of searching for it.
+    An element is in at most one list of a given kind (e.g. the face list of
+    its object, the face list of its material), and carries a handle for each.
+    Copies of an element are not in the list, so copying a handle gives an
+    unlisted one and assigning a handle leaves it unchanged.
+  */
+
+  template <class T>
+  class DLFLListHandle {
+  public :
+
+    DLFLListHandle( ) : listed(false) { }
+    DLFLListHandle( const DLFLListHandle& ) : listed(false) { }
+    DLFLListHandle& operator = ( const DLFLListHandle& ) { return *this; }
+
+    bool isListed( ) const { return listed; }
+
+    // Add the element to the end of the list
+    void push_back( list<T>& l, T item ) {
+      position = l.insert(l.end(),item); listed = true;
+    }
+
+    // Remove the element from the list it was added to. Returns false if it wasn't in one
+    bool erase( list<T>& l ) {
+      if ( !listed ) return false;
+      l.erase(position); listed = false;
+      return true;
+    }
+
+    // The list was cleared or destroyed without erasing the element
+    void reset( ) { listed = false; }
+
+  private :
+
+    typename list<T>::iterator position;
+    bool listed;
+  };
+
   // Functions to clear lists/arrays of pointers, where the lists/arrays own
   // the objects pointed to.
   // These are needed since the STL functions merely erase the node
@@ -231,14 +294,28 @@ namespace DLFL {
   void clear(DLFLObjectPtrList& oplist);
   void clear(DLFLMaterialPtrList& mplist);
 
-  struct eqstr {
-    bool operator() ( int a, int b ) const {
-      return a == b;
+  // Key for looking up an edge by the IDs of its 2 end vertices.
+  // The smaller ID is always stored first so both orientations map to the same key
+  struct EdgeKey {
+    unsigned int v1, v2;
+
+    EdgeKey(unsigned int id1, unsigned int id2) {
+      if ( id1 < id2 ) { v1 = id1; v2 = id2; }
+      else { v1 = id2; v2 = id1; }
+    }
+
+    bool operator == (const EdgeKey& ek) const {
+      return ( v1 == ek.v1 ) && ( v2 == ek.v2 );
+    }
+  };
+
+  struct EdgeKeyHash {
+    size_t operator() ( const EdgeKey& ek ) const {
+      return (size_t)ek.v1 * 2654435761u + (size_t)ek.v2;
     }
   };
 
-  typedef __gnu_cxx::hash<unsigned int> Hash;
-  typedef __gnu_cxx::hash_map<unsigned int, unsigned int, Hash, eqstr> HashMap;
+  typedef __gnu_cxx::hash_map<EdgeKey, DLFLEdgePtr, EdgeKeyHash> EdgeIndex;
 
 } // end namespace
 
@@ -36,6 +36,7 @@
  */
 
 #include "DLFLCore.hh"
+#include "DLFLJournal.hh"
 #include <cmath>
 #include <cassert>
 
@@ -112,6 +113,9 @@ namespace DLFL {
     DLFLFacePtr fp = fvptr1->getFacePtr();
     DLFLMaterialPtr matl = fp->material();
 
+    if ( obj->journal() ) obj->journal()->recordFace(fp);
+    obj->markChanged(fp);
+
     DLFLEdgePtr edgeptr;
     //Pointer to the new Edge
     DLFLFacePtr newfaceptr;
@@ -201,6 +205,12 @@ namespace DLFL {
     int numverts1 = 0, numverts2 = 0;
     //No.of verts in each face
 
+    if ( obj->journal() ) {
+      obj->journal()->recordFace(fp1);
+      obj->journal()->recordFace(fp2);
+    }
+    obj->markChanged(fp1); obj->markChanged(fp2);
+
     numverts1 = fp1->size();
     numverts2 = fp2->size();
 
@@ -253,7 +263,7 @@ namespace DLFL {
     }
     //Delete face 2 from the face list and free the pointer
     obj->removeFace(fp2);
-    delete fp2;
+    obj->release(fp2);
 
     //Create the new Edge and do necessary updates
     newedgeptr = new DLFLEdge;
@@ -304,6 +314,9 @@ namespace DLFL {
     f1 = fvpV1->getFacePtr();
     f2 = fvpV2->getFacePtr();
 
+    if ( obj->journal() ) obj->journal()->recordEdge(edgeptr);
+    obj->markChanged(edgeptr);
+
     if (f1 != f2) {
       //Two edge sides belong to different faces
 
@@ -341,18 +354,17 @@ namespace DLFL {
       fvpV2->deleteSelfFromVertex();
 
       //Free memory for fvpV1 and fvpV2
-      delete fvpV1;
-      delete fvpV2;
+      obj->release(fvpV1);
+      obj->release(fvpV2);
 
       //The Edge can now be removed from the EdgeList
       // Free the pointer also since the edge_list owns the DLFLEdge pointed to by edgeptr
       obj->removeEdge(edgeptr);
-      delete edgeptr;
+      obj->release(edgeptr);
 
-      //Destroy f2 and delete it from the face list
-      f2->destroy();
+      //Delete f2 from the face list. It has no face-vertices left
       obj->removeFace(f2);
-      delete f2;
+      obj->release(f2);
 			rfpa.push_back(f1);
     } else {
       //Two edge sides belong to same face
@@ -390,7 +402,7 @@ namespace DLFL {
       //Remove fvpV2 from f1 and free the pointer.Remove fvpV2 from face - vertex - list of its vertex also
       f1->deleteVertexPtr(fvpV2);
       fvpV2->deleteSelfFromVertex();
-      delete fvpV2;
+      obj->release(fvpV2);
 			
       //Now check if fvpV1 is the only vertex in f1.If so f1 becomes a point sphere
       // Don 't delete fvpV1 from f1. Otherwise delete fvpV1 from f1 and free the pointer
@@ -398,12 +410,12 @@ namespace DLFL {
 				//Remove fvpV1 from the face - vertex - list of its vertex also
 				f1->deleteVertexPtr(fvpV1);
 				fvpV1->deleteSelfFromVertex();
-				delete fvpV1;
+				obj->release(fvpV1);
       }
       //The Edge can now be removed from the EdgeList
       // Free the pointer also, since edge_list owns the object pointed to by edgeptr
       obj->removeEdge(edgeptr);
-      delete edgeptr;
+      obj->release(edgeptr);
       
       //Add the new Face to the FaceList
       obj->addFacePtr(nfp);
@@ -428,25 +440,24 @@ namespace DLFL {
 					fvp = f1->firstVertex();
 					vp = fvp->vertex;
 					obj->removeVertex(vp);
-					delete vp;
+					obj->release(vp);
 
-					f1->destroy();
+					//Releasing the face also frees its only face-vertex
 					obj->removeFace(f1);
 					if(!rfpa.empty())
 						rfpa.erase( rfpa.begin() );
-					delete f1;
+					obj->release(f1);
 				}
 				if (nfp->size() == 1) {
 					fvp = nfp->firstVertex();
 					vp = fvp->vertex;
 					obj->removeVertex(vp);
-					delete vp;
+					obj->release(vp);
 
-					nfp->destroy();
 					obj->removeFace(nfp);
 					if(!rfpa.empty())
 						rfpa.erase( --(rfpa.end()) );
-					delete nfp;
+					obj->release(nfp);
 				}
       }
     }
@@ -499,6 +510,12 @@ namespace DLFL {
     vp1 = efvp1->getVertexPtr();
     vp2 = efvp2->getVertexPtr();
 
+    if ( obj->journal() ) {
+      obj->journal()->recordEdge(edgeptr);
+      obj->journal()->recordVertex(vp2);
+    }
+    obj->markChanged(edgeptr);
+
     //Adjust coordinates of vp1 to be midpoint of collapsed edge
     vp1->setCoords(edgeptr->getMidPoint());
 
@@ -521,7 +538,7 @@ namespace DLFL {
     efvp1_next->deleteSelfFromEdge();
     efvp1_next->deleteSelfFromVertex();
     efvp1_next->deleteSelfFromFace();
-    delete efvp1_next;
+    obj->release(efvp1_next);
 
     //Reset edge pointer of efvp1 and make the edge point back to efvp1
     efvp1->setEdgePtr(efvp1_next_ep);
@@ -532,7 +549,7 @@ namespace DLFL {
     // For the same reason no edge pointers have to be adjusted
     efvp2->deleteSelfFromVertex();
     efvp2->deleteSelfFromFace();
-    delete efvp2;
+    obj->release(efvp2);
 
     //Go through all remaining face - vertices referring to vp2 and make them point
     // to vp1 instead.Since vp2 is going to be deleted anyway, these face - vertices
@@ -546,11 +563,11 @@ namespace DLFL {
 
     //Delete Vertex 2(vp2) from Vertex list and free memory
     obj->removeVertex(vp2);
-    delete vp2;
+    obj->release(vp2);
 
     //Delete edge to be collapsed from edge list and free memory
     obj->removeEdge(edgeptr);
-    delete edgeptr;
+    obj->release(edgeptr);
 
     //Do cleanup of 2 - gons if boolean flag is true
     if (cleanup == true) {
@@ -615,6 +632,9 @@ namespace DLFL {
 		if( f1 == NULL || f2 == NULL )
 			return NULL;
 
+    if ( obj->journal() ) obj->journal()->recordEdge(edgeptr);
+    obj->markChanged(edgeptr);
+
     //Edge subdivision will work whether the two Edge sides belong to different Faces
     // or not.
     DLFLVertexPtr nvp = new DLFLVertex;
@@ -678,7 +698,7 @@ namespace DLFL {
     //Remove the existing Edge from the EdgeList
     // Free the pointer also
     obj->removeEdge(edgeptr);
-    delete edgeptr;
+    obj->release(edgeptr);
 
     //Add the 2 new Edges into the EdgeList
     obj->addEdgePtr(nep1);
@@ -861,6 +881,14 @@ namespace DLFL {
   }
 
   void spliceCorners( DLFLObjectPtr obj, DLFLFaceVertexPtr fvptr1, DLFLFaceVertexPtr fvptr2) {
+    if ( obj->journal() ) {
+      // The collapse sees the face-vertices created by the insertion, so record
+      // everything it can touch before either step
+      obj->journal()->recordFace(fvptr1->getFacePtr());
+      obj->journal()->recordFace(fvptr2->getFacePtr());
+      obj->journal()->recordVertex(fvptr1->getVertexPtr());
+      obj->journal()->recordVertex(fvptr2->getVertexPtr());
+    }
     DLFLEdgePtr ep = insertEdge(obj,fvptr1, fvptr2);
     if (ep != NULL)
       collapseEdge(obj,ep);
@@ -870,16 +898,31 @@ namespace DLFL {
     DLFLObjectPtr obj;
     ifstream file, mtlfile;
 
+    char* ext = strrchr( filename, '.' );
+    if( ext == NULL )
+      return NULL;
+
+    // Binary files are memory mapped and carry their own materials
+    if( strcasecmp(ext,".dlfb") == 0 ) {
+      obj = new DLFLObject( );
+      if( !obj->readDLFB( filename ) ) {
+        delete obj;
+        return NULL;
+      }
+      obj->setFilename( filename );
+      obj->computeNormals( );
+      return obj;
+    }
+
     file.open( filename );
-		mtlfile.open(mtlfilename);
+		if (mtlfilename != NULL)
+			mtlfile.open(mtlfilename);
 		
     if( !file ) {
       return NULL;
     }
 
     obj = new DLFLObject( );
-    
-    char* ext = strrchr( filename, '.' );
 
     if( strcasecmp(ext,".obj") == 0 ) {
       obj->readObject( file, mtlfile);
@@ -892,7 +935,8 @@ namespace DLFL {
       obj = NULL;
     }
 
-    obj->computeNormals( );
+    if( obj != NULL )
+      obj->computeNormals( );
 
     file.close( );
 		mtlfile.close();
@@ -904,6 +948,19 @@ namespace DLFL {
     if( filename == NULL )
       filename = obj->getFilename( );
 
+    char* ext = strrchr( filename, '.' );
+    if( ext == NULL )
+      return false;
+
+    if( strcasecmp(ext,".dlfb") == 0 ) {
+      file.open( filename, ios::out | ios::binary );
+      if( !file )
+        return false;
+      bool wrote = obj->writeDLFB( file );
+      file.close();
+      return wrote;
+    }
+
     file.open( filename );
 
 		if (mtlfilename != NULL){
@@ -913,8 +970,7 @@ namespace DLFL {
     if( !file )
       return false;
      
-    char* ext = strrchr( filename, '.' );
-    bool wrote = false;
+    bool wrote = true;
     if( strcasecmp(ext,".obj") == 0 ) {
       obj->writeObject( file, mtlfile, true, true );
       //obj->setFilename( filename );
@@ -927,6 +983,8 @@ namespace DLFL {
     }	else if( strcasecmp(ext,".stl") == 0 ) {
       obj->writeSTL( file );
       //obj->setFilename( filename );
+    } else {
+      wrote = false;
     }
 		if (mtlfilename != NULL){
 			mtlfile.close();
@@ -935,6 +993,15 @@ namespace DLFL {
     return wrote;
   }
 
+  bool convertObjectFile( char* infilename, char* outfilename, char *inmtlfilename, char *outmtlfilename ) {
+    DLFLObjectPtr obj = readObjectFile( infilename, inmtlfilename );
+    if( obj == NULL )
+      return false;
+    bool wrote = writeObjectFile( obj, outfilename, outmtlfilename );
+    delete obj;
+    return wrote;
+  }
+
   /**
    * Cleanup
    */
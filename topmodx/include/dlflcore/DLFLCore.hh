@@ -135,6 +135,8 @@ namespace DLFL {
    * an object in OBJ format */
   DLFLObject* readObjectFile( char* filename, char *mtlfilename =NULL);
   bool writeObjectFile( DLFLObject *obj, char* filename = NULL, char *mtlfilename=NULL );
+  // Read a file and write it out again, the formats are picked by extension (.obj, .dlfl, .dlfb)
+  bool convertObjectFile( char* infilename, char* outfilename, char *inmtlfilename = NULL, char *outmtlfilename = NULL );
 
 	/************************
 	 * Create/Remove Vertex *
@@ -45,6 +45,20 @@ namespace DLFL {
 
   uint DLFLEdge::suLastID = 0;
 
+  static DLFLPool& edgePool( ) {
+    // Never destroyed : elements of static objects may be freed after it
+    static DLFLPool *pool = new DLFLPool(sizeof(DLFLEdge));
+    return *pool;
+  }
+
+  void* DLFLEdge::operator new( size_t size ) {
+    return edgePool().allocate(size);
+  }
+
+  void DLFLEdge::operator delete( void *p, size_t size ) {
+    edgePool().deallocate(p,size);
+  }
+
   void DLFLEdge::dump(ostream& o) const
   {
     o << "DLFLEdge" << endl
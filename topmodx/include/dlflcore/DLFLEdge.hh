@@ -43,16 +43,23 @@
 // is stored
 
 #include "DLFLCommon.hh"
+#include "DLFLPool.hh"
 
 namespace DLFL {
 
   class DLFLEdge {
   public :
     static void setLastID( uint id ) {
-      if( id > suLastID )
-				suLastID = id;
+      raiseIDCounter(suLastID,id);
     };
 
+    // Last ID handed out. Changes whenever an element gets a new ID
+    static uint lastID( ) { return suLastID; };
+
+    // Instances are allocated from a pool, see DLFLPool.hh
+    static void* operator new( size_t size );
+    static void operator delete( void *p, size_t size );
+
   protected :
     static uint suLastID;                             // Distinct ID for each instance
     // The last assigned ID is stored in this
@@ -61,11 +68,13 @@ namespace DLFL {
     DLFLFaceVertexPtr  fvpV1;
     DLFLFaceVertexPtr  fvpV2;
     uint uID;                                         // ID for this Edge
+    uint               index;                         // Position in the edge list, see DLFLObject::indexEdges
     DLFLEdgeType       etType;                        // For use in subdivision surfaces
     Vector3d           auxcoords;                     // Coords for use during subdivs, etc.
     Vector3d           auxnormal;                     // Extra storage for normal
     Vector3d           midpoint;                      // Midpoint of edge (not always current)
     Vector3d           normal;                        // Edge normal (at midpoint, not always current)
+    DLFLListHandle<DLFLEdgePtr> list_handle;          // Position in the edge list of the object
 
   public :
 
@@ -79,9 +88,7 @@ namespace DLFL {
 
     // Generate a new unique ID
     static uint newID(void) {
-      uint temp = suLastID;
-      suLastID++;
-      return temp;
+      return newIDFrom(suLastID);
     }
      
     // Assign a unique ID for this instance
@@ -101,12 +108,12 @@ namespace DLFL {
 
     // Default constructor
     DLFLEdge()
-      : fvpV1(NULL), fvpV2(NULL), etType(ETNormal), auxcoords(), auxnormal(), midpoint(), normal(), flags(0)
+      : fvpV1(NULL), fvpV2(NULL), index(0), etType(ETNormal), auxcoords(), auxnormal(), midpoint(), normal(), flags(0)
     { assignID(); }
 
     // 2 & 3 argument constructor
     DLFLEdge(DLFLFaceVertexPtr fvp1, DLFLFaceVertexPtr fvp2, bool update=true)
-      : fvpV1(fvp1), fvpV2(fvp2), etType(ETNormal), auxcoords(), auxnormal(), midpoint(), normal(), flags(0)
+      : fvpV1(fvp1), fvpV2(fvp2), index(0), etType(ETNormal), auxcoords(), auxnormal(), midpoint(), normal(), flags(0)
     {
       if ( update ) {
 				updateNormal();
@@ -117,7 +124,7 @@ namespace DLFL {
 
     // Copy constructor
     DLFLEdge(const DLFLEdge& e)
-      : fvpV1(e.fvpV1), fvpV2(e.fvpV2), uID(e.uID), etType(e.etType), auxcoords(e.auxcoords), auxnormal(e.auxnormal),
+      : fvpV1(e.fvpV1), fvpV2(e.fvpV2), uID(e.uID), index(e.index), etType(e.etType), auxcoords(e.auxcoords), auxnormal(e.auxnormal),
 				midpoint(e.midpoint), normal(e.normal), flags(e.flags)
     {}
 
@@ -227,6 +234,14 @@ namespace DLFL {
       return uID;
     }
 
+    uint getIndex(void) const {
+      return index;
+    }
+
+    void setIndex(uint i) {
+      index = i;
+    }
+
     Vector3d getMidPoint(bool update=false) {
 			if( update )
 				updateMidPoint();
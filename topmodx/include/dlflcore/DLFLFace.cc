@@ -51,6 +51,20 @@ namespace DLFL {
   // Define the static variable. Initialized to 0
   uint DLFLFace::suLastID = 0;
 
+  static DLFLPool& facePool( ) {
+    // Never destroyed : elements of static objects may be freed after it
+    static DLFLPool *pool = new DLFLPool(sizeof(DLFLFace));
+    return *pool;
+  }
+
+  void* DLFLFace::operator new( size_t size ) {
+    return facePool().allocate(size);
+  }
+
+  void DLFLFace::operator delete( void *p, size_t size ) {
+    facePool().deallocate(p,size);
+  }
+
   /*
     Traversing the Face using the DLFLFaceVertexPtr
 
@@ -98,7 +112,7 @@ namespace DLFL {
 
   // Constructor
   DLFLFace::DLFLFace( DLFLMaterialPtr mp )
-    : head(NULL), matl_ptr(mp), ftType(FTNormal), auxcoords(), auxnormal(), centroid(), normal(), flags(0)
+    : index(0), head(NULL), num_corners(0), matl_ptr(mp), ftType(FTNormal), auxcoords(), auxnormal(), centroid(), normal(), flags(0)
   {
     assignID();
     // Add this face to the face-list of any associated material
@@ -107,7 +121,7 @@ namespace DLFL {
 
   // Copy constructor
   DLFLFace::DLFLFace(const DLFLFace& face)
-    : uID(face.uID), head(NULL), matl_ptr(face.matl_ptr), ftType(face.ftType),
+    : uID(face.uID), index(face.index), head(NULL), num_corners(0), matl_ptr(face.matl_ptr), ftType(face.ftType),
       auxcoords(face.auxcoords), auxnormal(face.auxnormal), centroid(face.centroid), normal(face.normal), flags(face.flags)
   {
     copy(face.head);
@@ -150,7 +164,7 @@ namespace DLFL {
 				delete temp;
       }
     }
-    head = NULL;
+    head = NULL; num_corners = 0;
   }
 
   // Assignment operator
@@ -206,6 +220,7 @@ namespace DLFL {
       // Make the new face-vertex the head
       head = dfvp;
     }
+    ++num_corners;
   }
 
   void DLFLFace::deleteVertexPtr(DLFLFaceVertexPtr dfvp) {
@@ -218,13 +233,14 @@ namespace DLFL {
     if ( n == p && n == dfvp ) {  // Lone vertex in this face
       // NOTE: If n == p, it does not mean that this is the only vertex
       // n == p will be true even when there are 2 vertices only in the face
-      head = NULL;
+      head = NULL; num_corners = 0;
       return;
     }
   
     n->prev() = p; p->next() = n;
 
     if ( head == dfvp ) head = n;
+    --num_corners;
 
     // Reset dfvp's pointers to point to itself
     dfvp->next() = dfvp; dfvp->prev() = dfvp; dfvp->setFacePtr(NULL);
@@ -559,18 +575,6 @@ namespace DLFL {
     }
   }
 
-  uint DLFLFace::size(void) const {
-    int num=0;
-    if ( head ) {
-      DLFLFaceVertexPtr current = head; 
-      ++num; current = current->next();
-      while ( current != head ) {
-				++num; current = current->next();
-      }
-    }
-    return num;
-  }
-
   void DLFLFace::resetTypeDeep(void) {
     resetType();
     if ( head ) {
@@ -939,6 +943,7 @@ namespace DLFL {
     fvp->next()->prev() = fvp;
     fvp->prev() = fvptr;
     fvptr->next() = fvp;
+    ++num_corners;
 
     return fvp;
   }
@@ -1233,19 +1238,18 @@ namespace DLFL {
 	float DLFLFace::getArea(){
 		updateCentroid();
 
-		vector<DLFLEdgePtr>::iterator eit;
-		DLFLEdgePtrArray eptrarray;
-		
 		float area = 0;
-		//get the edges for the current face
-		getEdges(eptrarray);
-		for(eit = eptrarray.begin(); eit != eptrarray.end(); eit++){
-			//get the 2 faces for the current edge, select them if they aren't already selected
+		if ( head ) {
+			//walk the corners instead of collecting the edges of the face first
+			DLFLFaceVertexPtr current = head;
 			DLFLVertexPtr vp1, vp2;
-			//get the two vertices for each edge, select them if they aren't already selected
-			(*eit)->getVertexPointers(vp1,vp2);
-			//find the area of this triangle
-			area += 0.5 * (vp1->coords-centroid)*(vp1->coords-vp2->coords);
+			do {
+				//get the two vertices of the edge after this corner
+				current->getEdgePtr()->getVertexPointers(vp1,vp2);
+				//find the area of this triangle
+				area += 0.5 * (vp1->coords-centroid)*(vp1->coords-vp2->coords);
+				current = current->next();
+			} while ( current != head );
 		}
 		return area;
 	}
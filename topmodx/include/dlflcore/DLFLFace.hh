@@ -41,6 +41,7 @@
 // A DLFLFace can be implemented as a 2-3 Tree or as a linked list
 
 #include "DLFLCommon.hh"
+#include "DLFLPool.hh"
 #include "DLFLFaceVertex.hh"
 #include "DLFLMaterial.hh"
 //#include <Light/Light.hh>
@@ -50,25 +51,34 @@ namespace DLFL {
   class DLFLFace {
   public :
     static void setLastID( uint id ) {
-      if( id > suLastID )
-				suLastID = id;
+      raiseIDCounter(suLastID,id);
     };
+
+    // Last ID handed out. Changes whenever an element gets a new ID
+    static uint lastID( ) { return suLastID; };
+
+    // Instances are allocated from a pool, see DLFLPool.hh
+    static void* operator new( size_t size );
+    static void operator delete( void *p, size_t size );
+
   protected :
 
     static uint suLastID;                             //!< Distinct ID for each instance
 
     static uint newID(void) {                           //!< Generate a new unique ID
-      uint temp = suLastID;
-      suLastID++;
-      return temp;
+      return newIDFrom(suLastID);
     }
      
     uint uID;                                         //!< ID for this Face
+    uint                  index;                      //!< Position in the face list, see DLFLObject::indexFaces
     DLFLFaceVertexPtr     head;                       //!< Head of list of face-vertex pointers
+    uint                  num_corners;                //!< Length of the list, kept up to date as it changes
     DLFLMaterialPtr       matl_ptr;                   //!< Pointer to material for this face
     DLFLFaceType          ftType;                     //!< For use in subdivision surfaces
     Vector3d              auxcoords;                  //!< Coords for use during subdivs, etc.
     Vector3d              auxnormal;                  //!< Extra storage for normal
+    DLFLListHandle<DLFLFacePtr> list_handle;          //!< Position in the face list of the object
+    DLFLListHandle<DLFLFacePtr> matl_handle;          //!< Position in the face list of the material
 
   public :
      
@@ -167,6 +177,14 @@ namespace DLFL {
       return uID;
     }
 
+    uint getIndex(void) const {
+      return index;
+    }
+
+    void setIndex(uint i) {
+      index = i;
+    }
+
     DLFLFaceType getType(void) const {
       return ftType;
     }
@@ -279,7 +297,9 @@ namespace DLFL {
       auxnormal.reset();
     }
      
-    uint size(void) const;                             // No. of vertices in this face
+    uint size(void) const {                            // No. of vertices in this face
+      return num_corners;
+    }
     uint numFaceVertexes(void) const {
       return size();
     }
@@ -369,6 +389,10 @@ namespace DLFL {
   protected :
     // Classes which need to access the reverse method should be declared as friends here
     friend class DLFLObject;
+    // Saves and restores the face state for undo
+    friend class DLFLJournal;
+    // Maintains matl_handle
+    friend class DLFLMaterial;
 
   public :
      
@@ -44,6 +44,20 @@ namespace DLFL {
 
   uint DLFLFaceVertex::suLastID = 0;
 
+  static DLFLPool& faceVertexPool( ) {
+    // Never destroyed : elements of static objects may be freed after it
+    static DLFLPool *pool = new DLFLPool(sizeof(DLFLFaceVertex));
+    return *pool;
+  }
+
+  void* DLFLFaceVertex::operator new( size_t size ) {
+    return faceVertexPool().allocate(size);
+  }
+
+  void DLFLFaceVertex::operator delete( void *p, size_t size ) {
+    faceVertexPool().deallocate(p,size);
+  }
+
   // Default constructor
   DLFLFaceVertex::DLFLFaceVertex( bool bf )
     : vertex(NULL), normal(), color(1), texcoord(), backface(bf), index(0),
@@ -60,10 +74,10 @@ namespace DLFL {
   
   // Copy constructor
   DLFLFaceVertex::DLFLFaceVertex( const DLFLFaceVertex& dfv )
-    : uID(dfv.uID), vertex(dfv.vertex), normal(dfv.normal), color(dfv.color), texcoord(dfv.texcoord),
+    : vertex(dfv.vertex), normal(dfv.normal), color(dfv.color), texcoord(dfv.texcoord),
       backface(false), index(dfv.index), epEPtr(dfv.epEPtr), fpFPtr(dfv.fpFPtr), 
       fvpNext(NULL), fvpPrev(NULL), fvtType(dfv.fvtType), auxcoords(dfv.auxcoords), auxnormal(dfv.auxnormal)
-  { fvpNext = this; fvpPrev = this; }
+  { assignID(); fvpNext = this; fvpPrev = this; }
 
   // Destructor
   DLFLFaceVertex::~DLFLFaceVertex() {}
@@ -46,6 +46,7 @@
 // It contains pointers to the next and previous nodes of the list
 
 #include "DLFLCommon.hh"
+#include "DLFLPool.hh"
 #include "DLFLCoreExt.hh"
 #include "DLFLEdge.hh"
 #include "DLFLVertex.hh"
@@ -55,16 +56,20 @@ namespace DLFL {
   class DLFLFaceVertex {
   public:
     static void setLastID( uint id ) {
-      if( id > suLastID )
-				suLastID = id;
+      raiseIDCounter(suLastID,id);
     };
+
+    // Last ID handed out. Changes whenever an element gets a new ID
+    static uint lastID( ) { return suLastID; };
+
+    // Instances are allocated from a pool, see DLFLPool.hh
+    static void* operator new( size_t size );
+    static void operator delete( void *p, size_t size );
   protected:
     static uint suLastID;
 
     static uint newID( ) {
-      uint temp = suLastID;
-      suLastID++;
-      return temp;
+      return newIDFrom(suLastID);
     };
 
   public :
@@ -92,10 +97,7 @@ namespace DLFL {
     //TMPatchPtr         tmpp;                          // Pointer to the TMPatch corresponding to this corner
 
     void assignID( ) {
-      // uID = DLFLFaceVertex::newID();
-			//std::cout << this;
-			uID = (unsigned int) this;
-			//std::cout << "->" << uID << std::endl;
+      uID = DLFLFaceVertex::newID();
     };
 
   public :
@@ -125,7 +127,8 @@ namespace DLFL {
 
     // Query Functions
     uint getIndex( ) const { return index; };
-    uint getID( ) { assignID(); return uID; };
+    void setIndex( uint i ) { index = i; };
+    uint getID( ) const { return uID; };
     DLFLFaceVertexType getType( ) const { return fvtType; };
     DLFLVertexType getVertexType( ) const { return vertex->getType(); };
     DLFLVertexPtr getVertexPtr( ) const { return vertex; };
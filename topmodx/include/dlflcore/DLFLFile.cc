@@ -40,13 +40,6 @@ namespace DLFL {
 	typedef vector<Vector3d> Vector3dArray;
 	typedef vector<Vector2d> Vector2dArray;
 
-	// Temporary array to store the vertices and face vertices
-	static DLFLVertexPtrArray vertex_array;
-	static DLFLFaceVertexPtrArray face_vertex_array;
-	static Vector3dArray normals;
-	static Vector2dArray texcoords;
-
-
 	static char *dname;
 
 	void DLFLObject::readObject(istream& i, istream &imtl) {
@@ -64,6 +57,12 @@ namespace DLFL {
 		DLFLFacePtr newfptr;
 		DLFLMaterialPtr cur_mtl = matl_list.front();
 		DLFLEdge * edges = NULL;
+		EdgeIndex edgeindex;                      // Edges read so far, keyed on end vertex IDs
+		// Vertices, normals and texture coordinates read so far. These are local
+		// so that several objects can be read at the same time
+		DLFLVertexPtrArray vertex_array;
+		Vector3dArray normals;
+		Vector2dArray texcoords;
 		RGBColor color;
 		bool matl_added = false;
 		char matl_name[10];
@@ -186,15 +185,13 @@ namespace DLFL {
 				// Get the edges from the new face
 				num_edges = newfptr->getEdges(&edges);
 				// Add the edges from the new face
-				addEdges(edges,num_edges);
+				addEdges(edges,num_edges,edgeindex);
 				// Delete the Edge array allocated by getEdges, since addEdges makes a copy
 				delete [] edges; edges = NULL;
 			}
 			if ( c2 != '\n' ) readTillEOL(i);
 		}
 
-		// Clear the temporary vertex array
-		vertex_array.clear();
 		// Make all Vertexes, Edges and Faces unique
 		makeUnique();
 		// update all the EdgePtr fields for the Faces through the Edges
@@ -328,6 +325,8 @@ namespace DLFL {
 		Vector3d xyz;
 		char c,c2;
 		uint vindex, fvindex, fvindex1, fvindex2;
+		DLFLVertexPtrArray vertex_array;          // Vertices and face vertices read so far
+		DLFLFaceVertexPtrArray face_vertex_array;
 
 		// First line of the file should be "DLFL"
 		const char dlfl[] = "DLFL";
@@ -490,9 +489,6 @@ namespace DLFL {
 			}
 		}
 
-		// Clear the temporary vertex array and face vertex array
-		vertex_array.clear();
-		face_vertex_array.clear();
 		assignID();
 
 		// Make all Vertexes, Edges and Faces unique
@@ -564,7 +560,7 @@ namespace DLFL {
 		}
 
 		o << '#' << endl;
-		DLFLMaterialPtr mptr = (*ff)->material();
+		DLFLMaterialPtr mptr = matl_list.front();
 		// o << "usemtl " << mptr->name << "\n";						
 		// Write the face list
 		ff = face_list.begin(); fl = face_list.end();
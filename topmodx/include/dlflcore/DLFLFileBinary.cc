@@ -0,0 +1,395 @@
+/*
+*
+* ***** BEGIN GPL LICENSE BLOCK *****
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software  Foundation,
+* Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*
+* The Original Code is Copyright (C) 2005 by xxxxxxxxxxxxxx
+* All rights reserved.
+*
+* The Original Code is: all of this file.
+*
+* Contributor(s): none yet.
+*
+* ***** END GPL LICENSE BLOCK *****
+*
+* Short description of this file
+*
+* name of .hh file containing function prototypes
+*
+*/
+
+
+// Binary DLFL format (.dlfb)
+//
+// The file is a header followed by flat arrays, so it can be memory mapped and turned
+// into an object in a single pass without any parsing. All values are in the byte order
+// of the machine which wrote the file, and arrays of doubles start at 8 byte offsets.
+//
+//   header       DLFBHeader
+//   materials    num_materials x DLFBMaterial
+//   vertices     num_vertices x 3 doubles (coordinates)
+//   corners      num_corners x uint (vertex index), padded to 8 bytes
+//                num_corners x 3 doubles (normal)
+//                num_corners x 2 doubles (texture coordinates)
+//   faces        num_faces x uint (number of corners)
+//                num_faces x uint (material index)
+//   edges        num_edges x 2 uints (corner indices)
+//
+// Corners are stored face by face, in order, so the corners of a face are consecutive.
+
+#include "DLFLObject.hh"
+
+#ifdef _WIN32
+#include <fstream>
+#else
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace DLFL {
+
+  static const char dlfbMagic[4] = { 'D', 'L', 'F', 'B' };
+  static const uint dlfbVersion = 1;
+  static const uint dlfbByteOrder = 0x01020304;
+  static const int dlfbNameLength = 64;
+
+  struct DLFBHeader {
+    char magic[4];
+    uint version;
+    uint byteorder;
+    uint num_materials;
+    uint num_vertices;
+    uint num_corners;
+    uint num_faces;
+    uint num_edges;
+  };
+
+  struct DLFBMaterial {
+    char name[dlfbNameLength];
+    double color[3];
+    double Ka, Kd, Ks;
+  };
+
+  // Number of padding bytes needed after 'size' bytes to get to an 8 byte boundary
+  static inline size_t dlfbPadding(size_t size) {
+    return (8 - size % 8) % 8;
+  }
+
+  // Total size of a file with the given header
+  static size_t dlfbSize(const DLFBHeader& h) {
+    size_t size = sizeof(DLFBHeader) + h.num_materials * sizeof(DLFBMaterial);
+    size += h.num_vertices * 3 * sizeof(double);
+    size += h.num_corners * sizeof(uint) + dlfbPadding(h.num_corners * sizeof(uint));
+    size += h.num_corners * 5 * sizeof(double);
+    size += h.num_faces * 2 * sizeof(uint);
+    size += h.num_edges * 2 * sizeof(uint);
+    return size;
+  }
+
+  bool DLFLObject::writeDLFB(ostream& o) const {
+    DLFBHeader header;
+    memcpy(header.magic,dlfbMagic,4);
+    header.version = dlfbVersion;
+    header.byteorder = dlfbByteOrder;
+    header.num_materials = matl_list.size();
+    header.num_vertices = vertex_list.size();
+    header.num_corners = 0;
+    header.num_faces = 0;
+    header.num_edges = edge_list.size();
+
+    // Faces without corners are left out, the reader doesn't accept them
+    DLFLFacePtrList::const_iterator ff, fl = face_list.end();
+    DLFLFaceVertexPtr head, current;
+    for ( ff = face_list.begin(); ff != fl; ++ff ) {
+      if ( (*ff)->size() == 0 ) continue;
+      header.num_corners += (*ff)->size();
+      ++header.num_faces;
+    }
+
+    o.write((const char *)&header,sizeof(DLFBHeader));
+
+    // Materials. Faces refer to them by position in this list
+    DLFLMaterialPtrList::const_iterator mf, ml = matl_list.end();
+    for ( mf = matl_list.begin(); mf != ml; ++mf ) {
+      DLFBMaterial mtl;
+      memset(&mtl,0,sizeof(DLFBMaterial));
+      strncpy(mtl.name,(*mf)->name,dlfbNameLength-1);
+      mtl.color[0] = (*mf)->color.r; mtl.color[1] = (*mf)->color.g; mtl.color[2] = (*mf)->color.b;
+      mtl.Ka = (*mf)->Ka; mtl.Kd = (*mf)->Kd; mtl.Ks = (*mf)->Ks;
+      o.write((const char *)&mtl,sizeof(DLFBMaterial));
+    }
+
+    // Vertices. Update the vertex index used for the corners
+    DLFLVertexPtrList::const_iterator vf, vl = vertex_list.end();
+    uint vindex = 0;
+    for ( vf = vertex_list.begin(); vf != vl; ++vf ) {
+      (*vf)->setIndex(vindex++);
+      o.write((const char *)&((*vf)->coords[0]),sizeof(double));
+      o.write((const char *)&((*vf)->coords[1]),sizeof(double));
+      o.write((const char *)&((*vf)->coords[2]),sizeof(double));
+    }
+
+    // Corners, face by face. Each array is written in a separate pass over the faces
+    uint fvindex = 0;
+    for ( ff = face_list.begin(); ff != fl; ++ff ) {
+      head = (*ff)->front();
+      if ( head == NULL ) continue;
+      current = head;
+      do {
+        uint index = current->vertex->getIndex();
+        current->setIndex(fvindex++);
+        o.write((const char *)&index,sizeof(uint));
+        current = current->next();
+      } while ( current != head );
+    }
+    const char zeros[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+    o.write(zeros,dlfbPadding(header.num_corners * sizeof(uint)));
+
+    for ( ff = face_list.begin(); ff != fl; ++ff ) {
+      head = (*ff)->front();
+      if ( head == NULL ) continue;
+      current = head;
+      do {
+        double n[3] = { current->normal[0], current->normal[1], current->normal[2] };
+        o.write((const char *)n,sizeof(n));
+        current = current->next();
+      } while ( current != head );
+    }
+    for ( ff = face_list.begin(); ff != fl; ++ff ) {
+      head = (*ff)->front();
+      if ( head == NULL ) continue;
+      current = head;
+      do {
+        double t[2] = { current->texcoord[0], current->texcoord[1] };
+        o.write((const char *)t,sizeof(t));
+        current = current->next();
+      } while ( current != head );
+    }
+
+    // Faces
+    for ( ff = face_list.begin(); ff != fl; ++ff ) {
+      uint size = (*ff)->size();
+      if ( size > 0 ) o.write((const char *)&size,sizeof(uint));
+    }
+    for ( ff = face_list.begin(); ff != fl; ++ff ) {
+      if ( (*ff)->size() == 0 ) continue;
+      uint mindex = 0;
+      for ( mf = matl_list.begin(); mf != ml && (*mf) != (*ff)->material(); ++mf ) ++mindex;
+      if ( mf == ml ) mindex = 0;
+      o.write((const char *)&mindex,sizeof(uint));
+    }
+
+    // Edges
+    DLFLEdgePtrList::const_iterator ef, el = edge_list.end();
+    for ( ef = edge_list.begin(); ef != el; ++ef ) {
+      DLFLFaceVertexPtr fvp1, fvp2;
+      (*ef)->getFaceVertexPointers(fvp1,fvp2);
+      uint index[2] = { fvp1->getIndex(), fvp2->getIndex() };
+      o.write((const char *)index,sizeof(index));
+    }
+
+    return !o.fail();
+  }
+
+  bool DLFLObject::readDLFBMemory(const char *data, size_t size, bool clearold) {
+    DLFBHeader header;
+    if ( data == NULL || size < sizeof(DLFBHeader) ) {
+      cerr << "Incomplete DLFB file." << endl;
+      return false;
+    }
+    memcpy(&header,data,sizeof(DLFBHeader));
+    if ( memcmp(header.magic,dlfbMagic,4) != 0 ) {
+      cerr << "File not in DLFB format" << endl;
+      return false;
+    }
+    if ( header.byteorder != dlfbByteOrder ) {
+      cerr << "DLFB file was written on a machine with a different byte order" << endl;
+      return false;
+    }
+    if ( header.version != dlfbVersion ) {
+      cerr << "Unsupported DLFB version " << header.version << endl;
+      return false;
+    }
+    if ( size < dlfbSize(header) ) {
+      cerr << "Incomplete DLFB file." << endl;
+      return false;
+    }
+
+    const char *materials = data + sizeof(DLFBHeader);
+    const char *coords = materials + header.num_materials * sizeof(DLFBMaterial);
+    const char *vindices = coords + header.num_vertices * 3 * sizeof(double);
+    const char *normals = vindices + header.num_corners * sizeof(uint) + dlfbPadding(header.num_corners * sizeof(uint));
+    const char *texcoords = normals + header.num_corners * 3 * sizeof(double);
+    const char *fsizes = texcoords + header.num_corners * 2 * sizeof(double);
+    const char *fmaterials = fsizes + header.num_faces * sizeof(uint);
+    const char *edges = fmaterials + header.num_faces * sizeof(uint);
+
+    // Check the indices before changing the object. Face sizes are checked
+    // against the corners left, so a crafted file can't make the sum wrap
+    // around to the expected value
+    uint index;
+    size_t total = 0;
+    for (uint k=0; k < header.num_corners; ++k) {
+      memcpy(&index,vindices + k * sizeof(uint),sizeof(uint));
+      if ( index >= header.num_vertices ) {
+        cerr << "Invalid vertex index in DLFB file." << endl;
+        return false;
+      }
+    }
+    for (uint k=0; k < header.num_faces; ++k) {
+      memcpy(&index,fsizes + k * sizeof(uint),sizeof(uint));
+      if ( index == 0 || index > header.num_corners - total ) {
+        cerr << "Invalid face sizes in DLFB file." << endl;
+        return false;
+      }
+      total += index;
+      memcpy(&index,fmaterials + k * sizeof(uint),sizeof(uint));
+      if ( index >= header.num_materials && index > 0 ) {
+        cerr << "Invalid material index in DLFB file." << endl;
+        return false;
+      }
+    }
+    if ( total != header.num_corners ) {
+      cerr << "Invalid face sizes in DLFB file." << endl;
+      return false;
+    }
+    uint fvindices[2];
+    for (size_t k=0; k < header.num_edges; ++k) {
+      memcpy(fvindices,edges + k * 2 * sizeof(uint),sizeof(fvindices));
+      if ( fvindices[0] >= header.num_corners || fvindices[1] >= header.num_corners ) {
+        cerr << "Invalid corner index in DLFB file." << endl;
+        return false;
+      }
+    }
+
+    // Clear the object first if flag is set
+    // Otherwise new vertices,faces and edges will be appended to the existing lists
+    if ( clearold ) reset();
+
+    // Materials. Existing materials with the same name are reused
+    DLFLMaterialPtrArray mtlarray;
+    mtlarray.reserve(header.num_materials);
+    for (uint k=0; k < header.num_materials; ++k) {
+      DLFBMaterial mtl;
+      memcpy(&mtl,materials + k * sizeof(DLFBMaterial),sizeof(DLFBMaterial));
+      mtl.name[dlfbNameLength-1] = '\0';
+      DLFLMaterialPtr mptr = findMaterial(mtl.name);
+      if ( mptr == NULL ) {
+        mptr = new DLFLMaterial(mtl.name);
+        matl_list.push_back(mptr);
+      }
+      mptr->color.set(mtl.color[0],mtl.color[1],mtl.color[2]);
+      mptr->Ka = mtl.Ka; mptr->Kd = mtl.Kd; mptr->Ks = mtl.Ks;
+      mtlarray.push_back(mptr);
+    }
+    if ( mtlarray.empty() ) mtlarray.push_back(matl_list.front());
+
+    // Vertices
+    DLFLVertexPtrArray varray;
+    varray.reserve(header.num_vertices);
+    double xyz[3];
+    for (uint k=0; k < header.num_vertices; ++k) {
+      memcpy(xyz,coords + k * 3 * sizeof(double),sizeof(xyz));
+      DLFLVertexPtr newvptr = new DLFLVertex(xyz[0],xyz[1],xyz[2]);
+      addVertexPtr(newvptr);
+      varray.push_back(newvptr);
+    }
+
+    // Corners
+    DLFLFaceVertexPtrArray fvarray;
+    fvarray.reserve(header.num_corners);
+    double n[3], t[2];
+    for (uint k=0; k < header.num_corners; ++k) {
+      DLFLFaceVertexPtr newfvptr = new DLFLFaceVertex;
+      memcpy(&index,vindices + k * sizeof(uint),sizeof(uint));
+      memcpy(n,normals + k * 3 * sizeof(double),sizeof(n));
+      memcpy(t,texcoords + k * 2 * sizeof(double),sizeof(t));
+      newfvptr->vertex = varray[index];
+      newfvptr->normal.set(n[0],n[1],n[2]);
+      newfvptr->texcoord.set(t[0],t[1]);
+      fvarray.push_back(newfvptr);
+    }
+
+    // Faces. The corners of each face are consecutive
+    uint fvindex = 0, fsize;
+    for (uint k=0; k < header.num_faces; ++k) {
+      DLFLFacePtr newfptr = new DLFLFace;
+      memcpy(&fsize,fsizes + k * sizeof(uint),sizeof(uint));
+      memcpy(&index,fmaterials + k * sizeof(uint),sizeof(uint));
+      for (uint c=0; c < fsize; ++c)
+        newfptr->addVertexPtr(fvarray[fvindex++]);
+      newfptr->setMaterial(mtlarray[index]);
+      newfptr->updateFacePointers();
+      newfptr->addFaceVerticesToVertices();
+      addFacePtr(newfptr);
+    }
+
+    // Edges
+    for (uint k=0; k < header.num_edges; ++k) {
+      memcpy(fvindices,edges + k * 2 * sizeof(uint),sizeof(fvindices));
+      DLFLEdgePtr neweptr = new DLFLEdge;
+      neweptr->setFaceVertexPointers(fvarray[fvindices[0]],fvarray[fvindices[1]],false);
+      neweptr->updateFaceVertices();
+      addEdgePtr(neweptr);
+    }
+
+    assignID();
+    return true;
+  }
+
+  bool DLFLObject::readDLFB(const char *filename, bool clearold) {
+#ifdef _WIN32
+    // No mmap, read the whole file into memory instead
+    ifstream file(filename, ios::in | ios::binary);
+    if ( !file ) {
+      cerr << "Couldn't open " << filename << endl;
+      return false;
+    }
+    file.seekg(0,ios::end);
+    size_t size = file.tellg();
+    file.seekg(0,ios::beg);
+    vector<char> buffer(size);
+    if ( size > 0 ) file.read(&buffer[0],size);
+    return readDLFBMemory(size > 0 ? &buffer[0] : NULL,size,clearold);
+#else
+    int fd = open(filename,O_RDONLY);
+    if ( fd < 0 ) {
+      cerr << "Couldn't open " << filename << endl;
+      return false;
+    }
+    struct stat st;
+    if ( fstat(fd,&st) != 0 || st.st_size == 0 ) {
+      close(fd);
+      cerr << "Incomplete DLFB file." << endl;
+      return false;
+    }
+    size_t size = st.st_size;
+    void *data = mmap(NULL,size,PROT_READ,MAP_PRIVATE,fd,0);
+    close(fd);
+    if ( data == MAP_FAILED ) {
+      cerr << "Couldn't map " << filename << endl;
+      return false;
+    }
+    bool read = readDLFBMemory((const char *)data,size,clearold);
+    munmap(data,size);
+    return read;
+#endif
+  }
+
+} // end namespace
@@ -0,0 +1,157 @@
+/*
+*
+* ***** BEGIN GPL LICENSE BLOCK *****
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software  Foundation,
+* Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*
+* The Original Code is Copyright (C) 2005 by xxxxxxxxxxxxxx
+* All rights reserved.
+*
+* The Original Code is: all of this file.
+*
+* Contributor(s): none yet.
+*
+* ***** END GPL LICENSE BLOCK *****
+*/
+
+/**
+ * \file DLFLIndex.hh
+ */
+
+#ifndef _DLFL_INDEX_HH_
+#define _DLFL_INDEX_HH_
+
+// Lookup table from element IDs to elements, used by DLFLObject to find
+// vertices, edges, faces and corners by ID. IDs come from counters and are
+// mostly consecutive, so the table is indexed by the ID itself : it is split
+// into pages of PageSize slots, pages are allocated when the first element
+// with an ID in their range is inserted and freed when they become empty.
+// A lookup is two array accesses and returns the element only if it still has
+// the ID it was inserted with, so an element whose ID was changed behind the
+// back of the table (makeUnique on the element, undo) is never returned for
+// the wrong ID.
+// The table never holds a freed element as long as elements are erased before
+// they are freed. If erase doesn't find an element under its current ID, it
+// may still be under an old one, so the table is marked stale and finds
+// nothing until the next rebuild. Corners never change their ID, so they are
+// removed with eraseFixed, which doesn't need to do that.
+// Elements are stored as full pointers, so the table works on 64 bit systems.
+
+#include "DLFLCommon.hh"
+
+namespace DLFL {
+
+  template <class T>
+  class DLFLIndex {
+  public :
+
+    DLFLIndex( ) : mStamp(NoStamp), mStale(false) { }
+    DLFLIndex( const DLFLIndex& index ) : mStamp(NoStamp), mStale(false) { *this = index; }
+    ~DLFLIndex( ) { clear(); }
+
+    DLFLIndex& operator=( const DLFLIndex& index ) {
+      if ( this == &index ) return *this;
+      clear();
+      mPages.resize(index.mPages.size(),NULL);
+      for ( size_t i = 0; i < mPages.size(); ++i )
+        if ( index.mPages[i] ) mPages[i] = new Page(*index.mPages[i]);
+      mStamp = index.mStamp;
+      mStale = index.mStale;
+      return *this;
+    }
+
+    // Element with the given ID, NULL if there is none
+    T find( uint id ) const {
+      size_t p = id / PageSize;
+      if ( mStale || p >= mPages.size() || mPages[p] == NULL ) return NULL;
+      T item = mPages[p]->slots[id % PageSize];
+      return ( item && item->getID() == id ) ? item : NULL;
+    }
+
+    // Add the element under its current ID
+    void insert( T item ) {
+      uint id = item->getID();
+      size_t p = id / PageSize;
+      if ( p >= mPages.size() ) mPages.resize(p+1,NULL);
+      if ( mPages[p] == NULL ) mPages[p] = new Page;
+      T& slot = mPages[p]->slots[id % PageSize];
+      if ( slot == NULL ) ++mPages[p]->count;
+      slot = item;
+    }
+
+    // Remove the element if it is stored under its current ID
+    void erase( T item ) {
+      if ( !eraseFixed(item) && !mPages.empty() ) {
+        // Possibly still stored under an old ID
+        mStale = true; mStamp = NoStamp;
+      }
+    }
+
+    // Same as erase for elements whose ID never changes. Such an element which
+    // isn't stored under its ID isn't stored at all. Returns false in that case
+    bool eraseFixed( T item ) {
+      uint id = item->getID();
+      size_t p = id / PageSize;
+      T *slot = ( p < mPages.size() && mPages[p] ) ? &mPages[p]->slots[id % PageSize] : NULL;
+      if ( slot == NULL || *slot != item ) return false;
+      *slot = NULL;
+      if ( --mPages[p]->count == 0 ) {
+        delete mPages[p]; mPages[p] = NULL;
+      }
+      return true;
+    }
+
+    void clear( ) {
+      for ( size_t i = 0; i < mPages.size(); ++i ) delete mPages[i];
+      mPages.clear();
+      mStamp = NoStamp; mStale = false;
+    }
+
+    // Rebuild the table from the given elements. stamp is a value which tells
+    // the caller later whether the table may be out of date (see stamp())
+    template <class Iterator>
+    void rebuild( Iterator first, Iterator last, uint stamp ) {
+      clear();
+      for ( ; first != last; ++first ) insert(*first);
+      mStamp = stamp;
+    }
+
+    // Stamp given to the last rebuild, NoStamp if there was none since the
+    // table was cleared or invalidated
+    uint stamp( ) const { return mStamp; }
+    void invalidate( ) { mStamp = NoStamp; }
+
+    enum { NoStamp = ~0u };
+
+  private :
+
+    enum { PageSize = 1024 };
+
+    struct Page {
+      Page( ) : count(0) {
+        for ( int i = 0; i < PageSize; ++i ) slots[i] = NULL;
+      }
+      T slots[PageSize];
+      uint count;                          // Number of non NULL slots
+    };
+
+    std::vector<Page *> mPages;
+    uint mStamp;
+    bool mStale;                           // May hold freed elements, see erase
+  };
+
+} // end namespace
+
+#endif /* #ifndef _DLFL_INDEX_HH_ */
@@ -0,0 +1,325 @@
+/*
+*
+* ***** BEGIN GPL LICENSE BLOCK *****
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software  Foundation,
+* Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*
+* The Original Code is Copyright (C) 2005 by xxxxxxxxxxxxxx
+* All rights reserved.
+*
+* The Original Code is: all of this file.
+*
+* Contributor(s): none yet.
+*
+* ***** END GPL LICENSE BLOCK *****
+*
+* Short description of this file
+*
+* name of .hh file containing function prototypes
+*
+*/
+
+
+#include "DLFLJournal.hh"
+
+namespace DLFL {
+
+  DLFLJournal::DLFLJournal(DLFLObjectPtr obj)
+    : object(obj), recording(true), applied(true) {
+    // Only one journal can record changes to an object at a time
+    if ( object->journal() ) object->journal()->commit();
+    object->setJournal(this);
+  }
+
+  DLFLJournal::~DLFLJournal() {
+    if ( recording ) commit();
+
+    if ( applied ) {
+      // Deleted elements are not part of the object anymore
+      for (int i=0; i < (int)vreleased.size(); ++i) delete vreleased[i];
+      for (int i=0; i < (int)ereleased.size(); ++i) delete ereleased[i];
+      for (int i=0; i < (int)freleased.size(); ++i) freeFace(freleased[i]);
+      for (int i=0; i < (int)creleased.size(); ++i) delete creleased[i];
+    } else {
+      // Created elements are not part of the object anymore
+      for (int i=0; i < (int)vcreated.size(); ++i) delete vcreated[i];
+      for (int i=0; i < (int)ecreated.size(); ++i) delete ecreated[i];
+      for (int i=0; i < (int)fcreated.size(); ++i) freeFace(fcreated[i]);
+      for (int i=0; i < (int)ccreated.size(); ++i) delete ccreated[i];
+    }
+  }
+
+  DLFLJournal::FaceImage DLFLJournal::image(DLFLFacePtr fp) {
+    FaceImage fi;
+    fi.fp = fp; fi.head = fp->head; fi.size = fp->num_corners; fi.matl = fp->matl_ptr; fi.type = fp->ftType;
+    fi.auxcoords = fp->auxcoords; fi.centroid = fp->centroid; fi.normal = fp->normal;
+    fi.flags = fp->flags;
+    return fi;
+  }
+
+  void DLFLJournal::restore(const FaceImage& fi) {
+    DLFLFacePtr fp = fi.fp;
+    fp->head = fi.head; fp->num_corners = fi.size; fp->ftType = fi.type;
+    fp->auxcoords = fi.auxcoords; fp->centroid = fi.centroid; fp->normal = fi.normal;
+    fp->flags = fi.flags;
+    fp->setMaterial(fi.matl);
+  }
+
+  void DLFLJournal::freeFace(DLFLFacePtr fp) {
+    // The face destructor frees the corners, which are owned by the journal or other faces
+    fp->setMaterial(NULL);
+    fp->head = NULL; fp->num_corners = 0;
+    delete fp;
+  }
+
+  void DLFLJournal::record(DLFLVertexPtr vp) {
+    if ( vp == NULL || createdSet.count(vp) || !recordedSet.insert(vp).second ) return;
+    vbefore.push_back(VertexImage(vp,*vp));
+  }
+
+  void DLFLJournal::record(DLFLEdgePtr ep) {
+    if ( ep == NULL || createdSet.count(ep) || !recordedSet.insert(ep).second ) return;
+    ebefore.push_back(EdgeImage(ep,*ep));
+  }
+
+  void DLFLJournal::record(DLFLFacePtr fp) {
+    if ( fp == NULL || createdSet.count(fp) || !recordedSet.insert(fp).second ) return;
+    fbefore.push_back(image(fp));
+  }
+
+  void DLFLJournal::record(DLFLFaceVertexPtr fvp) {
+    if ( fvp == NULL || !recordedSet.insert(fvp).second ) return;
+    cbefore.push_back(CornerImage(fvp));
+  }
+
+  void DLFLJournal::recordFace(DLFLFacePtr fp) {
+    if ( !recording || fp == NULL || createdSet.count(fp) || !expandedSet.insert(fp).second ) return;
+    record(fp);
+    DLFLFaceVertexPtr head = fp->front();
+    if ( head ) {
+      DLFLFaceVertexPtr current = head;
+      do {
+        record(current);
+        record(current->getVertexPtr());
+        record(current->getEdgePtr());
+        current = current->next();
+      } while ( current != head );
+    }
+  }
+
+  void DLFLJournal::recordEdge(DLFLEdgePtr ep) {
+    if ( !recording || ep == NULL ) return;
+    DLFLFaceVertexPtr fvp1 = NULL, fvp2 = NULL;
+    ep->getFaceVertexPointers(fvp1,fvp2);
+    record(ep);
+    if ( fvp1 ) recordFace(fvp1->getFacePtr());
+    if ( fvp2 ) recordFace(fvp2->getFacePtr());
+  }
+
+  void DLFLJournal::recordVertex(DLFLVertexPtr vp) {
+    if ( !recording || vp == NULL || createdSet.count(vp) || !expandedSet.insert(vp).second ) return;
+    record(vp);
+    DLFLFaceVertexPtrArray fvparray;
+    vp->getFaceVertices(fvparray);
+    for (int i=0; i < (int)fvparray.size(); ++i)
+      record(fvparray[i]);
+  }
+
+  void DLFLJournal::created(DLFLVertexPtr vp) {
+    if ( createdSet.insert(vp).second ) vcreated.push_back(vp);
+  }
+
+  void DLFLJournal::created(DLFLEdgePtr ep) {
+    if ( createdSet.insert(ep).second ) ecreated.push_back(ep);
+  }
+
+  void DLFLJournal::created(DLFLFacePtr fp) {
+    if ( createdSet.insert(fp).second ) fcreated.push_back(fp);
+  }
+
+  void DLFLJournal::released(DLFLVertexPtr vp) {
+    if ( !releasedSet.insert(vp).second ) return;
+    if ( createdSet.erase(vp) ) {
+      // Created and deleted by the same operation
+      erase(vcreated,vp);
+      releasedSet.erase(vp);
+      delete vp;
+      return;
+    }
+    record(vp);
+    vreleased.push_back(vp);
+  }
+
+  void DLFLJournal::released(DLFLEdgePtr ep) {
+    if ( !releasedSet.insert(ep).second ) return;
+    if ( createdSet.erase(ep) ) {
+      erase(ecreated,ep);
+      releasedSet.erase(ep);
+      delete ep;
+      return;
+    }
+    record(ep);
+    ereleased.push_back(ep);
+  }
+
+  void DLFLJournal::released(DLFLFacePtr fp) {
+    if ( !releasedSet.insert(fp).second ) return;
+    bool wascreated = createdSet.erase(fp);
+    if ( !wascreated ) record(fp);
+
+    // Remaining corners of the face go with it
+    DLFLFaceVertexPtr head = fp->front();
+    if ( head ) {
+      DLFLFaceVertexPtr current = head, temp;
+      do {
+        temp = current->next();
+        released(current);
+        current = temp;
+      } while ( current != head );
+    }
+
+    if ( wascreated ) {
+      erase(fcreated,fp);
+      releasedSet.erase(fp);
+      freeFace(fp);
+      return;
+    }
+    fp->setMaterial(NULL);
+    fp->head = NULL; fp->num_corners = 0;
+    freleased.push_back(fp);
+  }
+
+  void DLFLJournal::released(DLFLFaceVertexPtr fvp) {
+    if ( !releasedSet.insert(fvp).second ) return;
+    if ( recordedSet.count(fvp) == 0 ) {
+      // Corners are recorded before they are changed, so this one was created by the operation
+      releasedSet.erase(fvp);
+      delete fvp;
+      return;
+    }
+    creleased.push_back(fvp);
+  }
+
+  void DLFLJournal::storeAfterImages( ) {
+    vafter.clear(); eafter.clear(); fafter.clear(); cafter.clear();
+
+    for (int i=0; i < (int)vbefore.size(); ++i)
+      if ( releasedSet.count(vbefore[i].first) == 0 )
+        vafter.push_back(VertexImage(vbefore[i].first,*(vbefore[i].first)));
+    for (int i=0; i < (int)vcreated.size(); ++i)
+      vafter.push_back(VertexImage(vcreated[i],*(vcreated[i])));
+
+    for (int i=0; i < (int)ebefore.size(); ++i)
+      if ( releasedSet.count(ebefore[i].first) == 0 )
+        eafter.push_back(EdgeImage(ebefore[i].first,*(ebefore[i].first)));
+    for (int i=0; i < (int)ecreated.size(); ++i)
+      eafter.push_back(EdgeImage(ecreated[i],*(ecreated[i])));
+
+    for (int i=0; i < (int)fbefore.size(); ++i)
+      if ( releasedSet.count(fbefore[i].fp) == 0 )
+        fafter.push_back(image(fbefore[i].fp));
+    for (int i=0; i < (int)fcreated.size(); ++i)
+      fafter.push_back(image(fcreated[i]));
+
+    for (int i=0; i < (int)cbefore.size(); ++i)
+      if ( releasedSet.count(cbefore[i].fvp) == 0 )
+        cafter.push_back(CornerImage(cbefore[i].fvp));
+
+    // New corners can only be in the faces touched by the operation
+    for (int i=0; i < (int)fafter.size(); ++i) {
+      DLFLFaceVertexPtr head = fafter[i].head;
+      if ( head == NULL ) continue;
+      DLFLFaceVertexPtr current = head;
+      do {
+        if ( recordedSet.count(current) == 0 && createdSet.insert(current).second )
+          ccreated.push_back(current);
+        current = current->next();
+      } while ( current != head );
+    }
+    for (int i=0; i < (int)ccreated.size(); ++i)
+      cafter.push_back(CornerImage(ccreated[i]));
+  }
+
+  void DLFLJournal::commit( ) {
+    if ( !recording ) return;
+    recording = false;
+    if ( object->journal() == this ) object->setJournal(NULL);
+    storeAfterImages();
+    // Only needed while recording
+    expandedSet.clear();
+  }
+
+  void DLFLJournal::unlink(const DLFLVertexPtrArray& vparray, const DLFLEdgePtrArray& eparray,
+                           const DLFLFacePtrArray& fparray) {
+    for (int i=0; i < (int)vparray.size(); ++i) object->removeVertex(vparray[i]);
+    for (int i=0; i < (int)eparray.size(); ++i) object->removeEdge(eparray[i]);
+    for (int i=0; i < (int)fparray.size(); ++i) {
+      object->removeFace(fparray[i]);
+      fparray[i]->setMaterial(NULL);
+    }
+  }
+
+  void DLFLJournal::relink(const DLFLVertexPtrArray& vparray, const DLFLEdgePtrArray& eparray,
+                           const DLFLFacePtrArray& fparray) {
+    for (int i=0; i < (int)vparray.size(); ++i) object->addVertexPtr(vparray[i]);
+    for (int i=0; i < (int)eparray.size(); ++i) object->addEdgePtr(eparray[i]);
+    for (int i=0; i < (int)fparray.size(); ++i) object->addFacePtr(fparray[i]);
+  }
+
+  void DLFLJournal::invalidateIndex( ) {
+    // Restoring the elements may have given them back their old IDs, so the
+    // tables could hold elements under IDs they no longer have
+    object->vertex_index.clear();
+    object->edge_index.clear();
+    object->face_index.clear();
+    object->corner_index.clear();
+    // and their old connectivity
+    object->topologyChanged();
+  }
+
+  void DLFLJournal::revert( ) {
+    if ( recording ) commit();
+    if ( !applied ) return;
+
+    unlink(vcreated,ecreated,fcreated);
+
+    for (int i=0; i < (int)vbefore.size(); ++i) *(vbefore[i].first) = vbefore[i].second;
+    for (int i=0; i < (int)ebefore.size(); ++i) *(ebefore[i].first) = ebefore[i].second;
+    for (int i=0; i < (int)cbefore.size(); ++i) cbefore[i].restore();
+    for (int i=0; i < (int)fbefore.size(); ++i) restore(fbefore[i]);
+
+    relink(vreleased,ereleased,freleased);
+    invalidateIndex();
+    applied = false;
+  }
+
+  void DLFLJournal::reapply( ) {
+    if ( recording ) commit();
+    if ( applied ) return;
+
+    unlink(vreleased,ereleased,freleased);
+    for (int i=0; i < (int)freleased.size(); ++i) { freleased[i]->head = NULL; freleased[i]->num_corners = 0; }
+
+    for (int i=0; i < (int)vafter.size(); ++i) *(vafter[i].first) = vafter[i].second;
+    for (int i=0; i < (int)eafter.size(); ++i) *(eafter[i].first) = eafter[i].second;
+    for (int i=0; i < (int)cafter.size(); ++i) cafter[i].restore();
+    for (int i=0; i < (int)fafter.size(); ++i) restore(fafter[i]);
+
+    relink(vcreated,ecreated,fcreated);
+    invalidateIndex();
+    applied = true;
+  }
+
+} // end namespace
@@ -0,0 +1,211 @@
+/*
+*
+* ***** BEGIN GPL LICENSE BLOCK *****
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software  Foundation,
+* Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*
+* The Original Code is Copyright (C) 2005 by xxxxxxxxxxxxxx
+* All rights reserved.
+*
+* The Original Code is: all of this file.
+*
+* Contributor(s): none yet.
+*
+* ***** END GPL LICENSE BLOCK *****
+*/
+
+
+/**
+ * \file DLFLJournal.hh
+ */
+
+#ifndef _DLFL_JOURNAL_HH_
+#define _DLFL_JOURNAL_HH_
+
+// Journal of the changes made to a DLFLObject by a single operation.
+// Operations which support journaling record every element they are about to
+// modify through the journal attached to the object (DLFLObject::journal()).
+// The journal keeps a copy of the state of each element before and after the
+// operation, so the operation can be undone and redone in place without
+// rewriting the whole object. Elements deleted by the operation are not freed
+// while the journal is alive (see DLFLObject::release), so pointers stay valid.
+
+#include "DLFLObject.hh"
+#include <ext/hash_set>
+
+namespace DLFL {
+
+  class DLFLJournal {
+  public :
+
+    // Start a new journal for the given object and attach it to the object
+    DLFLJournal(DLFLObjectPtr obj);
+
+    // Frees the elements which are no longer part of the object - deleted
+    // elements if the journal is applied, created elements if it is reverted
+    ~DLFLJournal();
+
+  protected :
+
+    struct PtrHash {
+      size_t operator() ( const void * p ) const {
+        return ((size_t)p) >> 3;
+      }
+    };
+
+    typedef __gnu_cxx::hash_set<const void *, PtrHash> PtrSet;
+
+    // Face state which is not owned by the corners
+    struct FaceImage {
+      DLFLFacePtr fp;
+      DLFLFaceVertexPtr head;
+      uint size;
+      DLFLMaterialPtr matl;
+      DLFLFaceType type;
+      Vector3d auxcoords;
+      Vector3d centroid;
+      Vector3d normal;
+      unsigned long flags;
+    };
+
+    // DLFLFaceVertex copy constructor resets the list pointers, so copy through the
+    // assignment operator which doesn't
+    struct CornerImage {
+      DLFLFaceVertexPtr fvp;
+      DLFLFaceVertex state;
+
+      CornerImage(DLFLFaceVertexPtr p) : fvp(p), state() { state = *p; }
+      CornerImage(const CornerImage& ci) : fvp(ci.fvp), state() { state = ci.state; }
+      CornerImage& operator = (const CornerImage& ci) {
+        fvp = ci.fvp; state = ci.state;
+        return (*this);
+      }
+      void restore( ) const { *fvp = state; }
+    };
+
+    typedef pair<DLFLVertexPtr,DLFLVertex> VertexImage;
+    typedef pair<DLFLEdgePtr,DLFLEdge> EdgeImage;
+
+    typedef vector<VertexImage> VertexImageArray;
+    typedef vector<EdgeImage> EdgeImageArray;
+    typedef vector<FaceImage> FaceImageArray;
+    typedef vector<CornerImage> CornerImageArray;
+
+    DLFLObjectPtr          object;                // Object this journal applies to
+    bool                   recording;             // Still attached to the object
+    bool                   applied;               // Object is in the state after the operation
+
+    PtrSet                 recordedSet;           // Elements which have a before image
+    PtrSet                 expandedSet;           // Faces and vertices whose neighbours are recorded
+    PtrSet                 createdSet;            // Elements created by the operation
+    PtrSet                 releasedSet;           // Elements deleted by the operation
+
+    VertexImageArray       vbefore, vafter;
+    EdgeImageArray         ebefore, eafter;
+    FaceImageArray         fbefore, fafter;
+    CornerImageArray       cbefore, cafter;
+
+    DLFLVertexPtrArray     vcreated, vreleased;
+    DLFLEdgePtrArray       ecreated, ereleased;
+    DLFLFacePtrArray       fcreated, freleased;
+    DLFLFaceVertexPtrArray ccreated, creleased;
+
+    // Record the state of a single element, if not already recorded
+    void record(DLFLVertexPtr vp);
+    void record(DLFLEdgePtr ep);
+    void record(DLFLFacePtr fp);
+    void record(DLFLFaceVertexPtr fvp);
+
+    // Remove the given pointer from an array of pointers
+    template <class T>
+    static void erase(vector<T>& array, T ptr) {
+      typename vector<T>::iterator pos = std::find(array.begin(),array.end(),ptr);
+      if ( pos != array.end() ) array.erase(pos);
+    }
+
+    static FaceImage image(DLFLFacePtr fp);
+    static void restore(const FaceImage& fi);
+
+    // Free a face without touching its corners
+    static void freeFace(DLFLFacePtr fp);
+
+    // Remove elements from the object lists, in a single pass over each list
+    void unlink(const DLFLVertexPtrArray& vparray, const DLFLEdgePtrArray& eparray,
+                const DLFLFacePtrArray& fparray);
+
+    // Add elements back to the object lists
+    void relink(const DLFLVertexPtrArray& vparray, const DLFLEdgePtrArray& eparray,
+                const DLFLFacePtrArray& fparray);
+
+    // Drop the ID tables of the object, they are rebuilt on the next lookup
+    void invalidateIndex( );
+
+    // Capture the state of the object after the operation
+    void storeAfterImages( );
+
+  public :
+
+    //--- Recording - used by operations ---//
+
+    // Record a face, all of its corners and the vertices and edges used by the corners.
+    // Call before doing anything which changes the corners of the face
+    void recordFace(DLFLFacePtr fp);
+
+    // Record the faces on both sides of an edge
+    void recordEdge(DLFLEdgePtr ep);
+
+    // Record a vertex and all corners which refer to it
+    void recordVertex(DLFLVertexPtr vp);
+
+    // Corners have no creation notification. A corner seen for the first time by
+    // recordFace/recordVertex is taken to exist before the operation, so operations made
+    // of several journaled steps should record the whole neighbourhood up front
+
+    // Notification from the object when an element is added to its lists
+    void created(DLFLVertexPtr vp);
+    void created(DLFLEdgePtr ep);
+    void created(DLFLFacePtr fp);
+
+    // Notification from the object when an element has been removed and would be freed.
+    // The journal takes ownership of the element
+    void released(DLFLVertexPtr vp);
+    void released(DLFLEdgePtr ep);
+    void released(DLFLFacePtr fp);
+    void released(DLFLFaceVertexPtr fvp);
+
+    //--- Undo/redo ---//
+
+    bool isRecording( ) const { return recording; };
+    bool isApplied( ) const { return applied; };
+
+    // Number of elements stored in this journal
+    size_t size( ) const {
+      return vbefore.size() + ebefore.size() + fbefore.size() + cbefore.size()
+        + vcreated.size() + ecreated.size() + fcreated.size() + ccreated.size();
+    };
+
+    // Stop recording and store the state of the elements after the operation
+    void commit( );
+
+    // Restore the object to the state before the operation (undo)
+    void revert( );
+
+    // Restore the object to the state after the operation (redo)
+    void reapply( );
+  };
+
+} // end namespace
+
+#endif /* _DLFL_JOURNAL_HH_ */
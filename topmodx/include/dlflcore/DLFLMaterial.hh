@@ -69,20 +69,22 @@ public :
     }
   }
 
+  // A face is in the face list of its own material only, so copies start
+  // with no faces and assignment keeps the faces
   DLFLMaterial(const DLFLMaterial& mat)
-    : name(NULL), color(mat.color), faces(mat.faces), Ka(mat.Ka), Kd(mat.Kd), Ks(mat.Ks) {
+    : name(NULL), color(mat.color), faces(), Ka(mat.Ka), Kd(mat.Kd), Ks(mat.Ks) {
     name = new char[strlen(mat.name)+1]; strcpy(name,mat.name);
   }
 
   ~DLFLMaterial() {
-    faces.clear();
+    clearFaces();
     delete [] name;
   }
 
   DLFLMaterial& operator = (const DLFLMaterial& mat) {
     delete [] name; name = NULL;
     name = new char[strlen(mat.name)+1]; strcpy(name,mat.name);
-    color = mat.color; faces = mat.faces; Ka = mat.Ka; Kd = mat.Kd; Ks = mat.Ks;
+    color = mat.color; Ka = mat.Ka; Kd = mat.Kd; Ks = mat.Ks;
     return (*this);
   }
 
@@ -109,14 +111,13 @@ public :
     }
   }
 
-  void addFace(DLFLFacePtr faceptr) {
-    faces.push_back(faceptr);
-  }
+  void addFace(DLFLFacePtr faceptr);
 
-  void deleteFace(DLFLFacePtr faceptr) {
-    if( faces.size() > 0 )
-      faces.remove(faceptr);
-  }
+  // Constant time, through the position stored in the face
+  void deleteFace(DLFLFacePtr faceptr);
+
+  // Forget all the faces, without changing their material pointers
+  void clearFaces(void);
 
   uint numFaces(void) const
   {
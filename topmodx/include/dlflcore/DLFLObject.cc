@@ -36,6 +36,7 @@
  */
 
 #include "DLFLObject.hh"
+#include "DLFLJournal.hh"
 
 namespace DLFL {
 
@@ -80,10 +81,109 @@ namespace DLFL {
     // Combine 2 objects. The lists are simply spliced together.
     // Entities must be removed from the second object to prevent dangling pointers
     // when it is destroyed.
+    for ( DLFLVertexPtrList::iterator i = object.vertex_list.begin(); i != object.vertex_list.end(); ++i ) {
+      vertex_index.insert(*i); markChanged(*i);
+    }
+    for ( DLFLEdgePtrList::iterator i = object.edge_list.begin(); i != object.edge_list.end(); ++i )
+      edge_index.insert(*i);
+    for ( DLFLFacePtrList::iterator i = object.face_list.begin(); i != object.face_list.end(); ++i ) {
+      face_index.insert(*i); markChanged(*i);
+    }
+    corner_index.invalidate();
+    object.vertex_index.clear(); object.edge_index.clear();
+    object.face_index.clear(); object.corner_index.clear();
     vertex_list.splice(vertex_list.end(),object.vertex_list);
     edge_list.splice(edge_list.end(),object.edge_list);
     face_list.splice(face_list.end(),object.face_list);
     matl_list.splice(matl_list.end(),object.matl_list);
+    topologyChanged(); object.topologyChanged();
+  }
+
+  void DLFLObject::append(const DLFLObject& object, bool reverse_faces) {
+    // Counts are taken first since appending to itself makes the lists grow.
+    // The index fields of the original vertices and corners are used to find
+    // their copies, as writeDLFL does
+    uint numverts = object.vertex_list.size(), numfaces = object.face_list.size();
+    uint numedges = object.edge_list.size();
+    DLFLVertexPtrArray newverts; newverts.reserve(numverts);
+    DLFLFaceVertexPtrArray newcorners;
+    DLFLVertexPtr vp;
+    DLFLFaceVertexPtr head, current, fvp;
+    uint i;
+
+    DLFLVertexPtrList::const_iterator vf = object.vertex_list.begin();
+    for ( i = 0; i < numverts; ++i, ++vf ) {
+      (*vf)->setIndex(i);
+      vp = new DLFLVertex((*vf)->coords);
+      addVertexPtr(vp);
+      newverts.push_back(vp);
+    }
+
+    // Corners are copied face by face in forward order. A copy has no face yet
+    DLFLFacePtrList::const_iterator ff = object.face_list.begin();
+    for ( i = 0; i < numfaces; ++i, ++ff ) {
+      head = (*ff)->front();
+      if ( !head ) continue;
+      current = head;
+      do {
+        current->setIndex(newcorners.size());
+        fvp = new DLFLFaceVertex;
+        fvp->vertex = newverts[current->vertex->getIndex()];
+        fvp->normal = current->normal;
+        fvp->texcoord = current->texcoord;
+        newcorners.push_back(fvp);
+        current = current->next();
+      } while ( current != head );
+    }
+
+    // The reverse of an edge joins the corners following its corners
+    DLFLEdgePtrList::const_iterator ef = object.edge_list.begin();
+    DLFLFaceVertexPtr fvp1, fvp2;
+    DLFLEdgePtr ep;
+    for ( i = 0; i < numedges; ++i, ++ef ) {
+      (*ef)->getCorners(fvp1,fvp2);
+      if ( reverse_faces ) {
+        fvp1 = fvp1->next(); fvp2 = fvp2->next();
+      }
+      ep = new DLFLEdge;
+      ep->setFaceVertexPointers(newcorners[fvp1->getIndex()],newcorners[fvp2->getIndex()],false);
+      ep->updateFaceVertices();
+      addEdgePtr(ep);
+    }
+
+    DLFLMaterialPtr matl = NULL, newmatl = NULL;
+    DLFLFacePtr fp;
+    ff = object.face_list.begin();
+    for ( i = 0; i < numfaces; ++i, ++ff ) {
+      head = (*ff)->front();
+      if ( !head ) continue;
+      fp = new DLFLFace;
+      current = head;
+      do {
+        fp->addVertexPtr(newcorners[current->getIndex()]);
+        current = ( reverse_faces ) ? current->prev() : current->next();
+      } while ( current != head );
+
+      if ( (*ff)->material() != matl ) {
+        matl = (*ff)->material();
+        newmatl = ( &object == this ) ? matl : findMaterial(matl->name);
+        if ( !newmatl ) {
+          newmatl = new DLFLMaterial(matl->name,matl->color);
+          matl_list.push_back(newmatl);
+        }
+      }
+      fp->setMaterial(newmatl);
+      fp->updateFacePointers();
+      fp->addFaceVerticesToVertices();
+      addFacePtr(fp);
+    }
+  }
+
+  DLFLObjectPtr DLFLObject::clone(bool reverse_faces) const {
+    DLFLObjectPtr copy = new DLFLObject;
+    copy->position = position; copy->scale_factor = scale_factor; copy->rotation = rotation;
+    copy->append(*this,reverse_faces);
+    return copy;
   }
 
   // Reverse the orientation of all faces in the object
@@ -103,6 +203,16 @@ namespace DLFL {
       (*ffirst)->reverse();
       ++ffirst;
     }
+    topologyChanged();
+  }
+
+  const DLFLSnapshot& DLFLObject::snapshot( ) {
+    if ( !geometry_snapshot.built || geometry_snapshot.stamp != topology_stamp ) {
+      geometry_snapshot.build(this);
+      geometry_snapshot.stamp = topology_stamp;
+    } else
+      geometry_snapshot.updatePositions();
+    return geometry_snapshot;
   }
 
   bool DLFLObject::edgeExists(DLFLVertexPtr vptr1, DLFLVertexPtr vptr2) {
@@ -136,6 +246,7 @@ namespace DLFL {
 
       ++first;
     }
+    attributesChanged();
   }
 
   void DLFLObject::assignTileTexCoords(int n) {
@@ -166,6 +277,7 @@ namespace DLFL {
       }
       ++first;
     }
+    attributesChanged();
   }
 
   void DLFLObject::randomAssignTexCoords( ) {
@@ -176,6 +288,7 @@ namespace DLFL {
       (*first)->randomAssignTexCoords();
       ++first;
     }
+    attributesChanged();
   }
 
   DLFLFacePtrArray DLFLObject::createFace(const Vector3dArray& verts, DLFLMaterialPtr matl, bool set_type) {
@@ -275,15 +388,59 @@ namespace DLFL {
 			if( vp->numEdges() > 0 )
 				return;
 
+			if( journal_ptr ) journal_ptr->recordFace( fp );
+
 			removeVertex( vp );
-			delete vp;
+			release( vp );
+			// fvp is the only corner of fp and goes with it
 			removeFace( fp );
-			delete fp;
-
-			delete fvp;
+			release( fp );
 		}
 	}
 
+  void DLFLObject::release( DLFLVertexPtr vp ) {
+    if ( journal_ptr ) journal_ptr->released(vp);
+    else delete vp;
+  }
+
+  void DLFLObject::release( DLFLEdgePtr ep ) {
+    if ( journal_ptr ) journal_ptr->released(ep);
+    else delete ep;
+  }
+
+  void DLFLObject::release( DLFLFacePtr fp ) {
+    // The corners still in the face leave the object with it
+    DLFLFaceVertexPtr head = fp->front(), current = head;
+    if ( head ) do {
+      if ( current->getFacePtr() == fp ) corner_index.eraseFixed(current);
+      current = current->next();
+    } while ( current != head );
+    if ( journal_ptr ) journal_ptr->released(fp);
+    else delete fp;
+  }
+
+  void DLFLObject::release( DLFLFaceVertexPtr fvp ) {
+    corner_index.eraseFixed(fvp);
+    if ( journal_ptr ) journal_ptr->released(fvp);
+    else delete fvp;
+  }
+
+  void DLFLObject::detachJournal( ) {
+    if ( journal_ptr ) journal_ptr->commit();
+  }
+
+  void DLFLObject::journalCreated( DLFLVertexPtr vp ) {
+    journal_ptr->created(vp);
+  }
+
+  void DLFLObject::journalCreated( DLFLEdgePtr ep ) {
+    journal_ptr->created(ep);
+  }
+
+  void DLFLObject::journalCreated( DLFLFacePtr fp ) {
+    journal_ptr->created(fp);
+  }
+
   void DLFLObject::boundingBox(Vector3d& min, Vector3d& max) const {
     DLFLVertexPtrList::const_iterator vf,vl;
     double minx,miny,minz;
@@ -388,64 +545,50 @@ namespace DLFL {
     vertexptr->vertexTrace();
   }
 
+  // Look the ID up in the table, rebuilding the table once if IDs have been
+  // handed out since it was last built
+  template <class T, class Iterator>
+  static T findID( DLFLIndex<T>& index, Iterator first, Iterator last, uint id, uint lastid ) {
+    T item = index.find(id);
+    if ( item == NULL && index.stamp() != lastid ) {
+      index.rebuild(first,last,lastid);
+      item = index.find(id);
+    }
+    return item;
+  }
+
   DLFLVertexPtr DLFLObject::findVertex(const uint vid) {
     // Find a vertex with the given vertex id. Return NULL if none exists
-    DLFLVertexPtrList::iterator first = vertex_list.begin(), last = vertex_list.end();
-    DLFLVertexPtr sel = NULL;
-    while ( first != last )
-      {
-				if ( (*first)->getID() == vid )
-          {
-            sel = (*first); break;
-          }
-				++first;
-      }
-    return sel;
+    return findID(vertex_index,vertex_list.begin(),vertex_list.end(),vid,DLFLVertex::lastID());
   }
 
   DLFLEdgePtr DLFLObject::findEdge(const uint eid) {
     // Find an edge with the given edge id. Return NULL if none exists
-    //DLFLEdgePtrList::iterator first = edge_list.begin(), last = edge_list.end();
-    DLFLEdgePtr sel = NULL;
-    /*while ( first != last ) {
-      if( (*first)->getID() == eid ) {
-				sel = (*first); 
-				break;
-      }
-      ++first;
-			}*/
-		sel = (DLFLEdgePtr) edgeMap[eid];
-    return sel;
+    return findID(edge_index,edge_list.begin(),edge_list.end(),eid,DLFLEdge::lastID());
   }
   
   DLFLFacePtr DLFLObject::findFace(const uint fid) {
     // Find a face with the given face id. Return NULL if none exists
-    //DLFLFacePtrList::iterator first = face_list.begin(), last = face_list.end();
-    DLFLFacePtr sel = NULL;
-    /*while ( first != last ) {
-			if ( (*first)->getID() == fid ) {
-				sel = (*first); 
-				break;
-			}
-			++first;
-			}*/
-		sel = (DLFLFacePtr) faceMap[fid];
-    return sel;
+    return findID(face_index,face_list.begin(),face_list.end(),fid,DLFLFace::lastID());
   }
 
   DLFLFaceVertexPtr DLFLObject::findFaceVertex(const uint fvid) {
     // Find a face vertex with the given face vertex id. Return NULL if none exists
-    DLFLFacePtrList::iterator first = face_list.begin(), last = face_list.end();
-    DLFLFaceVertexPtr sel,tmp = NULL;
-    while ( first != last ) {
-			tmp = (*first)->findFaceVertexByID(fvid);
-			if( tmp != NULL ) {
-				sel = tmp; 
-				//break;
-			}
-			++first;
+    DLFLFaceVertexPtr fvp = corner_index.find(fvid);
+    if ( fvp == NULL && corner_index.stamp() != DLFLFaceVertex::lastID() ) {
+      DLFLFaceVertexPtrArray corners;
+      DLFLFacePtrList::iterator first = face_list.begin(), last = face_list.end();
+      while ( first != last ) {
+        DLFLFaceVertexPtr head = (*first)->front(), current = head;
+        if ( head ) do {
+          corners.push_back(current); current = current->next();
+        } while ( current != head );
+        ++first;
+      }
+      corner_index.rebuild(corners.begin(),corners.end(),DLFLFaceVertex::lastID());
+      fvp = corner_index.find(fvid);
     }
-    return sel;
+    return fvp;
   }
 
   void DLFLObject::addVertex(const DLFLVertex& vertex)
@@ -478,6 +621,32 @@ namespace DLFL {
     addFacePtr(faceptr->copy());
   }
 
+  void DLFLObject::addEdges(DLFLEdge * edges, int num_edges, EdgeIndex& edgeindex) {
+    DLFLEdgePtr eptr;
+    EdgeIndex::iterator pos;
+
+    for (int i=0; i < num_edges; ++i) {
+      EdgeKey key(edges[i].getFaceVertexPtr1()->getVertexID(),
+                  edges[i].getFaceVertexPtr2()->getVertexID());
+      pos = edgeindex.find(key);
+      if ( pos == edgeindex.end() ) {
+        addEdge(edges[i]);
+        edgeindex[key] = edge_list.back();
+      } else {
+        // Same as in addEdges without the index. Update the second FaceVertexPtr
+        // of the existing Edge to the matching one from the new Edge
+        eptr = pos->second;
+        uint id2 = (eptr->getFaceVertexPtr2())->getVertexID();
+        uint eid1 = (edges[i].getFaceVertexPtr1())->getVertexID();
+
+        if (eid1 == id2)
+          eptr->setFaceVertexPtr2(edges[i].getFaceVertexPtr1());
+        else
+          eptr->setFaceVertexPtr2(edges[i].getFaceVertexPtr2());
+      }
+    }
+  }
+
   void DLFLObject::computeNormals( ) {
     DLFLVertexPtrList::iterator first, last;
 
@@ -493,6 +662,45 @@ namespace DLFL {
       (*ffirst)->updateNormal();
       ++ffirst;
     }
+    attributesChanged();
+  }
+
+  void DLFLObject::computeNormals( const DLFLFacePtrArray& faces ) {
+    // Same order as the full computation : vertices (and so all their corners) first,
+    // then the faces
+    DLFLFacePtrArray::const_iterator first, last = faces.end();
+    for ( first = faces.begin(); first != last; ++first ) {
+      DLFLFaceVertexPtr head = (*first)->front(), current = head;
+      if ( !head ) continue;
+      do {
+        current->getVertexPtr()->updateNormal();
+        current = current->next();
+      } while ( current != head );
+    }
+    for ( first = faces.begin(); first != last; ++first )
+      (*first)->updateNormal();    attributesChanged();
+  }
+
+  void DLFLObject::markChanged( DLFLEdgePtr ep ) {
+    if ( !tracking || !ep ) return;
+    DLFLFacePtr fp1, fp2;
+    DLFLVertexPtr vp1, vp2;
+    ep->getFacePointers(fp1,fp2);
+    ep->getVertexPointers(vp1,vp2);
+    changed_faces.insert(fp1); changed_faces.insert(fp2);
+    changed_vertices.insert(vp1); changed_vertices.insert(vp2);
+  }
+
+  void DLFLObject::getChangedFaces( DLFLFacePtrArray& faces ) {
+    DLFLFaceSelection region;
+    DLFLFacePtrArray vfaces;
+    region.assign(changed_faces.begin(),changed_faces.end());
+    DLFLVertexSelection::const_iterator first, last = changed_vertices.end();
+    for ( first = changed_vertices.begin(); first != last; ++first ) {
+      (*first)->getFaces(vfaces);
+      for ( uint i = 0; i < vfaces.size(); ++i ) region.insert(vfaces[i]);
+    }
+    faces = region.array();
   }
   /*
 		void DLFLObject::deleteVertex(uint vertex_index) {
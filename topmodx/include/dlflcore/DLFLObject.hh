@@ -54,6 +54,9 @@
 #include "DLFLEdge.hh"
 #include "DLFLFace.hh"
 #include "DLFLMaterial.hh"
+#include "DLFLSelectionSet.hh"
+#include "DLFLIndex.hh"
+#include "DLFLSnapshot.hh"
 #include <Graphics/Transform.hh>
 
 
@@ -70,6 +73,10 @@ public :
     assignID();
     // Add a default material
     matl_list.push_back(new DLFLMaterial("default",0.5,0.5,0.5));
+    journal_ptr = NULL;
+    tracking = false;
+    topology_stamp = 1;
+    attribute_stamp = 1;
     mFilename = NULL;
 		mDirname = NULL;
   };
@@ -88,20 +95,18 @@ protected :
 
   // Generate a new unique ID
   static uint newID( ) {
-    uint temp = suLastID;
-    suLastID++;
-    return temp;
+    return newIDFrom(suLastID);
   };
 
 public :
  
 	static Transformation tr;                         // For doing GL transformations
 
-  DLFLVertexPtrArray sel_vptr_array; // List of selected DLFLVertex pointers
+  DLFLVertexSelection sel_vptr_array; // Selected DLFLVertex pointers
 
-  DLFLEdgePtrArray sel_eptr_array; // List of selected DLFLEdge pointers
-  DLFLFacePtrArray sel_fptr_array; // List of selected DLFLFace pointers
-  DLFLFaceVertexPtrArray sel_fvptr_array; // List of selected DLFLFaceVertex pointers
+  DLFLEdgeSelection sel_eptr_array; // Selected DLFLEdge pointers
+  DLFLFaceSelection sel_fptr_array; // Selected DLFLFace pointers
+  DLFLFaceVertexSelection sel_fvptr_array; // Selected DLFLFaceVertex pointers
 
   void clearSelected( ) {
     sel_vptr_array.clear();
@@ -110,9 +115,6 @@ public :
     sel_fvptr_array.clear();
   };
 
-	HashMap faceMap;
-	HashMap edgeMap;
-
   static DLFLVertexPtrArray vparray;                // For selection
   static DLFLEdgePtrArray   eparray;                // For selection
   static DLFLFacePtrArray   fparray;                // For selection
@@ -122,12 +124,81 @@ public :
   Vector3d           scale_factor;                  // Scale of object
   Quaternion         rotation;                      // Rotation of object
 
-  inline void removeVertex( DLFLVertexPtr vp ) { vertex_list.remove(vp); };
-  inline void removeEdge( DLFLEdgePtr ep ) { edgeMap.erase(ep->getID()); edge_list.remove(ep); };
-  inline void removeFace( DLFLFacePtr fp ) { faceMap.erase(fp->getID()); face_list.remove(fp); };
+  // Constant time, through the list position stored in the element
+  inline void removeVertex( DLFLVertexPtr vp ) {
+    vertex_index.erase(vp); changed_vertices.erase(vp); vp->list_handle.erase(vertex_list);
+    topologyChanged();
+  };
+  inline void removeEdge( DLFLEdgePtr ep ) {
+    edge_index.erase(ep); ep->list_handle.erase(edge_list); topologyChanged();
+  };
+  inline void removeFace( DLFLFacePtr fp ) {
+    face_index.erase(fp); changed_faces.erase(fp); fp->list_handle.erase(face_list);
+    topologyChanged();
+  };
+
+  // Free an element which has been removed from the object.
+  // If a journal is recording changes, the journal takes ownership instead
+  void release( DLFLVertexPtr vp );
+  void release( DLFLEdgePtr ep );
+  void release( DLFLFacePtr fp );
+  void release( DLFLFaceVertexPtr fvp );
+
+  // Journal which records changes to this object for undo. NULL if none
+  DLFLJournalPtr journal( ) const { return journal_ptr; };
+  void setJournal( DLFLJournalPtr jp ) { journal_ptr = jp; };
+
+  // Commit the attached journal, if any, so later changes aren't recorded in it
+  void detachJournal( );
 
   void computeNormals( );
 
+  // Recompute the normals of the given faces and of the vertices in them.
+  // Gives the same result as computeNormals if the faces are all the faces
+  // whose shape changed since the last computation
+  void computeNormals( const DLFLFacePtrArray& faces );
+
+  // Tracking of the region changed by an operation, so normals and lighting
+  // only need updating there. While tracking, new vertices and faces are
+  // collected, and so are the vertices, faces and edges the core operations
+  // (edge insertion, deletion, subdivision and collapse) are about to modify.
+  // Operations which change the mesh any other way (e.g. move vertices
+  // directly) mark what they change themselves, or must not be run while
+  // tracking
+  void trackChanges( ) {
+    tracking = true; changed_vertices.clear(); changed_faces.clear();
+  };
+  void stopTrackingChanges( ) {
+    tracking = false; changed_vertices.clear(); changed_faces.clear();
+  };
+  bool isTrackingChanges( ) const { return tracking; };
+
+  void markChanged( DLFLVertexPtr vp ) { if ( tracking ) changed_vertices.insert(vp); };
+  void markChanged( DLFLFacePtr fp ) { if ( tracking ) changed_faces.insert(fp); };
+  void markChanged( DLFLEdgePtr ep );
+
+  // Faces whose normals may have changed : the changed faces and the faces
+  // around the changed vertices
+  void getChangedFaces( DLFLFacePtrArray& faces );
+
+  // Flattened copy of the mesh for read-only kernels (see DLFLSnapshot.hh).
+  // Rebuilt if the topology changed since the last call, otherwise only the
+  // vertex positions are gathered again
+  const DLFLSnapshot& snapshot( );
+
+  // Advanced whenever elements are added or removed. Operations which
+  // rewire corners without adding or removing elements (e.g. reversing
+  // faces) call topologyChanged themselves
+  uint topologyStamp( ) const { return topology_stamp; };
+  void topologyChanged( ) { ++topology_stamp; };
+
+  // Advanced whenever materials, colors or corner attributes (normals,
+  // texture coordinates) change without the topology changing. The object
+  // methods which do so call it themselves, code setting them directly
+  // (e.g. DLFLFace::setMaterial) has to call it
+  uint attributeStamp( ) const { return attribute_stamp; };
+  void attributesChanged( ) { ++attribute_stamp; };
+
 protected :
 
   DLFLVertexPtrList          vertex_list;           // The vertex list
@@ -135,15 +206,43 @@ protected :
   DLFLFacePtrList            face_list;             // The face list
   DLFLMaterialPtrList        matl_list;             // Material list (for rendering)
 
+  // ID lookup for the find functions. Kept up to date as elements are added
+  // and removed, and rebuilt when an ID is not found but IDs have been handed
+  // out since the last rebuild. Corners are not added through the object, so
+  // their table is only built on lookup. They are erased when they or their
+  // face are released
+  DLFLIndex<DLFLVertexPtr>     vertex_index;
+  DLFLIndex<DLFLEdgePtr>       edge_index;
+  DLFLIndex<DLFLFacePtr>       face_index;
+  DLFLIndex<DLFLFaceVertexPtr> corner_index;
+
+  bool                       tracking;              // Collecting the changed region
+  DLFLVertexSelection        changed_vertices;      // Created or moved vertices
+  DLFLFaceSelection          changed_faces;         // Created or modified faces
+
+  uint                       topology_stamp;        // See topologyChanged
+  uint                       attribute_stamp;       // See attributesChanged
+  DLFLSnapshot               geometry_snapshot;     // Cached by snapshot()
+
   //TMPatchFacePtrList patch_list;		 // List of patch faces
   //int patchsize;				 // Size of each patch
      
   uint uID;                                      // ID for this object
   char *mFilename;
   char *mDirname;
+  DLFLJournalPtr journal_ptr;                    // Journal recording changes, if any
+
   // Assign a unique ID for this instance
   void assignID( ) { uID = DLFLObject::newID(); };
 
+  // Tell the journal about new elements
+  void journalCreated( DLFLVertexPtr vp );
+  void journalCreated( DLFLEdgePtr ep );
+  void journalCreated( DLFLFacePtr fp );
+
+  // Manipulates the element lists directly when undoing/redoing
+  friend class DLFLJournal;
+
   // Free the memory allocated for the patches
   /*void destroyPatches( ) {
     TMPatchFacePtrList::iterator first = patch_list.begin(), last = patch_list.end();
@@ -157,13 +256,9 @@ protected :
 
   // Free all the pointers in the lists and clear the lists
   void clearLists( ) {
-    clear(vertex_list);
-    clear(edge_list);
-    clear(face_list);
+    clearElements();
     clear(matl_list);
     //destroyPatches();
-		edgeMap.clear();
-		faceMap.clear();
   };
 
 private :
@@ -172,8 +267,11 @@ private :
   DLFLObject( const DLFLObject& dlfl )
     : position(dlfl.position), scale_factor(dlfl.scale_factor), rotation(dlfl.rotation),
       vertex_list(dlfl.vertex_list), edge_list(dlfl.edge_list), face_list(dlfl.face_list), matl_list(dlfl.matl_list),
+      vertex_index(dlfl.vertex_index), edge_index(dlfl.edge_index), face_index(dlfl.face_index),
+      corner_index(dlfl.corner_index), tracking(false), topology_stamp(dlfl.topology_stamp),
+      attribute_stamp(dlfl.attribute_stamp),
       //patch_list(dlfl.patch_list), patchsize(dlfl.patchsize),
-      uID(dlfl.uID) { };
+      uID(dlfl.uID), journal_ptr(NULL) { };
 
   // Assignment operator
   DLFLObject& operator=( const DLFLObject& dlfl ) {
@@ -192,8 +290,11 @@ private :
     //patch_list = dlfl.patch_list;
     //patchsize = dlfl.patchsize;
 	 
-		edgeMap = dlfl.edgeMap;
-		faceMap = dlfl.faceMap;
+    vertex_index = dlfl.vertex_index;
+    edge_index = dlfl.edge_index;
+    face_index = dlfl.face_index;
+    corner_index = dlfl.corner_index;
+    topologyChanged(); attributesChanged();
 
     uID = dlfl.uID;
     return (*this);
@@ -287,6 +388,29 @@ public :
     }
   };
 
+  //--- Number the elements by their position in the lists ---//
+  // Sets the index fields, so operators can keep side tables indexed by them.
+  // Unlike the make*Unique functions below, this leaves the IDs alone, so the
+  // ID lookup stays valid and the ID counters shared with other objects are
+  // not touched
+  void indexVertices( ) {
+    uint i = 0;
+    DLFLVertexPtrList::iterator first = vertex_list.begin(), last = vertex_list.end();
+    while ( first != last ) { (*first)->setIndex(i++); ++first; }
+  };
+
+  void indexEdges( ) {
+    uint i = 0;
+    DLFLEdgePtrList::iterator first = edge_list.begin(), last = edge_list.end();
+    while ( first != last ) { (*first)->setIndex(i++); ++first; }
+  };
+
+  void indexFaces( ) {
+    uint i = 0;
+    DLFLFacePtrList::iterator first = face_list.begin(), last = face_list.end();
+    while ( first != last ) { (*first)->setIndex(i++); ++first; }
+  };
+
   //--- Terminal printing functions : useful for debugging ---//
   void print( ) const {
     // Print a summary of the DLFLObject
@@ -348,7 +472,9 @@ public :
     // Make vertices unique
     DLFLVertexPtrList::iterator vfirst=vertex_list.begin(), vlast=vertex_list.end();
     while ( vfirst != vlast ) {
+      vertex_index.erase(*vfirst);
       (*vfirst)->makeUnique();
+      vertex_index.insert(*vfirst);
       ++vfirst;
     }
   };
@@ -357,9 +483,9 @@ public :
     // Make edges unique
     DLFLEdgePtrList::iterator efirst=edge_list.begin(), elast=edge_list.end();
     while ( efirst != elast ) {
-			edgeMap.erase((*efirst)->getID());
+      edge_index.erase(*efirst);
       (*efirst)->makeUnique();
-			edgeMap[(*efirst)->getID()] = (unsigned int)(*efirst);
+      edge_index.insert(*efirst);
       ++efirst;
     }
   }
@@ -368,9 +494,9 @@ public :
     // Make faces unique
     DLFLFacePtrList::iterator ffirst=face_list.begin(), flast=face_list.end();
     while ( ffirst != flast ) {
-			faceMap.erase((*ffirst)->getID());
+      face_index.erase(*ffirst);
       (*ffirst)->makeUnique();
-			faceMap[(*ffirst)->getID()] = (unsigned int)(*ffirst);
+      face_index.insert(*ffirst);
       ++ffirst;
     }
   };
@@ -391,11 +517,46 @@ public :
   void assignTileTexCoords(int n);
   void randomAssignTexCoords( );
 
+  // Delete all vertices, edges and faces, keeping the materials
+  void clearElements( ) {
+    // The elements are freed, not released to the journal
+    detachJournal();
+    // Faces remove themselves from their material when deleted.
+    // Everything goes here so empty the material lists in one go first
+    DLFLMaterialPtrList::iterator mf;
+    for ( mf = matl_list.begin(); mf != matl_list.end(); ++mf )
+      (*mf)->clearFaces();
+    clear(vertex_list);
+    clear(edge_list);
+    clear(face_list);
+    vertex_index.clear();
+    edge_index.clear();
+    face_index.clear();
+    corner_index.clear();
+    changed_vertices.clear();
+    changed_faces.clear();
+    geometry_snapshot.clear();
+    topologyChanged();
+  };
+
   // Combine two DLFLObject instances into 1 object
   // Lists of second object are cleared. Otherwise when that object is destroyed,
   // pointers in this object will become invalid.
   void splice(DLFLObject& object);
 
+  // Append a copy of the given object, which may be this object itself.
+  // The copy has the same vertex coordinates, corner normals and texture
+  // coordinates and face materials; materials of another object are matched
+  // by name and copied if this object has none by that name. The new
+  // elements follow the existing ones in the lists, in the same order as the
+  // originals. If reverse_faces is set the copy has the opposite orientation.
+  // Same result as writeDLFL followed by readDLFL without clearing, but built
+  // directly, and without renumbering the existing elements
+  void append(const DLFLObject& object, bool reverse_faces = false);
+
+  // New object which is a copy of this one (see append)
+  DLFLObjectPtr clone(bool reverse_faces = false) const;
+
   // Reverse the orientation of all faces in the object
   // This also requires reversing all edges in the object
   void reverse( );
@@ -405,7 +566,11 @@ public :
   void addVertexPtr(DLFLVertexPtr vertexptr) {
     // Insert the pointer.
     // **** WARNING!!! **** Pointer will be freed when list is deleted
-    vertex_list.push_back(vertexptr);
+    vertexptr->list_handle.push_back(vertex_list,vertexptr);
+    vertex_index.insert(vertexptr);
+    markChanged(vertexptr);
+    topologyChanged();
+    if ( journal_ptr ) journalCreated(vertexptr);
   };
 
   void addEdge(const DLFLEdge& edge);               // Insert a copy
@@ -413,8 +578,10 @@ public :
   void addEdgePtr(DLFLEdgePtr edgeptr) {
     // Insert the pointer.
     // **** WARNING!!! **** Pointer will be freed when list is deleted
-    edge_list.push_back(edgeptr);
-		edgeMap[edgeptr->getID()] = (unsigned int)edgeptr;
+    edgeptr->list_handle.push_back(edge_list,edgeptr);
+    edge_index.insert(edgeptr);
+    topologyChanged();
+    if ( journal_ptr ) journalCreated(edgeptr);
   };
 
   void addFace(const DLFLFace& face);               // Insert a copy
@@ -425,8 +592,11 @@ public :
     if ( faceptr->material() == NULL )
       // If Face doesn't have a material assigned to it, assign the default material
 	    faceptr->setMaterial(matl_list.front());
-    face_list.push_back(faceptr);
-		faceMap[faceptr->getID()] = (unsigned int)faceptr;
+    faceptr->list_handle.push_back(face_list,faceptr);
+    face_index.insert(faceptr);
+    markChanged(faceptr);
+    topologyChanged();
+    if ( journal_ptr ) journalCreated(faceptr);
   };
 
   DLFLVertexPtr getVertexPtr(uint index) const {
@@ -502,6 +672,11 @@ public :
     }
   };
 
+  // Same as above, but looks up existing edges in the given index (keyed on the
+  // IDs of the end vertices) instead of scanning the edge list. New edges are
+  // added to the index. The index must contain all edges which could match.
+  void addEdges(DLFLEdge * edges, int num_edges, EdgeIndex& edgeindex);
+
   void addEdgesWithoutCheck(DLFLEdge * edges, int num_edges) {
     for (int i=0; i < num_edges; ++i)
       addEdge(edges[i]);
@@ -538,6 +713,13 @@ public :
 	
   void writeObject( ostream& o, ostream &omtl , bool with_normals = true, bool with_tex_coords = true ) const;
   void writeDLFL(ostream& o, ostream &omtl, bool reverse_faces = false) const;
+
+  // Binary DLFL format (.dlfb), see DLFLFileBinary.cc. Materials are stored in the same file.
+  // The file is memory mapped where possible
+  bool readDLFB( const char *filename, bool clearold = true );
+  bool readDLFBMemory( const char *data, size_t size, bool clearold = true );
+  bool writeDLFB( ostream& o ) const;
+
   void writeSTL(ostream& o) const;
   void writeLG3d(ostream& o, bool select = false) const ; //!< added by dave - for LiveGraphics3D support to embed 3d models into html
   inline void setFilename( const char *filename ) { 
@@ -602,6 +784,7 @@ public :
 			matl_list.pop_back();
 			// }
 		}
+		attributesChanged();
 		//add the fresh blank gray material
 		// matl_list.push_back(mptr);
 	}
@@ -628,6 +811,7 @@ public :
   void setColor( const RGBColor& col ) {
     // matl_list[0] is always the default material
     matl_list.front()->setColor(col);
+    attributesChanged();
   };
 
   //-- Geometric Transformations --//
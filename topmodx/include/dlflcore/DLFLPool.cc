@@ -0,0 +1,104 @@
+/*
+*
+* ***** BEGIN GPL LICENSE BLOCK *****
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software  Foundation,
+* Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*
+* The Original Code is Copyright (C) 2005 by xxxxxxxxxxxxxx
+* All rights reserved.
+*
+* The Original Code is: all of this file.
+*
+* Contributor(s): none yet.
+*
+* ***** END GPL LICENSE BLOCK *****
+*/
+
+/**
+ * \file DLFLPool.cc
+ */
+
+#include "DLFLPool.hh"
+#include <new>
+
+namespace DLFL {
+
+  // Holds the lock of a pool until the end of the scope, also if grow throws
+  class DLFLPoolLock {
+  public :
+    DLFLPoolLock( volatile int& lock ) : mLock(lock) {
+      while ( __sync_lock_test_and_set(&mLock,1) )
+        while ( mLock ) ;
+    }
+    ~DLFLPoolLock( ) { __sync_lock_release(&mLock); }
+  private :
+    volatile int& mLock;
+  };
+
+  DLFLPool::DLFLPool( size_t size )
+    : mChunkSize(FirstChunkSize), mNext(NULL), mEnd(NULL), mFree(NULL), mAllocated(0), mReserved(0),
+      mLock(0) {
+    // Keep every slot aligned for the doubles in the elements and big enough
+    // to hold the free list link
+    size_t align = sizeof(double) > sizeof(FreeSlot) ? sizeof(double) : sizeof(FreeSlot);
+    mSize = ( size + align - 1 ) / align * align;
+    mRequested = size;
+  }
+
+  DLFLPool::~DLFLPool( ) {
+    releaseAll();
+  }
+
+  void* DLFLPool::allocate( size_t size ) {
+    if ( size != mRequested ) return ::operator new(size);
+    DLFLPoolLock lock(mLock);
+    void *p;
+    if ( mFree ) {
+      p = mFree; mFree = mFree->next;
+    } else {
+      if ( mNext == mEnd ) grow();
+      p = mNext; mNext += mSize;
+    }
+    ++mAllocated;
+    return p;
+  }
+
+  void DLFLPool::deallocate( void *p, size_t size ) {
+    if ( p == NULL ) return;
+    if ( size != mRequested ) { ::operator delete(p); return; }
+    DLFLPoolLock lock(mLock);
+    FreeSlot *slot = static_cast<FreeSlot *>(p);
+    slot->next = mFree; mFree = slot;
+    if ( --mAllocated == 0 ) releaseAll();
+  }
+
+  void DLFLPool::grow( ) {
+    char *chunk = static_cast<char *>(::operator new(mChunkSize * mSize));
+    mChunks.push_back(chunk);
+    mNext = chunk; mEnd = chunk + mChunkSize * mSize;
+    mReserved += mChunkSize;
+    if ( mChunkSize < MaxChunkSize ) mChunkSize *= 2;
+  }
+
+  void DLFLPool::releaseAll( ) {
+    for ( size_t i = 0; i < mChunks.size(); ++i )
+      ::operator delete(mChunks[i]);
+    mChunks.clear();
+    mChunkSize = FirstChunkSize;
+    mNext = mEnd = NULL; mFree = NULL;
+    mReserved = 0;
+  }
+
+} // end namespace
@@ -0,0 +1,97 @@
+/*
+*
+* ***** BEGIN GPL LICENSE BLOCK *****
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software  Foundation,
+* Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*
+* The Original Code is Copyright (C) 2005 by xxxxxxxxxxxxxx
+* All rights reserved.
+*
+* The Original Code is: all of this file.
+*
+* Contributor(s): none yet.
+*
+* ***** END GPL LICENSE BLOCK *****
+*/
+
+/**
+ * \file DLFLPool.hh
+ */
+
+#ifndef _DLFL_POOL_HH_
+#define _DLFL_POOL_HH_
+
+// Storage for the mesh elements (vertices, edges, faces and corners).
+// Each element class allocates its instances from its own pool through a
+// class specific operator new/delete, so the existing new/delete calls all
+// over the code use the pool without changes. Elements are carved one after
+// the other out of large chunks, so elements created together sit together in
+// memory and list traversals stay within a few pages. Deleted elements go on a
+// free list and their slot is reused by the next allocation, so both take
+// constant time and pointers never move. When the last element of a pool is
+// freed, e.g. when the only object is destroyed or reset, all the chunks are
+// returned at once.
+// A pool is shared by all objects, so allocation is guarded by a spin lock
+// to let operators run on different objects at the same time. The lock is
+// held for a few instructions only.
+
+#include <cstddef>
+#include <vector>
+
+namespace DLFL {
+
+  class DLFLPool {
+  public :
+
+    // Pool for elements of the given size
+    DLFLPool( size_t size );
+    ~DLFLPool( );
+
+    // Allocate or free one element. Requests for a different size, from
+    // derived classes, are passed on to the global operator new/delete
+    void* allocate( size_t size );
+    void deallocate( void *p, size_t size );
+
+    size_t numAllocated( ) const { return mAllocated; };
+    size_t numReserved( ) const { return mReserved; };
+
+  private :
+
+    struct FreeSlot {
+      FreeSlot *next;
+    };
+
+    enum { FirstChunkSize = 1024, MaxChunkSize = 65536 };
+
+    void grow( );
+    void releaseAll( );
+
+    size_t mRequested;                   // Element size
+    size_t mSize;                        // Slot size, the element size rounded up
+    std::vector<char *> mChunks;         // Memory blocks the slots are carved from
+    size_t mChunkSize;                   // Number of slots in the next chunk
+    char *mNext, *mEnd;                  // Unused part of the newest chunk
+    FreeSlot *mFree;                     // Slots of deleted elements
+    size_t mAllocated;                   // Number of live elements
+    size_t mReserved;                    // Number of slots in all chunks
+    volatile int mLock;                  // Set while a thread uses the pool
+
+    DLFLPool( const DLFLPool& );
+    DLFLPool& operator=( const DLFLPool& );
+  };
+
+} // end namespace
+
+#endif /* #ifndef _DLFL_POOL_HH_ */
@@ -0,0 +1,89 @@
+/*
+*
+* ***** BEGIN GPL LICENSE BLOCK *****
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software  Foundation,
+* Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*
+* The Original Code is Copyright (C) 2005 by xxxxxxxxxxxxxx
+* All rights reserved.
+*
+* The Original Code is: all of this file.
+*
+* Contributor(s): none yet.
+*
+* ***** END GPL LICENSE BLOCK *****
+*/
+
+/**
+ * \file DLFLProgress.hh
+ */
+
+#ifndef _DLFL_PROGRESS_HH_
+#define _DLFL_PROGRESS_HH_
+
+// Progress of a long running operation on a DLFLObject, and a request to stop it.
+// Operations which take one call setMaximum before each stage of the work and
+// step as they go. Once cancel has been called they return at the next step,
+// which may leave the object half done : the caller has to restore it.
+// The operation runs on a worker thread while the application reads the
+// progress and cancels from its own thread, so the fields are single words
+// which are only ever written whole.
+
+namespace DLFL {
+
+  class DLFLProgress {
+  public :
+
+    DLFLProgress( ) : maximum(0), value(0), canceled(false) { }
+    virtual ~DLFLProgress( ) { }
+
+    // Start a stage of the operation which takes n steps
+    void setMaximum( int n ) {
+      maximum = n; value = 0; changed();
+    }
+
+    void setValue( int v ) {
+      value = v; changed();
+    }
+
+    // Advance by one step. Returns false if the operation should stop
+    bool step( ) {
+      value = value + 1; changed();
+      return !canceled;
+    }
+
+    int getMaximum( ) const { return maximum; }
+    int getValue( ) const { return value; }
+
+    void cancel( ) { canceled = true; }
+    bool wasCanceled( ) const { return canceled; }
+
+  protected :
+
+    // Called on the operation's thread whenever the progress changes
+    virtual void changed( ) { }
+
+  private :
+
+    volatile int maximum;
+    volatile int value;
+    volatile bool canceled;
+  };
+
+  typedef DLFLProgress * DLFLProgressPtr;
+
+} // end namespace
+
+#endif /* #ifndef _DLFL_PROGRESS_HH_ */
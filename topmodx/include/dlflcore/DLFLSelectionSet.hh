@@ -0,0 +1,164 @@
+/*
+*
+* ***** BEGIN GPL LICENSE BLOCK *****
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software  Foundation,
+* Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*
+* The Original Code is Copyright (C) 2005 by xxxxxxxxxxxxxx
+* All rights reserved.
+*
+* The Original Code is: all of this file.
+*
+* Contributor(s): none yet.
+*
+* ***** END GPL LICENSE BLOCK *****
+*/
+
+
+/**
+ * \file DLFLSelectionSet.hh
+ */
+
+#ifndef _DLFL_SELECTION_SET_HH_
+#define _DLFL_SELECTION_SET_HH_
+
+// Set of selected elements of one kind (vertices, edges, faces or corners).
+// The elements are kept in the order they were selected, since operations
+// like connecting two corners depend on it, and are also indexed by pointer
+// so membership tests, toggling and removal take constant time. Removal
+// leaves a hole in the array which is closed the next time the array is read.
+// Reading the set works like reading the vector it replaces.
+
+#include "DLFLCommon.hh"
+
+namespace DLFL {
+
+  struct PointerHash {
+    size_t operator() ( const void *p ) const {
+      return (size_t)p / sizeof(void *);
+    }
+  };
+
+  template <class T>
+  class DLFLSelectionSet {
+  public :
+
+    typedef vector<T> Array;
+    typedef typename Array::const_iterator const_iterator;
+    typedef typename Array::size_type size_type;
+
+    DLFLSelectionSet( ) : mHoles(0) { }
+
+    // Is the element selected
+    bool contains( T item ) const {
+      return item && mIndex.find(item) != mIndex.end();
+    }
+
+    // Select the element if it isn't already. Returns true if it was added
+    bool insert( T item ) {
+      if ( !item || contains(item) ) return false;
+      mIndex[item] = mItems.size();
+      mItems.push_back(item);
+      return true;
+    }
+
+    // Same as insert, for code written against the old vector
+    void push_back( T item ) {
+      insert(item);
+    }
+
+    // Deselect the element. Returns true if it was selected
+    bool erase( T item ) {
+      typename Index::iterator it = mIndex.find(item);
+      if ( !item || it == mIndex.end() ) return false;
+      mItems[it->second] = NULL;
+      mIndex.erase(it);
+      ++mHoles;
+      return true;
+    }
+
+    // Select the element if it isn't selected, deselect it otherwise.
+    // Returns true if the element is selected afterwards
+    bool toggle( T item ) {
+      if ( erase(item) ) return false;
+      return insert(item);
+    }
+
+    // Put the element at the given position, replacing the element there.
+    // If the position is past the end the element is added at the end
+    void set( size_type index, T item ) {
+      if ( !item || contains(item) ) return;
+      compact();
+      if ( index < mItems.size() ) {
+        mIndex.erase(mItems[index]);
+        mItems[index] = item;
+        mIndex[item] = index;
+      } else insert(item);
+    }
+
+    // Replace the selection with the given elements
+    template <class Iterator>
+    void assign( Iterator first, Iterator last ) {
+      clear();
+      for ( ; first != last; ++first ) insert(*first);
+    }
+
+    void clear( ) {
+      mItems.clear(); mIndex.clear(); mHoles = 0;
+    }
+
+    void reserve( size_type n ) {
+      mItems.reserve(n); mIndex.resize(n);
+    }
+
+    // Read access, in selection order
+    const Array& array( ) const { compact(); return mItems; }
+    operator const Array& ( ) const { return array(); }
+    const_iterator begin( ) const { return array().begin(); }
+    const_iterator end( ) const { return array().end(); }
+    size_type size( ) const { return mItems.size() - mHoles; }
+    bool empty( ) const { return size() == 0; }
+    T operator [] ( size_type index ) const { return array()[index]; }
+
+  private :
+
+    typedef __gnu_cxx::hash_map<T, size_type, PointerHash> Index;
+
+    // Close the holes left by erase
+    void compact( ) const {
+      if ( mHoles == 0 ) return;
+      size_type n = 0;
+      for ( size_type i = 0; i < mItems.size(); ++i )
+        if ( mItems[i] ) {
+          mIndex[mItems[i]] = n;
+          mItems[n++] = mItems[i];
+        }
+      mItems.resize(n);
+      mHoles = 0;
+    }
+
+    mutable Array mItems;                // Selected elements, NULL where one was removed
+    mutable Index mIndex;                // Position of each element in mItems
+    mutable size_type mHoles;            // Number of removed elements still in mItems
+  };
+
+  typedef DLFLSelectionSet<DLFLVertexPtr> DLFLVertexSelection;
+  typedef DLFLSelectionSet<DLFLEdgePtr> DLFLEdgeSelection;
+  typedef DLFLSelectionSet<DLFLFacePtr> DLFLFaceSelection;
+  typedef DLFLSelectionSet<DLFLFaceVertexPtr> DLFLFaceVertexSelection;
+
+} // end namespace
+
+#endif /* #ifndef _DLFL_SELECTION_SET_HH_ */
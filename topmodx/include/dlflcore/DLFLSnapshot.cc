@@ -0,0 +1,105 @@
+/*
+*
+* ***** BEGIN GPL LICENSE BLOCK *****
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software  Foundation,
+* Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*
+* The Original Code is Copyright (C) 2005 by xxxxxxxxxxxxxx
+* All rights reserved.
+*
+* The Original Code is: all of this file.
+*
+* Contributor(s): none yet.
+*
+* ***** END GPL LICENSE BLOCK *****
+*
+* Short description of this file
+*
+* name of .hh file containing function prototypes
+*
+*/
+
+
+#include "DLFLSnapshot.hh"
+#include "DLFLObject.hh"
+
+namespace DLFL {
+
+  void DLFLSnapshot::build( DLFLObjectPtr obj ) {
+    clear();
+    obj->getVertices(vertices);
+    obj->getEdges(edges);
+    obj->getFaces(faces);
+
+    int numverts = vertices.size(), numfaces = faces.size(), numedges = edges.size();
+    for ( int v = 0; v < numverts; ++v ) vertices[v]->setIndex(v);
+
+    // Faces -> corners
+    face_start.reserve(numfaces+1);
+    for ( int f = 0; f < numfaces; ++f ) {
+      face_start.push_back(corners.size());
+      DLFLFaceVertexPtr head = faces[f]->front(), current = head;
+      if ( head == NULL ) continue;
+      do {
+        current->setIndex(corners.size());
+        corners.push_back(current);
+        corner_vertex.push_back(current->vertex->getIndex());
+        corner_face.push_back(f);
+        current = current->next();
+      } while ( current != head );
+    }
+    face_start.push_back(corners.size());
+
+    // Vertices -> corners, in the order the vertices keep them
+    DLFLFaceVertexPtrArray fvparray;
+    vertex_start.reserve(numverts+1);
+    vertex_corners.reserve(corners.size());
+    for ( int v = 0; v < numverts; ++v ) {
+      vertex_start.push_back(vertex_corners.size());
+      fvparray.clear();
+      vertices[v]->getFaceVertices(fvparray);
+      for ( int i = 0; i < (int)fvparray.size(); ++i )
+        vertex_corners.push_back(fvparray[i]->getIndex());
+    }
+    vertex_start.push_back(vertex_corners.size());
+
+    edge_vertices.resize(2*numedges);
+    for ( int e = 0; e < numedges; ++e ) {
+      DLFLVertexPtr vp1, vp2;
+      edges[e]->getVertexPointers(vp1,vp2);
+      edge_vertices[2*e] = vp1->getIndex();
+      edge_vertices[2*e+1] = vp2->getIndex();
+    }
+
+    updatePositions();
+    built = true;
+  }
+
+  void DLFLSnapshot::updatePositions( ) {
+    int numverts = vertices.size();
+    positions.resize(numverts);
+    for ( int v = 0; v < numverts; ++v ) positions[v] = vertices[v]->coords;
+  }
+
+  void DLFLSnapshot::clear( ) {
+    vertices.clear(); edges.clear(); faces.clear(); corners.clear();
+    positions.clear();
+    face_start.clear(); corner_vertex.clear(); corner_face.clear();
+    vertex_start.clear(); vertex_corners.clear();
+    edge_vertices.clear();
+    built = false;
+  }
+
+} // end namespace
@@ -0,0 +1,104 @@
+/*
+*
+* ***** BEGIN GPL LICENSE BLOCK *****
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software  Foundation,
+* Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*
+* The Original Code is Copyright (C) 2005 by xxxxxxxxxxxxxx
+* All rights reserved.
+*
+* The Original Code is: all of this file.
+*
+* Contributor(s): none yet.
+*
+* ***** END GPL LICENSE BLOCK *****
+*/
+
+/**
+ * \file DLFLSnapshot.hh
+ */
+
+#ifndef _DLFL_SNAPSHOT_HH_
+#define _DLFL_SNAPSHOT_HH_
+
+// Flattened copy of the connectivity and vertex positions of an object, for
+// read-only kernels which go over the whole mesh. Elements are numbered in
+// the order of the object lists and all relations are stored as index arrays,
+// so a kernel streams through contiguous memory instead of following list
+// nodes and corner pointers, and a loop over vertices or faces can be split
+// between threads. The element pointers are kept so results can be written
+// back.
+//
+// DLFLObject::snapshot() keeps one up to date: the arrays are rebuilt when the
+// topology changed since they were built, otherwise only the positions are
+// gathered again.
+
+#include "DLFLCommon.hh"
+
+namespace DLFL {
+
+  class DLFLSnapshot {
+  public :
+
+    DLFLSnapshot( ) : stamp(0), built(false) { }
+
+    DLFLVertexPtrArray     vertices;
+    DLFLEdgePtrArray       edges;
+    DLFLFacePtrArray       faces;
+    DLFLFaceVertexPtrArray corners;         // Corners of all faces, face by face
+
+    Vector3dArray          positions;       // Coordinates of each vertex
+
+    // Corners of face f are face_start[f] to face_start[f+1]-1, in order
+    IntArray               face_start;
+    IntArray               corner_vertex;   // Vertex of each corner
+    IntArray               corner_face;     // Face of each corner
+
+    // Corners at vertex v are vertex_corners[vertex_start[v]] to
+    // vertex_corners[vertex_start[v+1]-1], in the order the vertex keeps them
+    IntArray               vertex_start;
+    IntArray               vertex_corners;
+
+    IntArray               edge_vertices;   // 2 end vertices of each edge
+
+    int numVertices( ) const { return (int)vertices.size(); };
+    int numEdges( ) const { return (int)edges.size(); };
+    int numFaces( ) const { return (int)faces.size(); };
+    int numCorners( ) const { return (int)corners.size(); };
+
+    int faceSize( int f ) const { return face_start[f+1] - face_start[f]; };
+    int valence( int v ) const { return vertex_start[v+1] - vertex_start[v]; };
+
+    // Rebuild all arrays from the object. Sets the index fields of the
+    // vertices and corners to their position in the arrays, as the file
+    // writers do
+    void build( DLFLObjectPtr obj );
+
+    // Gather the vertex coordinates again, for when only positions changed
+    void updatePositions( );
+
+    void clear( );
+
+  protected :
+
+    uint stamp;                             // Topology stamp of the object when built
+    bool built;
+
+    friend class DLFLObject;
+  };
+
+} // end namespace
+
+#endif /* #ifndef _DLFL_SNAPSHOT_HH_ */
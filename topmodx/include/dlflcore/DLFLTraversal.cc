@@ -0,0 +1,378 @@
+/*
+*
+* ***** BEGIN GPL LICENSE BLOCK *****
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software  Foundation,
+* Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*
+* The Original Code is Copyright (C) 2005 by xxxxxxxxxxxxxx
+* All rights reserved.
+*
+* The Original Code is: all of this file.
+*
+* Contributor(s): none yet.
+*
+* ***** END GPL LICENSE BLOCK *****
+*/
+
+/**
+ * \file DLFLTraversal.cc
+ */
+
+#include "DLFLTraversal.hh"
+#include "DLFLObject.hh"
+
+namespace DLFL {
+
+  // Same test as DLFLFace::sharesOneVertex, without building a corner array
+  static bool sharesOneVertex( DLFLFacePtr fp1, DLFLFacePtr fp2 ) {
+    DLFLFaceVertexPtr head1 = fp1->front(), head2 = fp2->front();
+    if ( head1 == NULL || head2 == NULL ) return false;
+    int shared = 0;
+    DLFLFaceVertexPtr fvp1 = head1, fvp2;
+    do {
+      fvp2 = head2;
+      do {
+        if ( fvp1->getVertexPtr() == fvp2->getVertexPtr() ) ++shared;
+        fvp2 = fvp2->next();
+      } while ( fvp2 != head2 );
+      fvp1 = fvp1->next();
+    } while ( fvp1 != head1 );
+    return ( shared == 1 );
+  }
+
+  void DLFLTraversal::startVertices( DLFLObjectPtr obj ) {
+    obj->indexVertices();
+    vmark.assign(obj->num_vertices(),false);
+    vstack.clear();
+  }
+
+  void DLFLTraversal::startEdges( DLFLObjectPtr obj ) {
+    obj->indexEdges();
+    emark.assign(obj->num_edges(),false);
+    estack.clear();
+  }
+
+  void DLFLTraversal::startFaces( DLFLObjectPtr obj ) {
+    obj->indexFaces();
+    fmark.assign(obj->num_faces(),false);
+    fstack.clear();
+  }
+
+  void DLFLTraversal::edgeLoop( DLFLObjectPtr obj, DLFLEdgePtr ep, DLFLEdgePtrArray& loop ) {
+    loop.clear();
+    if ( ep == NULL ) return;
+    startEdges(obj);
+
+    DLFLVertexPtr vp[2];
+    DLFLEdgePtr cur;
+    emark[ep->getIndex()] = true; loop.push_back(ep); estack.push_back(ep);
+    while ( !estack.empty() ) {
+      cur = estack.back(); estack.pop_back();
+      cur->getVertexPointers(vp[0],vp[1]);
+      // The loop only continues from edges between 2 regular vertices
+      if ( vp[0]->valence() != 4 || vp[1]->valence() != 4 ) continue;
+      for (int i=0; i < 2; ++i) {
+        // Of the 4 edges at the vertex, the one across is the one not in a face with this one
+        eadjacent.clear(); vp[i]->getEdges(eadjacent);
+        for (int j=0; j < (int)eadjacent.size(); ++j) {
+          DLFLEdgePtr adj = eadjacent[j];
+          if ( emark[adj->getIndex()] || coFacial(adj,cur) ) continue;
+          emark[adj->getIndex()] = true; loop.push_back(adj); estack.push_back(adj);
+        }
+      }
+    }
+  }
+
+  void DLFLTraversal::walkQuads( DLFLEdgePtr ep, DLFLFacePtr fp, DLFLEdgePtrArray* edges, DLFLFacePtrArray* faces ) {
+    DLFLFaceVertexPtr fvp;
+    DLFLFacePtr fp1, fp2;
+    while ( fp && fp->size() == 4 && !fmark[fp->getIndex()] ) {
+      fmark[fp->getIndex()] = true;
+      if ( faces ) faces->push_back(fp);
+
+      // Go to the opposite edge of the quad
+      fvp = fp->front();
+      for (int i=0; i < 4 && fvp->getEdgePtr() != ep; ++i) fvp = fvp->next();
+      if ( fvp->getEdgePtr() != ep ) return;
+      ep = fvp->next()->next()->getEdgePtr();
+      if ( emark[ep->getIndex()] ) return;                // Back at the start of a closed ring
+      emark[ep->getIndex()] = true;
+      if ( edges ) edges->push_back(ep);
+
+      // and across it to the next face
+      ep->getFacePointers(fp1,fp2);
+      fp = ( fp1 == fp ) ? fp2 : fp1;
+    }
+  }
+
+  void DLFLTraversal::edgeRing( DLFLObjectPtr obj, DLFLEdgePtr ep, DLFLEdgePtrArray& ring ) {
+    ring.clear();
+    if ( ep == NULL ) return;
+    startEdges(obj); startFaces(obj);
+
+    DLFLFacePtr fp1, fp2;
+    emark[ep->getIndex()] = true; ring.push_back(ep);
+    ep->getFacePointers(fp1,fp2);
+    walkQuads(ep,fp1,&ring,NULL);
+    walkQuads(ep,fp2,&ring,NULL);
+  }
+
+  void DLFLTraversal::faceLoop( DLFLObjectPtr obj, DLFLEdgePtr ep, DLFLFacePtrArray& loop ) {
+    loop.clear();
+    if ( ep == NULL ) return;
+    startEdges(obj); startFaces(obj);
+
+    DLFLFacePtr fp1, fp2;
+    emark[ep->getIndex()] = true;
+    ep->getFacePointers(fp1,fp2);
+    walkQuads(ep,fp1,NULL,&loop);
+    walkQuads(ep,fp2,NULL,&loop);
+  }
+
+  void DLFLTraversal::checkerboard( DLFLObjectPtr obj, DLFLFacePtr fp, DLFLFacePtrArray& faces ) {
+    faces.clear();
+    if ( fp == NULL ) return;
+    startFaces(obj);
+
+    DLFLFacePtr cur, adj;
+    DLFLFaceVertexPtr head, fvp;
+    fmark[fp->getIndex()] = true; faces.push_back(fp); fstack.push_back(fp);
+    while ( !fstack.empty() ) {
+      cur = fstack.back(); fstack.pop_back();
+      head = fvp = cur->front();
+      if ( head == NULL ) continue;
+      do {
+        // Faces around each vertex of this face
+        fvp->getVertexPtr()->getFaces(fadjacent);
+        for (int j=0; j < (int)fadjacent.size(); ++j) {
+          adj = fadjacent[j];
+          if ( adj == cur || fmark[adj->getIndex()] || !sharesOneVertex(cur,adj) ) continue;
+          fmark[adj->getIndex()] = true; faces.push_back(adj); fstack.push_back(adj);
+        }
+        fvp = fvp->next();
+      } while ( fvp != head );
+    }
+  }
+
+  void DLFLTraversal::growVertices( DLFLObjectPtr obj, const DLFLVertexPtrArray& vertices,
+                                    DLFLVertexPtrArray& added, int rings ) {
+    added.clear();
+    startVertices(obj);
+    for (int i=0; i < (int)vertices.size(); ++i) vmark[vertices[i]->getIndex()] = true;
+
+    // Each ring starts from the vertices reached by the previous one
+    vstack.assign(vertices.begin(),vertices.end());
+    uint begin = 0, end;
+    DLFLVertexPtr vp, adj;
+    for (int r=0; r < rings && begin < vstack.size(); ++r) {
+      end = vstack.size();
+      for (uint i=begin; i < end; ++i) {
+        vp = vstack[i];
+        eadjacent.clear(); vp->getEdges(eadjacent);
+        for (int j=0; j < (int)eadjacent.size(); ++j) {
+          adj = eadjacent[j]->getOtherVertexPointer(vp);
+          if ( adj == NULL || vmark[adj->getIndex()] ) continue;
+          vmark[adj->getIndex()] = true; added.push_back(adj); vstack.push_back(adj);
+        }
+      }
+      begin = end;
+    }
+  }
+
+  void DLFLTraversal::growEdges( DLFLObjectPtr obj, const DLFLEdgePtrArray& edges,
+                                 DLFLEdgePtrArray& added, int rings ) {
+    added.clear();
+    startEdges(obj);
+    for (int i=0; i < (int)edges.size(); ++i) emark[edges[i]->getIndex()] = true;
+
+    estack.assign(edges.begin(),edges.end());
+    uint begin = 0, end;
+    DLFLEdgePtr adj;
+    DLFLVertexPtr vp[2];
+    for (int r=0; r < rings && begin < estack.size(); ++r) {
+      end = estack.size();
+      for (uint i=begin; i < end; ++i) {
+        estack[i]->getVertexPointers(vp[0],vp[1]);
+        for (int k=0; k < 2; ++k) {
+          eadjacent.clear(); vp[k]->getEdges(eadjacent);
+          for (int j=0; j < (int)eadjacent.size(); ++j) {
+            adj = eadjacent[j];
+            if ( emark[adj->getIndex()] ) continue;
+            emark[adj->getIndex()] = true; added.push_back(adj); estack.push_back(adj);
+          }
+        }
+      }
+      begin = end;
+    }
+  }
+
+  void DLFLTraversal::growFaces( DLFLObjectPtr obj, const DLFLFacePtrArray& faces,
+                                 DLFLFacePtrArray& added, int rings ) {
+    added.clear();
+    startFaces(obj);
+    for (int i=0; i < (int)faces.size(); ++i) fmark[faces[i]->getIndex()] = true;
+
+    fstack.assign(faces.begin(),faces.end());
+    uint begin = 0, end;
+    DLFLFacePtr fp, adj;
+    DLFLFaceVertexPtr head, fvp;
+    for (int r=0; r < rings && begin < fstack.size(); ++r) {
+      end = fstack.size();
+      for (uint i=begin; i < end; ++i) {
+        fp = fstack[i];
+        head = fvp = fp->front();
+        if ( head == NULL ) continue;
+        do {
+          adj = fvp->getEdgePtr()->getOtherFacePointer(fp);
+          if ( adj && !fmark[adj->getIndex()] ) {
+            fmark[adj->getIndex()] = true; added.push_back(adj); fstack.push_back(adj);
+          }
+          fvp = fvp->next();
+        } while ( fvp != head );
+      }
+      begin = end;
+    }
+  }
+
+  // For shrinking, the marks are the elements still in the set. Each ring
+  // drops the elements with a neighbour outside the set, all at once
+  void DLFLTraversal::shrinkVertices( DLFLObjectPtr obj, const DLFLVertexPtrArray& vertices,
+                                      DLFLVertexPtrArray& removed, int rings ) {
+    removed.clear();
+    startVertices(obj);
+    for (int i=0; i < (int)vertices.size(); ++i) vmark[vertices[i]->getIndex()] = true;
+
+    DLFLVertexPtr vp, adj;
+    for (int r=0; r < rings; ++r) {
+      uint begin = removed.size();
+      for (int i=0; i < (int)vertices.size(); ++i) {
+        vp = vertices[i];
+        if ( !vmark[vp->getIndex()] ) continue;
+        eadjacent.clear(); vp->getEdges(eadjacent);
+        for (int j=0; j < (int)eadjacent.size(); ++j) {
+          adj = eadjacent[j]->getOtherVertexPointer(vp);
+          if ( adj && !vmark[adj->getIndex()] ) { removed.push_back(vp); break; }
+        }
+      }
+      if ( removed.size() == begin ) break;
+      for (uint i=begin; i < removed.size(); ++i) vmark[removed[i]->getIndex()] = false;
+    }
+  }
+
+  void DLFLTraversal::shrinkEdges( DLFLObjectPtr obj, const DLFLEdgePtrArray& edges,
+                                   DLFLEdgePtrArray& removed, int rings ) {
+    removed.clear();
+    startEdges(obj);
+    for (int i=0; i < (int)edges.size(); ++i) emark[edges[i]->getIndex()] = true;
+
+    DLFLEdgePtr ep;
+    DLFLVertexPtr vp[2];
+    for (int r=0; r < rings; ++r) {
+      uint begin = removed.size();
+      for (int i=0; i < (int)edges.size(); ++i) {
+        ep = edges[i];
+        if ( !emark[ep->getIndex()] ) continue;
+        ep->getVertexPointers(vp[0],vp[1]);
+        bool boundary = false;
+        for (int k=0; k < 2 && !boundary; ++k) {
+          eadjacent.clear(); vp[k]->getEdges(eadjacent);
+          for (int j=0; j < (int)eadjacent.size(); ++j)
+            if ( !emark[eadjacent[j]->getIndex()] ) { boundary = true; break; }
+        }
+        if ( boundary ) removed.push_back(ep);
+      }
+      if ( removed.size() == begin ) break;
+      for (uint i=begin; i < removed.size(); ++i) emark[removed[i]->getIndex()] = false;
+    }
+  }
+
+  void DLFLTraversal::shrinkFaces( DLFLObjectPtr obj, const DLFLFacePtrArray& faces,
+                                   DLFLFacePtrArray& removed, int rings ) {
+    removed.clear();
+    startFaces(obj);
+    for (int i=0; i < (int)faces.size(); ++i) fmark[faces[i]->getIndex()] = true;
+
+    DLFLFacePtr fp, adj;
+    DLFLFaceVertexPtr head, fvp;
+    for (int r=0; r < rings; ++r) {
+      uint begin = removed.size();
+      for (int i=0; i < (int)faces.size(); ++i) {
+        fp = faces[i];
+        if ( !fmark[fp->getIndex()] ) continue;
+        head = fvp = fp->front();
+        if ( head == NULL ) continue;
+        do {
+          adj = fvp->getEdgePtr()->getOtherFacePointer(fp);
+          if ( adj && !fmark[adj->getIndex()] ) { removed.push_back(fp); break; }
+          fvp = fvp->next();
+        } while ( fvp != head );
+      }
+      if ( removed.size() == begin ) break;
+      for (uint i=begin; i < removed.size(); ++i) fmark[removed[i]->getIndex()] = false;
+    }
+  }
+
+  void DLFLTraversal::connectedFaces( DLFLObjectPtr obj, DLFLFacePtr fp, DLFLFacePtrArray& faces ) {
+    faces.clear();
+    if ( fp == NULL ) return;
+    startFaces(obj);
+
+    DLFLFacePtr cur, adj;
+    DLFLFaceVertexPtr head, fvp;
+    fmark[fp->getIndex()] = true; faces.push_back(fp); fstack.push_back(fp);
+    while ( !fstack.empty() ) {
+      cur = fstack.back(); fstack.pop_back();
+      head = fvp = cur->front();
+      if ( head == NULL ) continue;
+      do {
+        adj = fvp->getEdgePtr()->getOtherFacePointer(cur);
+        if ( adj && !fmark[adj->getIndex()] ) {
+          fmark[adj->getIndex()] = true; faces.push_back(adj); fstack.push_back(adj);
+        }
+        fvp = fvp->next();
+      } while ( fvp != head );
+    }
+  }
+
+  int DLFLTraversal::faceComponents( DLFLObjectPtr obj, IntArray& labels ) {
+    startFaces(obj);
+    labels.assign(obj->num_faces(),-1);
+
+    int count = 0;
+    DLFLFacePtr fp, cur, adj;
+    DLFLFaceVertexPtr head, fvp;
+    DLFLFacePtrList::iterator first = obj->beginFace(), last = obj->endFace();
+    while ( first != last ) {
+      fp = (*first); ++first;
+      if ( fmark[fp->getIndex()] ) continue;
+      fmark[fp->getIndex()] = true; labels[fp->getIndex()] = count; fstack.push_back(fp);
+      while ( !fstack.empty() ) {
+        cur = fstack.back(); fstack.pop_back();
+        head = fvp = cur->front();
+        if ( head == NULL ) continue;
+        do {
+          adj = fvp->getEdgePtr()->getOtherFacePointer(cur);
+          if ( adj && !fmark[adj->getIndex()] ) {
+            fmark[adj->getIndex()] = true; labels[adj->getIndex()] = count; fstack.push_back(adj);
+          }
+          fvp = fvp->next();
+        } while ( fvp != head );
+      }
+      ++count;
+    }
+    return count;
+  }
+
+} // end namespace
@@ -0,0 +1,123 @@
+/*
+*
+* ***** BEGIN GPL LICENSE BLOCK *****
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software  Foundation,
+* Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*
+* The Original Code is Copyright (C) 2005 by xxxxxxxxxxxxxx
+* All rights reserved.
+*
+* The Original Code is: all of this file.
+*
+* Contributor(s): none yet.
+*
+* ***** END GPL LICENSE BLOCK *****
+*/
+
+/**
+ * \file DLFLTraversal.hh
+ */
+
+#ifndef _DLFL_TRAVERSAL_HH_
+#define _DLFL_TRAVERSAL_HH_
+
+// Walks over the connectivity of an object: edge loops, edge rings, face
+// loops, checkerboard patterns, k-ring growing and shrinking of selections
+// and connected components. All walks are iterative, so long loops on big
+// meshes don't run out of stack.
+//
+// Visited elements are marked in bit arrays indexed by the index fields of
+// the elements. Each walk numbers the elements it needs first, so the index
+// fields of the object are overwritten. The bit arrays and the temporary
+// arrays are kept between walks, so a DLFLTraversal which is reused doesn't
+// allocate once it has grown to the size of the object.
+
+#include "DLFLCommon.hh"
+
+namespace DLFL {
+
+  class DLFLTraversal {
+  public :
+
+    DLFLTraversal( ) { }
+
+    // Edges of the loop through the given edge, including it. The loop goes
+    // straight across vertices of valence 4 and stops at other vertices
+    void edgeLoop( DLFLObjectPtr obj, DLFLEdgePtr ep, DLFLEdgePtrArray& loop );
+
+    // Edges of the ring through the given edge, including it. The ring goes
+    // across quads to the opposite edge and stops at other faces
+    void edgeRing( DLFLObjectPtr obj, DLFLEdgePtr ep, DLFLEdgePtrArray& ring );
+
+    // Quads crossed by the ring through the given edge
+    void faceLoop( DLFLObjectPtr obj, DLFLEdgePtr ep, DLFLFacePtrArray& loop );
+
+    // Faces reached from the given face by going to faces which share
+    // exactly one vertex with the current one, including the given face
+    void checkerboard( DLFLObjectPtr obj, DLFLFacePtr fp, DLFLFacePtrArray& faces );
+
+    // Elements within the given number of rings around a set of elements
+    // which are not in the set. Vertices are neighbours if they share an
+    // edge, edges if they share a vertex and faces if they share an edge
+    void growVertices( DLFLObjectPtr obj, const DLFLVertexPtrArray& vertices,
+                       DLFLVertexPtrArray& added, int rings=1 );
+    void growEdges( DLFLObjectPtr obj, const DLFLEdgePtrArray& edges,
+                    DLFLEdgePtrArray& added, int rings=1 );
+    void growFaces( DLFLObjectPtr obj, const DLFLFacePtrArray& faces,
+                    DLFLFacePtrArray& added, int rings=1 );
+
+    // Elements of a set which are within the given number of rings of an
+    // element outside the set, i.e. the ones to drop to shrink the set
+    void shrinkVertices( DLFLObjectPtr obj, const DLFLVertexPtrArray& vertices,
+                         DLFLVertexPtrArray& removed, int rings=1 );
+    void shrinkEdges( DLFLObjectPtr obj, const DLFLEdgePtrArray& edges,
+                      DLFLEdgePtrArray& removed, int rings=1 );
+    void shrinkFaces( DLFLObjectPtr obj, const DLFLFacePtrArray& faces,
+                      DLFLFacePtrArray& removed, int rings=1 );
+
+    // Faces connected to the given face through edges, including it
+    void connectedFaces( DLFLObjectPtr obj, DLFLFacePtr fp, DLFLFacePtrArray& faces );
+
+    // Label each face with the number of its connected component. Labels are
+    // indexed by the face index fields, which are set by this function.
+    // Returns the number of components
+    int faceComponents( DLFLObjectPtr obj, IntArray& labels );
+
+  protected :
+
+    // Number the elements and clear the visited marks
+    void startVertices( DLFLObjectPtr obj );
+    void startEdges( DLFLObjectPtr obj );
+    void startFaces( DLFLObjectPtr obj );
+
+    // Walk across quads starting at edge ep in face fp. Collects the edges
+    // crossed or the quads, whichever array is given
+    void walkQuads( DLFLEdgePtr ep, DLFLFacePtr fp, DLFLEdgePtrArray* edges, DLFLFacePtrArray* faces );
+
+    vector<bool>      vmark;                // Visited marks, by index
+    vector<bool>      emark;
+    vector<bool>      fmark;
+
+    DLFLVertexPtrArray vstack;              // Elements still to be visited
+    DLFLEdgePtrArray   estack;
+    DLFLFacePtrArray   fstack;
+
+    DLFLEdgePtrArray   eadjacent;           // Neighbours of the element being visited
+    DLFLFacePtrArray   fadjacent;
+  };
+
+} // end namespace
+
+#endif /* #ifndef _DLFL_TRAVERSAL_HH_ */
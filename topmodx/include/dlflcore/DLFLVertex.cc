@@ -44,6 +44,20 @@
 namespace DLFL {
   uint DLFLVertex::suLastID = 0;
 
+  static DLFLPool& vertexPool( ) {
+    // Never destroyed : elements of static objects may be freed after it
+    static DLFLPool *pool = new DLFLPool(sizeof(DLFLVertex));
+    return *pool;
+  }
+
+  void* DLFLVertex::operator new( size_t size ) {
+    return vertexPool().allocate(size);
+  }
+
+  void DLFLVertex::operator delete( void *p, size_t size ) {
+    vertexPool().deallocate(p,size);
+  }
+
   // Dump contents of this object to an output stream
   void DLFLVertex::dump(ostream& o) const {
     o << "DLFLVertex" << endl
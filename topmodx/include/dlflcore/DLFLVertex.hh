@@ -37,16 +37,23 @@
 // Based on the OBJVertex class
 
 #include "DLFLCommon.hh"
+#include "DLFLPool.hh"
 
 namespace DLFL {
   
   class DLFLVertex {
   public :
     static void setLastID( uint id ) {
-      if( id > suLastID )
-	suLastID = id;
+      raiseIDCounter(suLastID,id);
     };
 
+    // Last ID handed out. Changes whenever an element gets a new ID
+    static uint lastID( ) { return suLastID; };
+
+    // Instances are allocated from a pool, see DLFLPool.hh
+    static void* operator new( size_t size );
+    static void operator delete( void *p, size_t size );
+
   protected :
     static uint suLastID;                             // Distinct ID for each instance
     // The last assigned ID is stored in this
@@ -54,9 +61,7 @@ namespace DLFL {
 
     // Generate a new unique ID
     static uint newID(void) {
-      uint temp = suLastID;
-      suLastID++;
-      return temp;
+      return newIDFrom(suLastID);
     };
      
   public :
@@ -75,6 +80,10 @@ namespace DLFL {
     Vector3d              auxcoords;                  // Coords for use during subdivs, etc.
     Vector3d              auxnormal;                  // Extra storage for normal
     Vector3d              normal;                     // Average normal at this vertex
+    DLFLListHandle<DLFLVertexPtr> list_handle;        // Position in the vertex list of the object
+
+    // Maintains list_handle
+    friend class DLFLObject;
 
     // Assign a unique ID for this instance
     void assignID(void) {
@@ -178,6 +187,10 @@ namespace DLFL {
       return index;
     }
 
+    void setIndex(uint i) {
+      index = i;
+    }
+
     Vector3d getAuxCoords(void) const {
       return auxcoords;
     }
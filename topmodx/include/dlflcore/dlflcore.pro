@@ -29,8 +29,15 @@ HEADERS += \
 	DLFLEdge.hh \
 	DLFLFace.hh \
 	DLFLFaceVertex.hh \
+	DLFLIndex.hh \
+	DLFLJournal.hh \
 	DLFLMaterial.hh \
 	DLFLObject.hh \
+	DLFLPool.hh \
+	DLFLProgress.hh \
+	DLFLSelectionSet.hh \
+	DLFLSnapshot.hh \
+	DLFLTraversal.hh \
 	DLFLVertex.hh
 
 SOURCES += \
@@ -42,5 +49,11 @@ SOURCES += \
 	DLFLFaceVertex.cc \
 	DLFLFile.cc \
         DLFLFileAlt.cc \
+	DLFLFileBinary.cc \
+	DLFLJournal.cc \
+	DLFLMaterial.cc \
 	DLFLObject.cc \
+	DLFLPool.cc \
+	DLFLSnapshot.cc \
+	DLFLTraversal.cc \
 	DLFLVertex.cc
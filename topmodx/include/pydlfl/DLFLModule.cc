@@ -57,6 +57,7 @@ static PyObject *dlfl_save_obj(PyObject *self, PyObject *args);
 
 /* Core */
 static PyObject *dlfl_insert_edge(PyObject *self, PyObject *args);
+static PyObject *dlfl_insert_edges(PyObject *self, PyObject *args);
 static PyObject *dlfl_delete_edge(PyObject *self, PyObject *args);
 static PyObject *dlfl_collapse_edge(PyObject *self, PyObject *args);
 static PyObject *dlfl_subdivide_edge(PyObject *self, PyObject *args);
@@ -100,6 +101,7 @@ static PyObject *dlfl_centroid(PyObject *self, PyObject *args);
 
 /* Auxiliary */
 static PyObject *dlfl_extrude(PyObject *self, PyObject *args);
+static PyObject *dlfl_extrude_faces(PyObject *self, PyObject *args);
 static PyObject *dlfl_subdivide(PyObject *self, PyObject *args);
 static PyObject *dlfl_subdivide_face(PyObject *self, PyObject *args);
 static PyObject *dlfl_subdivide_faces(PyObject *self, PyObject *args);
@@ -115,6 +117,21 @@ static PyObject *dlfl_column(PyObject *self, PyObject *args);
 //static PyObject *dlfl_multiface(PyObject *self, PyObject *args);
 //static PyObject *dlfl_menger(PyObject *self, PyObject *args);
 
+/* Bulk Access */
+static PyObject *dlfl_positions(PyObject *self, PyObject *args);
+static PyObject *dlfl_normals(PyObject *self, PyObject *args);
+static PyObject *dlfl_texcoords(PyObject *self, PyObject *args);
+static PyObject *dlfl_face_corners(PyObject *self, PyObject *args);
+static PyObject *dlfl_vertex_ids(PyObject *self, PyObject *args);
+static PyObject *dlfl_face_ids(PyObject *self, PyObject *args);
+static PyObject *dlfl_set_positions(PyObject *self, PyObject *args);
+static PyObject *dlfl_set_normals(PyObject *self, PyObject *args);
+static PyObject *dlfl_set_texcoords(PyObject *self, PyObject *args);
+static PyObject *dlfl_create_faces(PyObject *self, PyObject *args);
+
+/* IDs from a list, tuple or integer array, for the commands taking many elements */
+static bool getIDArray(PyObject *obj, DLFL::IntArray& ids);
+
 /* Transform */
 static PyObject *dlfl_translate(PyObject *self, PyObject *args);
 static PyObject *dlfl_scale(PyObject *self, PyObject *args);
@@ -134,6 +151,7 @@ static PyMethodDef DLFLMethods[] = {
   //{"query",          dlfl_query_obj,      METH_VARARGS, "query()"},
 	/* Core */
   {"insertEdge",     dlfl_insert_edge,    METH_VARARGS, "Inserts an Edge"},
+  {"insertEdges",    dlfl_insert_edges,   METH_VARARGS, "Inserts an Edge for each pair of corners in a list"},
   {"deleteEdge",     dlfl_delete_edge,    METH_VARARGS, "Delete an Edge."},
   {"collapseEdge",   dlfl_collapse_edge,  METH_VARARGS, "Collapse an Edge."},
   {"subdivideEdge",  dlfl_subdivide_edge, METH_VARARGS, "Subdivide an Edge."},
@@ -167,6 +185,7 @@ static PyMethodDef DLFLMethods[] = {
   {"centroid",      dlfl_centroid,       METH_VARARGS, "Get centroid of vertices"},
   /* Auxiliary Below */
   {"extrude",        dlfl_extrude,        METH_VARARGS, "Extrude a face"},
+  {"extrudeFaces",   dlfl_extrude_faces,  METH_VARARGS, "Extrude a list of faces"},
   {"subdivide",      dlfl_subdivide,      METH_VARARGS, "Subdivide a mesh"},
   {"subdivideFace",  dlfl_subdivide_face, METH_VARARGS, "Subdivide a Face"},
   {"subdivideFaces",  dlfl_subdivide_faces, METH_VARARGS, "Subdivide a list of Faces"},
@@ -181,6 +200,17 @@ static PyMethodDef DLFLMethods[] = {
 	/*	{"sierpinsky",     dlfl_sierpinsky,     METH_VARARGS, ""},
 	{"multiface",      dlfl_multiface,      METH_VARARGS, ""},
 	{"menger",         dlfl_menger,         METH_VARARGS, ""},*/
+	/* Bulk Access */
+  {"positions",      dlfl_positions,      METH_VARARGS, "Coordinates of all vertices as an array of shape (vertices,3)"},
+  {"normals",        dlfl_normals,        METH_VARARGS, "Normals of all corners as an array of shape (corners,3)"},
+  {"texcoords",      dlfl_texcoords,      METH_VARARGS, "Texture coordinates of all corners as an array of shape (corners,2)"},
+  {"faceCorners",    dlfl_face_corners,   METH_VARARGS, "Start of each face in the corner array and the vertex index of each corner"},
+  {"vertexIDs",      dlfl_vertex_ids,     METH_VARARGS, "IDs of all vertices, in the order of positions()"},
+  {"faceIDs",        dlfl_face_ids,       METH_VARARGS, "IDs of all faces, in the order of faceCorners()"},
+  {"setPositions",   dlfl_set_positions,  METH_VARARGS, "Set the coordinates of all vertices from an array of shape (vertices,3)"},
+  {"setNormals",     dlfl_set_normals,    METH_VARARGS, "Set the normals of all corners from an array of shape (corners,3)"},
+  {"setTexCoords",   dlfl_set_texcoords,  METH_VARARGS, "Set the texture coordinates of all corners from an array of shape (corners,2)"},
+  {"createFaces",    dlfl_create_faces,   METH_VARARGS, "Create faces from an array of coordinates and an array of face sizes"},
 	/* Transform */
   {"translate",      dlfl_translate,      METH_VARARGS, "Translate Object"},
   {"scale",          dlfl_scale,          METH_VARARGS, "Scale Object"},
@@ -196,6 +226,15 @@ static bool usingGUI = false;
 DLFL::DLFLObject *currObj = 0;
 static DLFL::DLFLObjectPtrArray objArray;
 
+/*
+ * The operators which can take a while (subdivision, extrusion, crust, ...)
+ * run between Py_BEGIN_ALLOW_THREADS and Py_END_ALLOW_THREADS, so the
+ * interpreter lock is free while they work: the script editor runs scripts
+ * on a thread of their own and other threads may use Python meanwhile. No
+ * Python calls are made in between, and scripts must not use dlfl from more
+ * than one thread at a time.
+ */
+
 /**
  *  Load/Save Files
  */
@@ -312,6 +351,78 @@ dlfl_insert_edge(PyObject *self, PyObject *args)
 											 faceId1b, vertId1b, faceId2b, vertId2b );
 }
 
+// Corner given either as a (faceid,vertexid) tuple or as an ID from saveCorner
+static DLFL::DLFLFaceVertexPtr findCorner(PyObject *corner) {
+  if( PyInt_Check(corner) || PyLong_Check(corner) )
+    return currObj->findFaceVertex( (uint) PyInt_AsLong(corner) );
+
+  int faceId, vertId;
+  if( !PyTuple_Check(corner) || !PyArg_ParseTuple(corner, "ii", &faceId, &vertId) ) {
+    PyErr_Clear();
+    return NULL;
+  }
+  DLFL::DLFLFacePtr fp = currObj->findFace(faceId);
+  return ( fp ) ? fp->findFaceVertex(vertId) : NULL;
+}
+
+// All corners are looked up before the first edge is inserted. Inserting an
+// edge changes face IDs but not the corners themselves, so each pair still
+// refers to the corners the caller meant, without saveCorner/restoreCorner
+static PyObject *
+dlfl_insert_edges(PyObject *self, PyObject *args)
+{
+  PyObject *list, *seq;
+  bool check = true;
+
+  if( !PyArg_ParseTuple(args, "O|b", &list, &check) )
+    return NULL;
+  if( !(seq = PySequence_Fast(list, "expected a list of corner pairs")) )
+    return NULL;
+
+  int size = PySequence_Fast_GET_SIZE(seq);
+  if( !currObj || size == 0 ) {
+    Py_DECREF(seq);
+    return PyList_New(0);
+  }
+
+  DLFL::DLFLFaceVertexPtrArray corners(2*size, NULL);
+  for( int i = 0; i < size; i++ ) {
+    PyObject *pair = PySequence_Fast_GET_ITEM(seq, i);
+    if( !PySequence_Check(pair) || PySequence_Size(pair) != 2 ) {
+      Py_DECREF(seq);
+      PyErr_SetString(PyExc_TypeError, "expected a list of corner pairs");
+      return NULL;
+    }
+    for( int j = 0; j < 2; j++ ) {
+      PyObject *corner = PySequence_GetItem(pair, j);
+      corners[2*i+j] = findCorner(corner);
+      Py_XDECREF(corner);
+    }
+  }
+  Py_DECREF(seq);
+
+  DLFL::IntArray edgeids(size, -1);
+  Py_BEGIN_ALLOW_THREADS
+  for( int i = 0; i < size; i++ ) {
+    DLFL::DLFLEdgePtr ep = NULL;
+    if( corners[2*i] && corners[2*i+1] ) {
+      if( check )
+        ep = DLFL::insertEdge( currObj, corners[2*i], corners[2*i+1] );
+      else
+        ep = DLFL::insertEdgeWithoutCheck( currObj, corners[2*i], corners[2*i+1] );
+    }
+    if( ep ) edgeids[i] = ep->getID();
+  }
+  currObj->clearSelected( );
+  Py_END_ALLOW_THREADS
+
+  PyObject *edges = PyList_New(size);
+  for( int i = 0; i < size; i++ )
+    PyList_SET_ITEM(edges, i, PyInt_FromLong(edgeids[i]));
+
+  return edges;
+}
+
 static PyObject *
 dlfl_delete_edge(PyObject *self, PyObject *args)
 {
@@ -1043,6 +1154,52 @@ static PyObject *dlfl_centroid(PyObject *self, PyObject *args) {
 
  /* Auxiliary */
 
+static const char* extrudeChoices[] = { "doo-sabin",
+					 "dodeca",
+					 "icosa",
+					 "octa",
+					 "stellate",
+					 "double-stellate",
+					 "cubical" };
+
+// Index of the extrusion type in extrudeChoices, -1 if unknown
+static int extrudeChoice(const char *extrudeType, int size) {
+  for(int i = 0; i < 7; i++ ) {
+    if( strncmp(extrudeType,extrudeChoices[i],size) == 0 )
+      return i;
+  }
+  return -1;
+}
+
+// Extrude one face, returns the ID of the extruded face or -1
+static int extrudeFace(int choice, DLFL::DLFLFacePtr fp, double dist, int num, double rotTwist, double sf, bool boolean) {
+  DLFL::DLFLFacePtr ofp = 0;
+  switch( choice ) {
+  case 0 : // doo-sabin
+    ofp = DLFL::extrudeFaceDS( currObj, fp, dist, num, rotTwist, sf );
+    break;
+  case 1 : // dodeca
+    ofp = DLFL::extrudeFaceDodeca( currObj, fp, dist, num, rotTwist, sf, boolean );
+    break;
+  case 2 : // icosa
+    ofp = DLFL::extrudeFaceIcosa( currObj, fp, dist, num, rotTwist, sf );
+    break;
+  case 3 : // octa a.k.a. extrude dual face
+    ofp = DLFL::extrudeDualFace( currObj, fp, dist, num, rotTwist, sf, boolean );
+    break;
+  case 4 : // stellate
+    DLFL::stellateFace( currObj, fp, dist );
+    break;
+  case 5 : // double-stellate
+    DLFL::doubleStellateFace( currObj, fp, dist );
+    break;
+  case 6 : // cubical
+  default : // cubical
+    ofp = DLFL::extrudeFace( currObj, fp, dist, num, rotTwist, sf );
+  }
+  return ( ofp ) ? (int)ofp->getID() : -1;
+}
+
 static PyObject *
 dlfl_extrude(PyObject *self, PyObject *args) {
   if( !currObj ) {
@@ -1050,14 +1207,6 @@ dlfl_extrude(PyObject *self, PyObject *args) {
     return Py_None;
   }
 
-  const char* choices[] = { "doo-sabin",
-			    "dodeca",
-			    "icosa",
-			    "octa",
-			    "stellate",
-			    "double-stellate",
-			    "cubical" };
-
   char* extrudeType;
   int size, faceid;
   double dist = 2.0; int num = 1; double rotTwist = 0.0; double sf = 1.0; bool boolean = false;
@@ -1065,46 +1214,16 @@ dlfl_extrude(PyObject *self, PyObject *args) {
 			&dist, &num, &rotTwist, &sf, &boolean ) )
     return NULL;
 
-  int choice = -1;
-  for(int i = 0; i < 7; i++ ) {
-    if( strncmp(extrudeType,choices[i],size) == 0 ) {
-      choice = i;
-      break;
-    }
-  }
+  int choice = extrudeChoice(extrudeType, size);
 
   DLFL::DLFLFacePtr fp = currObj->findFace(faceid);
 	if( !fp ) return Py_BuildValue("i", -1 );
-  DLFL::DLFLFacePtr ofp = 0;
-  int outFaceID = -1;
 
   if( choice != -1 && fp != NULL ) {
-    switch( choice ) {
-    case 0 : // doo-sabin
-      ofp = DLFL::extrudeFaceDS( currObj, fp, dist, num, rotTwist, sf );
-      break;
-    case 1 : // dodeca
-      ofp = DLFL::extrudeFaceDodeca( currObj, fp, dist, num, rotTwist, sf, boolean );
-      break;
-    case 2 : // icosa
-      ofp = DLFL::extrudeFaceIcosa( currObj, fp, dist, num, rotTwist, sf );
-      break;
-    case 3 : // octa a.k.a. extrude dual face
-      ofp = DLFL::extrudeDualFace( currObj, fp, dist, num, rotTwist, sf, boolean );
-      break;
-    case 4 : // stellate
-      DLFL::stellateFace( currObj, fp, dist );
-      break;
-    case 5 : // double-stellate
-      DLFL::doubleStellateFace( currObj, fp, dist );
-      break;
-    case 6 : // cubical
-    default : // cubical
-      ofp = DLFL::extrudeFace( currObj, fp, dist, num, rotTwist, sf );
-    }
-
-    if( ofp )
-      outFaceID = ofp->getID();
+    int outFaceID;
+    Py_BEGIN_ALLOW_THREADS
+    outFaceID = extrudeFace( choice, fp, dist, num, rotTwist, sf, boolean );
+    Py_END_ALLOW_THREADS
 
     currObj->clearSelected( );
 
@@ -1115,6 +1234,51 @@ dlfl_extrude(PyObject *self, PyObject *args) {
   return Py_None;
 }
 
+// Same as extrude for a list of faces. The faces are looked up before any of
+// them is extruded, the result has the extruded face ID (or -1) for each
+static PyObject *
+dlfl_extrude_faces(PyObject *self, PyObject *args) {
+  if( !currObj ) {
+    Py_INCREF(Py_None);
+    return Py_None;
+  }
+
+  char* extrudeType;
+  int size;
+  PyObject *list;
+  DLFL::IntArray faceids;
+  double dist = 2.0; int num = 1; double rotTwist = 0.0; double sf = 1.0; bool boolean = false;
+  if( !PyArg_ParseTuple(args, "s#O|diddb", &extrudeType, &size, &list,
+			&dist, &num, &rotTwist, &sf, &boolean ) )
+    return NULL;
+  if( !getIDArray(list, faceids) )
+    return NULL;
+
+  int choice = extrudeChoice(extrudeType, size);
+  if( choice == -1 ) {
+    Py_INCREF(Py_None);
+    return Py_None;
+  }
+
+  // Faces are looked up one at a time, since extruding with the mesh flag
+  // deletes edges and with them neighbouring faces. -1 for those
+  DLFL::IntArray outids(faceids.size(), -1);
+  Py_BEGIN_ALLOW_THREADS
+  for( int i = 0; i < (int)faceids.size(); i++ ) {
+    DLFL::DLFLFacePtr fp = currObj->findFace(faceids[i]);
+    if( fp )
+      outids[i] = extrudeFace( choice, fp, dist, num, rotTwist, sf, boolean );
+  }
+  currObj->clearSelected( );
+  Py_END_ALLOW_THREADS
+
+  PyObject *outlist = PyList_New(outids.size());
+  for( int i = 0; i < (int)outids.size(); i++ )
+    PyList_SET_ITEM(outlist, i, PyInt_FromLong(outids[i]));
+
+  return outlist;
+}
+
 static PyObject *
 dlfl_subdivide(PyObject *self, PyObject *args) {
   if( !currObj ) {
@@ -1170,6 +1334,7 @@ dlfl_subdivide(PyObject *self, PyObject *args) {
   }
 
   if( choice != -1 ) {
+    Py_BEGIN_ALLOW_THREADS
     switch( choice ) {
     case 0 : // loop
       DLFL::loopSubdivide( currObj );
@@ -1257,6 +1422,7 @@ dlfl_subdivide(PyObject *self, PyObject *args) {
       if( battrb1 ) DLFL::subdivideAllFaces( currObj, (bool)attrb1 );
       else DLFL::subdivideAllFaces( currObj );
     }
+    Py_END_ALLOW_THREADS
   }
   Py_INCREF(Py_None);
   return Py_None;
@@ -1273,8 +1439,10 @@ static PyObject *dlfl_subdivide_face(PyObject *self, PyObject *args) {
   if( currObj ) {
 		DLFL::DLFLFacePtr fp = currObj->findFace(fid);
 		if(fp) {
+			Py_BEGIN_ALLOW_THREADS
 			DLFL::subdivideFace( currObj, fp, usequads );
 			currObj->clearSelected( );
+			Py_END_ALLOW_THREADS
 		}
   }
 
@@ -1282,34 +1450,49 @@ static PyObject *dlfl_subdivide_face(PyObject *self, PyObject *args) {
   return Py_None;
 }
 
+// Subdivides the faces in the list and returns the IDs of the faces created.
+// The subdivided faces keep their IDs as one of the pieces
 static PyObject *dlfl_subdivide_faces(PyObject *self, PyObject *args) { 
 	bool usequads = true;
 
 	DLFL::DLFLFacePtrArray faces;
-	DLFL::DLFLFacePtrArray::iterator it;
+	DLFL::IntArray faceids;
 
-	PyObject *list, *faceid;
+	PyObject *list;
 
-	if( !PyArg_ParseTuple( args, "O!|b", &PyList_Type, &list, &usequads ) )
+	if( !PyArg_ParseTuple( args, "O|b", &list, &usequads ) )
+		return NULL;
+	if( !getIDArray(list, faceids) )
 		return NULL;
 
-	int size = PyList_Size(list);
+	int size = faceids.size();
+	PyObject *newfaces = PyList_New(0);
 
 	if( currObj && size > 0 ) {
 
+		faces.reserve(size);
 		for( int i = 0; i < size; i++ ) {
-			faceid = PyList_GetItem(list,i);
-			if( !PyInt_Check(faceid) ) break;
-			uint id = (uint) PyInt_AsLong(faceid);
-			DLFL::DLFLFacePtr fp = currObj->findFace( id );
+			DLFL::DLFLFacePtr fp = currObj->findFace( faceids[i] );
 			if(fp) { faces.push_back(fp); }
 		}
 
+		// New faces are added at the end of the face list
+		DLFL::DLFLFacePtr last = ( currObj->num_faces() > 0 ) ? currObj->lastFace() : NULL;
+		Py_BEGIN_ALLOW_THREADS
 		DLFL::subdivideFaces( currObj, faces, usequads );
+		currObj->clearSelected( );
+		Py_END_ALLOW_THREADS
+
+		DLFL::DLFLFacePtrList::reverse_iterator it = currObj->rbeginFace();
+		for( ; it != currObj->rendFace() && *it != last; ++it ) {
+			PyObject *id = PyInt_FromLong( (*it)->getID() );
+			PyList_Append(newfaces, id);
+			Py_DECREF(id);
+		}
+		PyList_Reverse(newfaces);
 	}
 
-	Py_INCREF(Py_None);
-  return Py_None;
+  return newfaces;
 }
 
 static 
@@ -1318,8 +1501,10 @@ PyObject *dlfl_dual(PyObject *self, PyObject *args)
   bool accurate = false;
   PyArg_ParseTuple(args, "|b", &accurate);
   if( currObj ) {
+    Py_BEGIN_ALLOW_THREADS
     DLFL::createDual( currObj, accurate );
     currObj->clearSelected( );
+    Py_END_ALLOW_THREADS
   }
   Py_INCREF(Py_None);
   return Py_None;
@@ -1397,7 +1582,9 @@ static PyObject *dlfl_connectFaces(PyObject *self, PyObject *args) {
 		fp1 = currObj->findFace(f1);
 		fp2 = currObj->findFace(f2);
 		if( fp1 && fp2 ) {
+		Py_BEGIN_ALLOW_THREADS
 		DLFL::connectFaces( currObj, fp1, fp2, numsegs );//, maxconn );
+		Py_END_ALLOW_THREADS
 		}
 	}
 
@@ -1424,12 +1611,13 @@ static PyObject *dlfl_addHandle(PyObject *self, PyObject *args) {
 		fvp1 = fp1->findFaceVertex(v1);
 		fvp2 = fp2->findFaceVertex(v2);
 		if( fvp1 && fvp2 ) {
-			
+			Py_BEGIN_ALLOW_THREADS
 			if( strncmp( type, "hermite", size) == 0 ) {
 				DLFL::hermiteConnectFaces( currObj, fvp1, fvp2, numsegs, wt1, wt2, maxconn, numtwists );
 			} else if( strncmp( type, "bezier", size) == 0 ) {
 				DLFL::bezierConnectFaces( currObj, fvp1, fvp2, numsegs, wt1, wt2 );
 			}
+			Py_END_ALLOW_THREADS
 		}
 	}
 	Py_INCREF( Py_None );
@@ -1461,6 +1649,7 @@ static PyObject *dlfl_rindmodel(PyObject *self, PyObject *args) {
 			if(fp) { faces.push_back(fp); }
 		}
 
+		Py_BEGIN_ALLOW_THREADS
 		if( useScaling ) {
 			DLFL::createCrustWithScaling( currObj, thickScale );
 		} else {
@@ -1470,6 +1659,7 @@ static PyObject *dlfl_rindmodel(PyObject *self, PyObject *args) {
 		for( it = faces.begin(); it != faces.end(); it++ )
 			(*it)->setType(DLFL::FTHole);
 		DLFL::punchHoles(currObj);
+		Py_END_ALLOW_THREADS
 	}
 
 	Py_INCREF(Py_None);
@@ -1483,8 +1673,11 @@ static PyObject *dlfl_wireframe(PyObject *self, PyObject *args) {
 	if( !PyArg_ParseTuple(args, "d|b", &thickness, &split) )
 		return NULL;
 
-	if( currObj && thickness != 0 )
+	if( currObj && thickness != 0 ) {
+		Py_BEGIN_ALLOW_THREADS
 		DLFL::makeWireframe( currObj, thickness, split);
+		Py_END_ALLOW_THREADS
+	}
 
 	Py_INCREF( Py_None );
 	return Py_None;
@@ -1497,8 +1690,11 @@ static PyObject *dlfl_column(PyObject *self, PyObject *args) {
 	if( !PyArg_ParseTuple(args, "di", &thickness, &segments) )
 		return NULL;
 
-	if( currObj )
+	if( currObj ) {
+		Py_BEGIN_ALLOW_THREADS
 		DLFL::makeWireframeWithColumns( currObj, thickness, segments );
+		Py_END_ALLOW_THREADS
+	}
 
 	Py_INCREF( Py_None );
 	return Py_None;
@@ -1583,10 +1779,489 @@ static PyObject *dlfl_move(PyObject *self, PyObject *args) {
 	return Py_None;
 }
 
+/**
+ *  Bulk Access
+ *
+ *  Whole-mesh arrays for scripts which touch every vertex or corner. Each
+ *  array is filled in one pass from the flattened snapshot of the object and
+ *  handed to Python through the buffer protocol, so numpy.asarray() or
+ *  memoryview() read and write it in place instead of building a Python
+ *  object per element. The mesh keeps its elements in separate nodes, so the
+ *  arrays are copies: changes are applied with setPositions, setNormals and
+ *  setTexCoords. Vertices are in the order of verts(), corners face by face
+ *  in the order of faces().
+ */
+
+// The buffer protocol needs Python 2.6. With older versions the arrays are
+// handed over as lists, and arguments are read from sequences
+#if PY_VERSION_HEX >= 0x02060000
+#define DLFL_MESH_BUFFERS
+#endif
+
+typedef struct {
+  PyObject_HEAD
+  char *data;
+  int ndim;
+  Py_ssize_t itemsize;
+  Py_ssize_t shape[2];
+  Py_ssize_t strides[2];
+  char format[2];
+} MeshArray;
+
+static void MeshArray_dealloc(PyObject *self) {
+  PyMem_Free(((MeshArray *)self)->data);
+  PyObject_Del(self);
+}
+
+static Py_ssize_t MeshArray_length(PyObject *self) {
+  return ((MeshArray *)self)->shape[0];
+}
+
+#ifdef DLFL_MESH_BUFFERS
+static int MeshArray_getbuffer(PyObject *self, Py_buffer *view, int flags) {
+  MeshArray *a = (MeshArray *)self;
+  view->buf = a->data;
+  view->obj = self; Py_INCREF(self);
+  view->len = a->shape[0] * a->shape[1] * a->itemsize;
+  view->readonly = 0;
+  view->itemsize = a->itemsize;
+  view->format = (flags & PyBUF_FORMAT) ? a->format : NULL;
+  view->ndim = a->ndim;
+  view->shape = (flags & PyBUF_ND) ? a->shape : NULL;
+  view->strides = ((flags & PyBUF_STRIDES) == PyBUF_STRIDES) ? a->strides : NULL;
+  view->suboffsets = NULL;
+  view->internal = NULL;
+  return 0;
+}
+
+static PyBufferProcs MeshArray_as_buffer = {
+  0, 0, 0, 0,                               /* old style buffer */
+  MeshArray_getbuffer,                      /* bf_getbuffer */
+  0,                                        /* bf_releasebuffer */
+};
+#endif
+
+static PySequenceMethods MeshArray_as_sequence = {
+  MeshArray_length,                         /* sq_length */
+};
+
+static PyTypeObject MeshArrayType = {
+  PyObject_HEAD_INIT(NULL)
+  0,                                        /* ob_size */
+  "dlfl.MeshArray",                         /* tp_name */
+  sizeof(MeshArray),                        /* tp_basicsize */
+  0,                                        /* tp_itemsize */
+  MeshArray_dealloc,                        /* tp_dealloc */
+  0, 0, 0, 0, 0, 0,                         /* tp_print .. tp_as_number */
+  &MeshArray_as_sequence,                   /* tp_as_sequence */
+  0, 0, 0, 0, 0, 0,                         /* tp_as_mapping .. tp_setattro */
+#ifdef DLFL_MESH_BUFFERS
+  &MeshArray_as_buffer,                     /* tp_as_buffer */
+  Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HAVE_NEWBUFFER, /* tp_flags */
+#else
+  0,                                        /* tp_as_buffer */
+  Py_TPFLAGS_DEFAULT,                       /* tp_flags */
+#endif
+  "Contiguous array of mesh data, for use with numpy.asarray or memoryview", /* tp_doc */
+};
+
+// New array of rows x cols items of type 'd' (double) or 'i'/'I' (int)
+static MeshArray *newMeshArray(Py_ssize_t rows, Py_ssize_t cols, char type) {
+  MeshArray *a = PyObject_New(MeshArray, &MeshArrayType);
+  if( !a ) return NULL;
+  a->itemsize = ( type == 'd' ) ? sizeof(double) : sizeof(int);
+  a->data = (char *)PyMem_Malloc( rows * cols * a->itemsize + 1 );
+  if( !a->data ) {
+    PyObject_Del(a);
+    return (MeshArray *)PyErr_NoMemory();
+  }
+  a->ndim = ( cols == 1 ) ? 1 : 2;
+  a->shape[0] = rows; a->shape[1] = cols;
+  a->strides[0] = cols * a->itemsize; a->strides[1] = a->itemsize;
+  a->format[0] = type; a->format[1] = '\0';
+  return a;
+}
+
+#ifndef DLFL_MESH_BUFFERS
+// Item of a filled array as a Python number
+static PyObject *meshArrayItem(MeshArray *a, Py_ssize_t i) {
+  switch( a->format[0] ) {
+  case 'd' : return PyFloat_FromDouble(((double *)a->data)[i]);
+  case 'I' : return PyLong_FromUnsignedLong(((unsigned int *)a->data)[i]);
+  default : return PyInt_FromLong(((int *)a->data)[i]);
+  }
+}
+#endif
+
+// Hand a filled array over to Python. Without the buffer protocol it is
+// turned into a list, of tuples if it has more than one column
+static PyObject *meshArrayResult(MeshArray *a) {
+#ifdef DLFL_MESH_BUFFERS
+  return (PyObject *)a;
+#else
+  if( !a ) return NULL;
+  Py_ssize_t rows = a->shape[0], cols = a->shape[1];
+  PyObject *list = PyList_New(rows);
+  for( Py_ssize_t r = 0; list && r < rows; r++ ) {
+    PyObject *row;
+    if( cols == 1 )
+      row = meshArrayItem(a, r);
+    else {
+      row = PyTuple_New(cols);
+      for( Py_ssize_t c = 0; row && c < cols; c++ )
+        PyTuple_SET_ITEM(row, c, meshArrayItem(a, r * cols + c));
+    }
+    if( !row ) {
+      Py_DECREF(list); list = NULL;
+    } else
+      PyList_SET_ITEM(list, r, row);
+  }
+  Py_DECREF(a);
+  return list;
+#endif
+}
+
+// Doubles passed in from Python. Read in place from a buffer where the
+// interpreter supports it, copied from a sequence of numbers or of rows of
+// numbers otherwise
+class DoubleArg {
+public :
+  const double *data;
+  Py_ssize_t count;
+
+  DoubleArg( ) : data(NULL), count(0), held(false) { }
+  ~DoubleArg( ) { release(); }
+
+  // Get the values, expecting the given number of them if count >= 0.
+  // Sets a Python exception and returns false if the object doesn't fit
+  bool get( PyObject *obj, Py_ssize_t expected ) {
+#ifdef DLFL_MESH_BUFFERS
+    if( PyObject_CheckBuffer(obj) ) {
+      if( PyObject_GetBuffer(obj, &view, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) < 0 )
+        return false;
+      held = true;
+      if( bufferType(view) != 'd' || view.itemsize != sizeof(double) ) {
+        PyErr_SetString(PyExc_TypeError, "expected an array of doubles");
+        return false;
+      }
+      data = (const double *)view.buf;
+      count = view.len / sizeof(double);
+    } else
+#endif
+    if( !getSequence(obj) )
+      return false;
+    if( expected >= 0 && count != expected ) {
+      PyErr_SetString(PyExc_ValueError, "array size doesn't match the object");
+      return false;
+    }
+    return true;
+  }
+
+  void release( ) {
+#ifdef DLFL_MESH_BUFFERS
+    if( held ) PyBuffer_Release(&view);
+#endif
+    held = false;
+  }
+
+#ifdef DLFL_MESH_BUFFERS
+  // Item type of a buffer from Python. NumPy gives formats like "<d"
+  static char bufferType( const Py_buffer& view ) {
+    const char *f = view.format ? view.format : "B";
+    if( *f == '<' || *f == '=' || *f == '@' ) ++f;
+    if( f[0] == '\0' || f[1] != '\0' ) return 0;
+    return f[0];
+  }
+#endif
+
+private :
+#ifdef DLFL_MESH_BUFFERS
+  Py_buffer view;
+#endif
+  bool held;
+  std::vector<double> values;
+
+  bool getSequence( PyObject *obj ) {
+    PyObject *seq = PySequence_Fast(obj, "expected an array of doubles");
+    if( !seq ) return false;
+    Py_ssize_t size = PySequence_Fast_GET_SIZE(seq);
+    values.clear(); values.reserve(size);
+    bool ok = true;
+    for( Py_ssize_t i = 0; ok && i < size; i++ ) {
+      PyObject *item = PySequence_Fast_GET_ITEM(seq, i);
+      if( PyNumber_Check(item) )
+        values.push_back(PyFloat_AsDouble(item));
+      else {
+        PyObject *row = PySequence_Fast(item, "expected an array of doubles");
+        if( !row ) { ok = false; break; }
+        for( Py_ssize_t j = 0; j < PySequence_Fast_GET_SIZE(row); j++ )
+          values.push_back(PyFloat_AsDouble(PySequence_Fast_GET_ITEM(row, j)));
+        Py_DECREF(row);
+      }
+      if( PyErr_Occurred() ) ok = false;
+    }
+    Py_DECREF(seq);
+    data = values.empty() ? NULL : &values[0];
+    count = values.size();
+    return ok;
+  }
+};
+
+#ifdef DLFL_MESH_BUFFERS
+// Copy a C contiguous buffer of 32 or 64 bit integers
+static bool getIntArray(PyObject *obj, DLFL::IntArray& values) {
+  Py_buffer view;
+  if( PyObject_GetBuffer(obj, &view, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) < 0 )
+    return false;
+  char type = DoubleArg::bufferType(view);
+  bool ok = type && strchr("iIlLqQ", type) && ( view.itemsize == 4 || view.itemsize == 8 );
+  if( ok ) {
+    Py_ssize_t n = view.len / view.itemsize;
+    values.resize(n);
+    for( Py_ssize_t i = 0; i < n; i++ )
+      values[i] = ( view.itemsize == 4 ) ? ((int *)view.buf)[i] : (int)((long long *)view.buf)[i];
+  } else
+    PyErr_SetString(PyExc_TypeError, "expected an array of integers");
+  PyBuffer_Release(&view);
+  return ok;
+}
+#endif
+
+static bool getIDArray(PyObject *obj, DLFL::IntArray& ids) {
+#ifdef DLFL_MESH_BUFFERS
+  if( PyObject_CheckBuffer(obj) )
+    return getIntArray(obj, ids);
+#endif
+
+  PyObject *seq = PySequence_Fast(obj, "expected a list of IDs");
+  if( !seq ) return false;
+  int size = PySequence_Fast_GET_SIZE(seq);
+  ids.resize(size);
+  for( int i = 0; i < size; i++ ) {
+    PyObject *id = PySequence_Fast_GET_ITEM(seq, i);
+    if( !PyInt_Check(id) && !PyLong_Check(id) ) {
+      Py_DECREF(seq);
+      PyErr_SetString(PyExc_TypeError, "expected a list of IDs");
+      return false;
+    }
+    ids[i] = (int) PyInt_AsLong(id);
+  }
+  Py_DECREF(seq);
+  return true;
+}
+
+static PyObject *dlfl_positions(PyObject *self, PyObject *args) {
+  if( !currObj ) {
+    Py_INCREF(Py_None);
+    return Py_None;
+  }
+  const DLFL::DLFLSnapshot& snap = currObj->snapshot();
+  MeshArray *a = newMeshArray(snap.numVertices(), 3, 'd');
+  if( !a ) return NULL;
+  double *p = (double *)a->data;
+  for( int v = 0; v < snap.numVertices(); v++, p += 3 ) {
+    p[0] = snap.positions[v][0]; p[1] = snap.positions[v][1]; p[2] = snap.positions[v][2];
+  }
+  return meshArrayResult(a);
+}
+
+static PyObject *dlfl_normals(PyObject *self, PyObject *args) {
+  if( !currObj ) {
+    Py_INCREF(Py_None);
+    return Py_None;
+  }
+  const DLFL::DLFLSnapshot& snap = currObj->snapshot();
+  MeshArray *a = newMeshArray(snap.numCorners(), 3, 'd');
+  if( !a ) return NULL;
+  double *p = (double *)a->data;
+  for( int c = 0; c < snap.numCorners(); c++, p += 3 ) {
+    const Vector3d& n = snap.corners[c]->normal;
+    p[0] = n[0]; p[1] = n[1]; p[2] = n[2];
+  }
+  return meshArrayResult(a);
+}
+
+static PyObject *dlfl_texcoords(PyObject *self, PyObject *args) {
+  if( !currObj ) {
+    Py_INCREF(Py_None);
+    return Py_None;
+  }
+  const DLFL::DLFLSnapshot& snap = currObj->snapshot();
+  MeshArray *a = newMeshArray(snap.numCorners(), 2, 'd');
+  if( !a ) return NULL;
+  double *p = (double *)a->data;
+  for( int c = 0; c < snap.numCorners(); c++, p += 2 ) {
+    const Vector2d& t = snap.corners[c]->texcoord;
+    p[0] = t[0]; p[1] = t[1];
+  }
+  return meshArrayResult(a);
+}
+
+// The corners of face f are start[f] to start[f+1]-1, and vertices[c] is the
+// index of the vertex of corner c in positions()
+static PyObject *dlfl_face_corners(PyObject *self, PyObject *args) {
+  if( !currObj ) {
+    Py_INCREF(Py_None);
+    return Py_None;
+  }
+  const DLFL::DLFLSnapshot& snap = currObj->snapshot();
+  MeshArray *start = newMeshArray(snap.face_start.size(), 1, 'i');
+  if( !start ) return NULL;
+  MeshArray *verts = newMeshArray(snap.corner_vertex.size(), 1, 'i');
+  if( !verts ) {
+    Py_DECREF(start);
+    return NULL;
+  }
+  if( !snap.face_start.empty() )
+    memcpy(start->data, &snap.face_start[0], snap.face_start.size() * sizeof(int));
+  if( !snap.corner_vertex.empty() )
+    memcpy(verts->data, &snap.corner_vertex[0], snap.corner_vertex.size() * sizeof(int));
+  PyObject *starts = meshArrayResult(start), *vertices = meshArrayResult(verts);
+  if( !starts || !vertices ) {
+    Py_XDECREF(starts); Py_XDECREF(vertices);
+    return NULL;
+  }
+  return Py_BuildValue("NN", starts, vertices);
+}
+
+static PyObject *dlfl_vertex_ids(PyObject *self, PyObject *args) {
+  if( !currObj ) {
+    Py_INCREF(Py_None);
+    return Py_None;
+  }
+  const DLFL::DLFLSnapshot& snap = currObj->snapshot();
+  MeshArray *a = newMeshArray(snap.numVertices(), 1, 'I');
+  if( !a ) return NULL;
+  for( int v = 0; v < snap.numVertices(); v++ )
+    ((unsigned int *)a->data)[v] = snap.vertices[v]->getID();
+  return meshArrayResult(a);
+}
+
+static PyObject *dlfl_face_ids(PyObject *self, PyObject *args) {
+  if( !currObj ) {
+    Py_INCREF(Py_None);
+    return Py_None;
+  }
+  const DLFL::DLFLSnapshot& snap = currObj->snapshot();
+  MeshArray *a = newMeshArray(snap.numFaces(), 1, 'I');
+  if( !a ) return NULL;
+  for( int f = 0; f < snap.numFaces(); f++ )
+    ((unsigned int *)a->data)[f] = snap.faces[f]->getID();
+  return meshArrayResult(a);
+}
+
+static PyObject *dlfl_set_positions(PyObject *self, PyObject *args) {
+  PyObject *array;
+  DoubleArg values;
+  if( !PyArg_ParseTuple(args, "O", &array) )
+    return NULL;
+
+  if( currObj ) {
+    const DLFL::DLFLSnapshot& snap = currObj->snapshot();
+    if( !values.get(array, 3 * snap.numVertices()) )
+      return NULL;
+    const double *p = values.data;
+    for( int v = 0; v < snap.numVertices(); v++, p += 3 ) {
+      snap.vertices[v]->coords.set(p[0], p[1], p[2]);
+      currObj->markChanged(snap.vertices[v]);
+    }
+  }
+  Py_INCREF(Py_None);
+  return Py_None;
+}
+
+static PyObject *dlfl_set_normals(PyObject *self, PyObject *args) {
+  PyObject *array;
+  DoubleArg values;
+  if( !PyArg_ParseTuple(args, "O", &array) )
+    return NULL;
+
+  if( currObj ) {
+    const DLFL::DLFLSnapshot& snap = currObj->snapshot();
+    if( !values.get(array, 3 * snap.numCorners()) )
+      return NULL;
+    const double *p = values.data;
+    for( int c = 0; c < snap.numCorners(); c++, p += 3 )
+      snap.corners[c]->normal.set(p[0], p[1], p[2]);
+    currObj->attributesChanged();
+  }
+  Py_INCREF(Py_None);
+  return Py_None;
+}
+
+static PyObject *dlfl_set_texcoords(PyObject *self, PyObject *args) {
+  PyObject *array;
+  DoubleArg values;
+  if( !PyArg_ParseTuple(args, "O", &array) )
+    return NULL;
+
+  if( currObj ) {
+    const DLFL::DLFLSnapshot& snap = currObj->snapshot();
+    if( !values.get(array, 2 * snap.numCorners()) )
+      return NULL;
+    const double *p = values.data;
+    for( int c = 0; c < snap.numCorners(); c++, p += 2 )
+      snap.corners[c]->texcoord.set(p[0], p[1]);
+    currObj->attributesChanged();
+  }
+  Py_INCREF(Py_None);
+  return Py_None;
+}
+
+// Same as createFace for many faces at once. The coordinates of the faces
+// follow each other in points, sizes gives the number of vertices of each.
+// Returns the IDs of the 2 faces created for each, as an array of shape (faces,2)
+static PyObject *dlfl_create_faces(PyObject *self, PyObject *args) {
+  PyObject *points, *sizes;
+  bool bothNew = false;
+  DoubleArg coords;
+  DLFL::IntArray fsizes;
+  if( !PyArg_ParseTuple(args, "OO|b", &points, &sizes, &bothNew) )
+    return NULL;
+  if( !getIDArray(sizes, fsizes) || !coords.get(points, -1) )
+    return NULL;
+
+  Py_ssize_t numpoints = coords.count / 3, total = 0;
+  for( int i = 0; i < (int)fsizes.size(); i++ ) {
+    if( fsizes[i] < 1 ) total = -1;
+    if( total >= 0 ) total += fsizes[i];
+  }
+  if( total != numpoints || coords.count != numpoints * 3 ) {
+    PyErr_SetString(PyExc_ValueError, "face sizes don't match the number of points");
+    return NULL;
+  }
+
+  MeshArray *ids = newMeshArray(fsizes.size(), 2, 'I');
+  if( !ids )
+    return NULL;
+
+  if( !usingGUI ) {
+    if( currObj == NULL )
+      currObj = new DLFL::DLFLObject;
+  }
+  const double *p = coords.data;
+  unsigned int *fid = (unsigned int *)ids->data;
+  std::vector<Vector3d> varray;
+  DLFL::DLFLFacePtrArray fpa;
+  Py_BEGIN_ALLOW_THREADS
+  for( int i = 0; i < (int)fsizes.size(); i++, fid += 2 ) {
+    varray.resize(fsizes[i]);
+    for( int j = 0; j < fsizes[i]; j++, p += 3 )
+      varray[j].set(p[0], p[1], p[2]);
+    fpa = currObj->createFace( varray, NULL, bothNew );
+    if( !bothNew )
+      currObj->lastFace()->setType(DLFL::FTNew);
+    fid[0] = ( fpa.size() == 2 ) ? fpa[0]->getID() : 0;
+    fid[1] = ( fpa.size() == 2 ) ? fpa[1]->getID() : 0;
+  }
+  Py_END_ALLOW_THREADS
+  return meshArrayResult(ids);
+}
+
 /* C API Stuff */
 //static void **PyDLFL_API;
 
-#define NUM_C_API_FUNCS 2
+#define NUM_C_API_FUNCS 3
 
 static void
 PyDLFL_UsingGUI( bool ugui ) 
@@ -1600,6 +2275,13 @@ PyDLFL_PassObject( DLFL::DLFLObject* obj )
   currObj = obj;
 }
 
+// The object scripts are working on, which load() or switch() may have changed
+static DLFL::DLFLObject*
+PyDLFL_CurrentObject( void )
+{
+  return currObj;
+}
+
 /**
  * Initialize
  */
@@ -1611,6 +2293,11 @@ PyMODINIT_FUNC initdlfl(void)
 
 	dlfl = Py_InitModule("dlfl", DLFLMethods);
 
+	if (PyType_Ready(&MeshArrayType) == 0) {
+		Py_INCREF(&MeshArrayType);
+		PyModule_AddObject(dlfl, "MeshArray", (PyObject *)&MeshArrayType);
+	}
+
 	DLFLError = PyErr_NewException("dlfl.error", NULL, NULL);
 	Py_INCREF(DLFLError);
 	PyModule_AddObject(dlfl, "error", DLFLError);
@@ -1620,6 +2307,7 @@ PyMODINIT_FUNC initdlfl(void)
 	/* Initialize the C API pointer array */ 
 	PyDLFL_API[0] = (void *)PyDLFL_UsingGUI; 
 	PyDLFL_API[1] = (void *)PyDLFL_PassObject;
+	PyDLFL_API[2] = (void *)PyDLFL_CurrentObject;
 	/* Create a CObject containing the API pointer array's address */ 
 	PyObject *c_api_object = PyCObject_FromVoidPtr((void *)PyDLFL_API, NULL); 
 	if (c_api_object != NULL) { 
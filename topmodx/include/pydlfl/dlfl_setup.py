@@ -6,7 +6,8 @@ dlfl_module = Extension( 'dlfl',
 			 sources = ['DLFLModule.cc'],
 			 include_dirs = ['..','../vecmat','../dlflcore','../dlflaux'],
 			 library_dirs = ['.','../../lib'],
-			 libraries = ['dlflcore','dlflaux','vecmat'] )
+			 libraries = ['dlflcore','dlflaux','vecmat'],
+			 extra_link_args = ['-fopenmp'] )
 
 setup( name = 'DLFL',
        version = '1.0',
@@ -0,0 +1,31 @@
+#! /usr/bin/env python
+
+# extrudeFaces on adjacent faces with the mesh flag. Dual extrusion then
+# deletes edges, and with them faces further down the list, which must be
+# skipped rather than used. Run from this directory with the dlfl module on
+# the path
+
+from dlfl import *
+import os
+
+objs = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "..", "objs")
+
+for name in ["cube.obj", "soccerball.obj"]:
+    load(os.path.join(objs, name))
+    ids = faces()
+    result = extrudeFaces("octa", ids, 1.0, 1, 0.0, 1.0, True)
+
+    assert len(result) == len(ids)
+    current = set(faces())
+    for fid in result:
+        assert fid == -1 or fid in current
+    # At least one face further down the list was deleted by the earlier ones
+    assert -1 in result
+
+    # The mesh is still consistent
+    for fid in faces():
+        vv, ee = walk(fid)
+        assert len(vv) == faceInfo(fid)['size']
+    print name, len(ids), "faces,", result.count(-1), "deleted before their turn"
+
+print "OK"
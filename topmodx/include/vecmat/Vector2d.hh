@@ -33,7 +33,7 @@
 #define _VECTOR_2D_HH_
 
 // Class for a 2-D vector.
-// Derived from BaseObject
+// Plain value type like Vector3d - no virtual functions
 // Assumes existence of classes Vector3d and Vector4d, which are 3-D and 4-D
 // versions of this class.
 // All the Vector classes are forward declared in Vector.hh, along with any
@@ -47,7 +47,7 @@
 class Vector2d;
 typedef Vector2d * Vector2dPtr;
 
-class Vector2d : public BaseObject
+class Vector2d
 {
   protected :
 
@@ -61,14 +61,12 @@ class Vector2d : public BaseObject
 
         // Default constructor
      Vector2d()
-       : BaseObject()
        {
          elem[0] = elem[1] = 0.0;
        }
 
         // 1 argument constructor - intialize all elements with given value
      Vector2d(double val)
-       : BaseObject()
        {
          elem[0] = elem[1] = val;
        }
@@ -76,49 +74,29 @@ class Vector2d : public BaseObject
         // 1 argument constructor - initialize with given array
         // Assumes array has atleast 2 elements
      Vector2d(double * arr)
-       : BaseObject()
        {
          elem[0] = arr[0]; elem[1] = arr[1];
        }
 
         // 2 argument constructor
      Vector2d(double val1, double val2)
-       : BaseObject()
        {
          elem[0] = val1; elem[1] = val2;
        }
      
-        // Copy constructor
-     Vector2d(const Vector2d& vec)
-       : BaseObject(vec)
-       {
-         elem[0] = vec.elem[0]; elem[1] = vec.elem[1];
-       }
-
         // Construct from a Vector3d - copies first 2 elements
      Vector2d(const Vector3d& vec)
-       : BaseObject()
        {
          copyFrom(vec);
        }
      
         // Construct from a Vector4d - copies first 2 elements
      Vector2d(const Vector4d& vec)
-       : BaseObject()
        {
          copyFrom(vec);
        }
      
-        // Destructor - does nothing
-     virtual ~Vector2d()
-       {}
-
-        // Assignment operator
-     Vector2d& operator = (const Vector2d& vec)
-       {
-         elem[0] = vec.elem[0]; elem[1] = vec.elem[1];
-         return (*this);
-       }
+        // Copy constructor, assignment and destructor are compiler generated
 
         // Assignment from a scalar - both elements are set to the scalar value
      Vector2d& operator = (double scalar)
@@ -142,8 +120,7 @@ class Vector2d : public BaseObject
        }
 
         // Make a copy of the object
-        // implement BaseObject class pure virtual function
-     virtual BaseObjectPtr copy(void) const
+     Vector2dPtr copy(void) const
        {
          Vector2dPtr vec = new Vector2d(*this);
          return vec;
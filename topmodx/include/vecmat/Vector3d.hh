@@ -33,7 +33,8 @@
 #define _VECTOR_3D_HH_
 
 // Class for a 3-D vector.
-// Derived from BaseObject
+// A plain value type with no virtual functions, so it has no vtable pointer
+// and can be copied bitwise. Arrays of vectors are tightly packed.
 // Assumes existence of classes Vector2d and Vector4d, which are 2-D and 4-D
 // versions of this class.
 // All the Vector classes are forward declared in Vector.hh, along with any
@@ -47,7 +48,7 @@
 class Vector3d;
 typedef Vector3d * Vector3dPtr;
 
-class Vector3d : public BaseObject
+class Vector3d
 {
   protected :
 
@@ -61,14 +62,12 @@ class Vector3d : public BaseObject
 
         // Default constructor
      Vector3d()
-       : BaseObject()
        {
          elem[0] = elem[1] = elem[2] = 0.0;
        }
 
         // 1 argument constructor - intialize all elements with given value
      Vector3d(double val)
-       : BaseObject()
        {
          elem[0] = elem[1] = elem[2] = val;
        }
@@ -76,49 +75,30 @@ class Vector3d : public BaseObject
         // 1 argument constructor - initialize with given array
         // Assumes array has atleast 3 elements
      Vector3d(double * arr)
-       : BaseObject()
        {
          elem[0] = arr[0]; elem[1] = arr[1]; elem[2] = arr[2];
        }
 
         // 3 argument constructor
      Vector3d(double val1, double val2, double val3=0.0)
-       : BaseObject()
        {
          elem[0] = val1; elem[1] = val2; elem[2] = val3;
        }
      
-        // Copy constructor
-     Vector3d(const Vector3d& vec)
-       : BaseObject(vec)
-       {
-         elem[0] = vec.elem[0]; elem[1] = vec.elem[1]; elem[2] = vec.elem[2];
-       }
-
         // Construct from a Vector2d - third element is set to 0
      Vector3d(const Vector2d& vec)
-       : BaseObject()
        {
          copyFrom(vec);
        }
      
         // Construct from a Vector4d - copies first 3 elements
      Vector3d(const Vector4d& vec)
-       : BaseObject()
        {
          copyFrom(vec);
        }
      
-        // Destructor - does nothing
-     virtual ~Vector3d()
-       {}
-
-        // Assignment operator
-     Vector3d& operator = (const Vector3d& vec)
-       {
-         elem[0] = vec.elem[0]; elem[1] = vec.elem[1]; elem[2] = vec.elem[2];
-         return (*this);
-       }
+        // Copy constructor, assignment operator and destructor are the
+        // compiler generated ones, which copy the elements
 
         // Assignment from a scalar - all elements are set to the scalar value
      Vector3d& operator = (double scalar)
@@ -142,8 +122,7 @@ class Vector3d : public BaseObject
        }
 
         // Make a copy of the object
-        // implement BaseObject class pure virtual function
-     virtual BaseObjectPtr copy(void) const
+     Vector3dPtr copy(void) const
        {
          Vector3dPtr vec = new Vector3d(*this);
          return vec;
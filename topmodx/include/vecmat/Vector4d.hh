@@ -32,7 +32,7 @@
 #define _VECTOR_4D_HH_
 
 // Class for a 4-D vector.
-// Derived from BaseObject
+// Plain value type like Vector3d - no virtual functions
 // Assumes existence of classes Vector3d and Vector4d, which are 3-D and 4-D
 // versions of this class.
 // All the Vector classes are forward declared in Vector.hh, along with any
@@ -46,7 +46,7 @@
 class Vector4d;
 typedef Vector4d * Vector4dPtr;
 
-class Vector4d : public BaseObject
+class Vector4d
 {
   protected :
 
@@ -60,14 +60,12 @@ class Vector4d : public BaseObject
 
         // Default constructor
      Vector4d()
-       : BaseObject()
        {
          elem[0] = elem[1] = elem[2] = elem[3] = 0.0;
        }
 
         // 1 argument constructor - intialize all elements with given value
      Vector4d(double val)
-       : BaseObject()
        {
          elem[0] = elem[1] = elem[2] = elem[3] = val;
        }
@@ -75,51 +73,29 @@ class Vector4d : public BaseObject
         // 1 argument constructor - initialize with given array
         // Assumes array has atleast 4 elements
      Vector4d(double * arr)
-       : BaseObject()
        {
          elem[0] = arr[0]; elem[1] = arr[1]; elem[2] = arr[2]; elem[3] = arr[3];
        }
 
         // 4 argument constructor
      Vector4d(double val1, double val2, double val3, double val4)
-       : BaseObject()
        {
          elem[0] = val1; elem[1] = val2; elem[2] = val3; elem[3] = val4;
        }
      
-        // Copy constructor
-     Vector4d(const Vector4d& vec)
-       : BaseObject(vec)
-       {
-         elem[0] = vec.elem[0]; elem[1] = vec.elem[1];
-         elem[2] = vec.elem[2]; elem[3] = vec.elem[3];
-       }
-
         // Construct from a Vector2d - third and fourth elements are set to 0
      Vector4d(const Vector2d& vec)
-       : BaseObject()
        {
          copyFrom(vec);
        }
      
         // Construct from a Vector3d - fourth element is set to 0
      Vector4d(const Vector3d& vec)
-       : BaseObject()
        {
          copyFrom(vec);
        }
      
-        // Destructor - does nothing
-     virtual ~Vector4d()
-       {}
-
-        // Assignment operator
-     Vector4d& operator = (const Vector4d& vec)
-       {
-         elem[0] = vec.elem[0]; elem[1] = vec.elem[1];
-         elem[2] = vec.elem[2]; elem[3] = vec.elem[3];
-         return (*this);
-       }
+        // Copy constructor, assignment and destructor are compiler generated
 
         // Assignment from a scalar - all elements are set to the scalar value
      Vector4d& operator = (double scalar)
@@ -143,8 +119,7 @@ class Vector4d : public BaseObject
        }
 
         // Make a copy of the object
-        // implement BaseObject class pure virtual function
-     virtual BaseObjectPtr copy(void) const
+     Vector4dPtr copy(void) const
        {
          Vector4dPtr vec = new Vector4d(*this);
          return vec;
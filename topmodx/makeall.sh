@@ -12,6 +12,9 @@ python dlfl_setup.py install
 # go back up 2 directory levels
 cd ../../
 
+# command line tool
+(cd batch && qmake && make)
+
 # i18n stuff
 lupdate topmod.pro
 lrelease topmod.pro
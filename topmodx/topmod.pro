@@ -124,7 +124,8 @@ macx {
 	}
 } else:unix {
 	CONFIG -= WITH_SPACENAV WITH_VERSE
-	QMAKE_LFLAGS += -L./lib
+	QMAKE_CXXFLAGS += -fopenmp
+	QMAKE_LFLAGS += -L./lib -fopenmp
 	LIBS += -lvecmat -ldlflcore -ldlflaux
 	DEFINES *= LINUX
 	
@@ -154,7 +155,8 @@ macx {
 	CONFIG -= WITH_SPACENAV
 
 	INCLUDEPATH += ./lib
-	QMAKE_LFLAGS += -L./lib
+	QMAKE_CXXFLAGS += -fopenmp
+	QMAKE_LFLAGS += -L./lib -fopenmp
 	# INCLUDEPATH += C:/topmod/topmodx/lib
 	# QMAKE_LFLAGS += -LC:/topmod/topmodx/lib
 	LIBS += -lvecmat -ldlflcore -ldlflaux
@@ -190,7 +192,10 @@ HEADERS += \
 	TopMod.hh \
 	MainWindow.hh \
 	GeometryRenderer.hh \
+	GeometryBuffer.hh \
+	DLFLPicker.hh \
 	DLFLLighting.hh \	
+	OperatorThread.hh \
 	qcumber.hh \
 	qshortcutdialog.hh \
 	qshortcutmanager.hh \
@@ -242,6 +247,8 @@ SOURCES += \
 	MainWindowCallbacks.cc \
 	MainWindowRemeshingCallbacks.cc \
 	GeometryRenderer.cc \
+	GeometryBuffer.cc \
+	DLFLPicker.cc \
 	qshortcutdialog.cc \
 	qshortcutmanager.cc \
 	editor.cc \